@@ -6,14 +6,25 @@ list( APPEND MAIN_SOURCE_FILES
         opm/test_util/summaryRegressionTest.cpp
         opm/test_util/summaryComparator.cpp
         opm/test_util/EclFilesComparator.cpp
+        opm/test_util/EclFileDigest.cpp
         opm/output/eclipse/EclipseGridInspector.cpp
         opm/output/eclipse/EclipseIO.cpp
         opm/output/eclipse/LinearisedOutputTable.cpp
         opm/output/eclipse/RestartIO.cpp
         opm/output/eclipse/Summary.cpp
+        opm/output/eclipse/SummaryHistory.cpp
         opm/output/eclipse/Tables.cpp
+        opm/output/eclipse/TablesCache.cpp
         opm/output/eclipse/RegionCache.cpp
+        opm/output/eclipse/RegionReduction.cpp
+        opm/output/eclipse/ScheduleSnapshot.cpp
+        opm/output/eclipse/FortranIO.cpp
+        opm/output/eclipse/CommitLog.cpp
         opm/output/data/Solution.cpp
+        opm/output/util/ThreadPool.cpp
+        opm/output/util/ByteSwap.cpp
+        opm/output/util/AsyncFile.cpp
+        opm/output/util/LossyCodec.cpp
     )
 
 list (APPEND PUBLIC_HEADER_FILES
@@ -30,23 +41,39 @@ list (APPEND PUBLIC_HEADER_FILES
         opm/output/eclipse/RestartIO.hpp
         opm/output/eclipse/RestartValue.hpp
         opm/output/eclipse/Summary.hpp
+        opm/output/eclipse/SummaryHistory.hpp
         opm/output/eclipse/Tables.hpp
+        opm/output/eclipse/TablesCache.hpp
         opm/output/eclipse/RegionCache.hpp
+        opm/output/eclipse/RegionReduction.hpp
+        opm/output/eclipse/ScheduleSnapshot.hpp
+        opm/output/eclipse/FortranIO.hpp
+        opm/output/eclipse/CommitLog.hpp
         opm/output/data/Solution.hpp
+        opm/output/util/ThreadPool.hpp
+        opm/output/util/ByteSwap.hpp
+        opm/output/util/AsyncFile.hpp
+        opm/output/util/LossyCodec.hpp
         opm/test_util/EclFilesComparator.hpp
+        opm/test_util/EclFileDigest.hpp
         opm/test_util/summaryRegressionTest.hpp
+        opm/test_util/summaryRegressionRun.hpp
         opm/test_util/summaryComparator.hpp
     )
 
 list (APPEND EXAMPLE_SOURCE_FILES
         test_util/compareECL.cpp
+        test_util/compareECLBatch.cpp
         test_util/compareSummary.cpp
+        examples/benchmark_ByteSwap.cpp
+        examples/benchmark_calcSlopes.cpp
     )
 
 # programs listed here will not only be compiled, but also marked for
 # installation
 list (APPEND PROGRAM_SOURCE_FILES
         test_util/compareECL.cpp
+        test_util/compareECLBatch.cpp
         test_util/compareSummary.cpp
     )
 
@@ -63,6 +90,14 @@ list (APPEND TEST_SOURCE_FILES
         tests/test_writenumwells.cpp
         tests/test_Solution.cpp
         tests/test_regionCache.cpp
+        tests/test_ScheduleSnapshot.cpp
+        tests/test_FortranIO.cpp
+        tests/test_CommitLog.cpp
+        tests/test_ThreadPool.cpp
+        tests/test_ByteSwap.cpp
+        tests/test_AsyncFile.cpp
+        tests/test_LossyCodec.cpp
+        tests/test_SummaryHistory.cpp
     )
 
 # originally generated with the command:
@@ -0,0 +1,67 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Reports the throughput of every byte swap kernel the CPU supports on
+  a field of 10^7 doubles.  The kernels are tested in
+  tests/test_ByteSwap.cpp.
+
+  Usage: benchmark_ByteSwap [repetitions]
+*/
+
+#include <opm/output/util/ByteSwap.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    const int numRepeat = (argc > 1) ? std::atoi(argv[1]) : 4;
+    if (numRepeat <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::size_t count = 10 * 1000 * 1000;
+    std::vector<double> field(count, 1.5);
+    std::vector<double> swapped(count);
+
+    std::cout << "byteSwap() uses the " << Opm::out::byteSwapKernel() << " kernel" << std::endl;
+
+    for (const char* kernel : { "scalar", "ssse3", "avx2" }) {
+        const auto start = std::chrono::steady_clock::now();
+        bool supported = true;
+        for (int rep = 0; rep < numRepeat && supported; ++rep)
+            supported = Opm::out::byteSwapWith(kernel, field.data(), swapped.data(), count, sizeof(double));
+
+        if (!supported) {
+            std::cout << kernel << ": not supported" << std::endl;
+            continue;
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double bytes = double(numRepeat) * count * sizeof(double);
+        std::cout << kernel << ": " << bytes / elapsed.count() / 1.0e9 << " GB/s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Times calcSlopes() on saturation function tables of the largest size
+  seen in practice: NTSFUN = 100 regions with NSSFUN = 1000 nodes of
+  SWOF-like tables (three dependent columns).  The correctness of the
+  same computation is checked in tests/test_LinearisedOutputTable.cpp.
+
+  Usage: benchmark_calcSlopes [repetitions]
+*/
+
+#include <opm/output/eclipse/LinearisedOutputTable.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+    const std::size_t numTables = 100;
+    const std::size_t numRows   = 1000;
+    const std::size_t numDep    = 3;
+
+    ::Opm::LinearisedOutputTable makeTable()
+    {
+        auto linTable = ::Opm::LinearisedOutputTable {
+            numTables, 1, numRows, 1 + 2*numDep
+        };
+
+        for (auto t = 0*numTables; t < numTables; ++t) {
+            auto x = linTable.column(t, 0, 0);
+            for (auto i = 0*numRows; i < numRows; ++i) {
+                // Every tenth interval is degenerate (dx == 0).
+                x[i] = static_cast<double>(i - i/10) / numRows;
+            }
+
+            for (auto j = 0*numDep; j < numDep; ++j) {
+                auto y = linTable.column(t, 0, j + 1);
+                for (auto i = 0*numRows; i < numRows; ++i) {
+                    y[i] = std::sin((j + 1) * x[i] + t);
+                }
+            }
+        }
+
+        return linTable;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const auto numRepeat = (argc > 1) ? std::atoi(argv[1]) : 20;
+    if (numRepeat <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto linTable = makeTable();
+
+    auto descr = ::Opm::DifferentiateOutputTable::Descriptor{};
+    descr.primID     = 0;
+    descr.numActRows = numRows;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto rep = 0; rep < numRepeat; ++rep) {
+        for (descr.tableID = 0; descr.tableID < numTables; ++descr.tableID) {
+            ::Opm::DifferentiateOutputTable::calcSlopes(numDep, descr, linTable);
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<double>
+        (std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "calcSlopes(): " << numTables << " tables x "
+              << numRows << " rows x " << numDep
+              << " columns in " << (elapsed / numRepeat) * 1.0e3
+              << " ms per pass" << std::endl;
+
+    return 0;
+}
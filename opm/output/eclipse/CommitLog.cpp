@@ -0,0 +1,204 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opm/output/eclipse/CommitLog.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Opm {
+namespace out {
+
+namespace {
+    const char* const marker_header = "OPM_COMMIT 1";
+
+    std::runtime_error commitError( const std::string& what ) {
+        return std::runtime_error( "CommitLog: " + what + ": " + std::strerror( errno ) );
+    }
+
+    std::string directoryOf( const std::string& path ) {
+        const auto slash = path.rfind( '/' );
+        if (slash == std::string::npos)
+            return ".";
+        return slash == 0 ? "/" : path.substr( 0, slash );
+    }
+
+    void syncFile( const std::string& filename, int flags ) {
+        const int fd = ::open( filename.c_str(), flags );
+        if (fd < 0)
+            throw commitError( "could not open " + filename );
+
+        const int status = ::fsync( fd );
+        ::close( fd );
+        if (status < 0)
+            throw commitError( "could not sync " + filename );
+    }
+}
+
+
+CommitLog::CommitLog( const std::string& marker_file_arg,
+                      const std::string& case_name_arg,
+                      std::time_t start_time_arg ) :
+    marker_file( marker_file_arg ),
+    case_name( case_name_arg ),
+    start_time( start_time_arg )
+{}
+
+
+void CommitLog::commit( int report_step, const std::vector< std::string >& files ) {
+    std::ostringstream marker;
+    marker << marker_header << '\n'
+           << "CASE " << this->case_name << '\n'
+           << "START " << std::int64_t( this->start_time ) << '\n'
+           << "STEP " << report_step << '\n';
+
+    for (const auto& file : files) {
+        struct stat st;
+        if (::stat( file.c_str(), &st ) != 0)
+            continue;
+
+        syncFile( file, O_RDONLY );
+        marker << "FILE " << std::uint64_t( st.st_size ) << ' ' << file << '\n';
+    }
+    marker << "END\n";
+
+    const auto tmp_file = this->marker_file + ".tmp";
+    {
+        const int fd = ::open( tmp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        if (fd < 0)
+            throw commitError( "could not open " + tmp_file );
+
+        const auto text = marker.str();
+        std::size_t done = 0;
+        while (done < text.size()) {
+            const auto n = ::write( fd, text.data() + done, text.size() - done );
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0) {
+                ::close( fd );
+                throw commitError( "could not write " + tmp_file );
+            }
+            done += n;
+        }
+
+        const int status = ::fsync( fd );
+        ::close( fd );
+        if (status < 0)
+            throw commitError( "could not sync " + tmp_file );
+    }
+
+    if (::rename( tmp_file.c_str(), this->marker_file.c_str() ) != 0)
+        throw commitError( "could not rename " + tmp_file );
+
+    syncFile( directoryOf( this->marker_file ), O_RDONLY | O_DIRECTORY );
+}
+
+
+/*
+  A marker without the END line was never renamed into place by
+  commit(), and a marker of another case or start time was left by an
+  unrelated run; both are treated as absent.
+*/
+bool CommitLog::read( int& report_step, std::vector< std::pair< std::string, std::uint64_t > >& sizes ) const {
+    std::ifstream stream( this->marker_file );
+    std::string line;
+    if (!std::getline( stream, line ) || line != marker_header)
+        return false;
+
+    report_step = -1;
+    sizes.clear();
+    bool same_case = false;
+    bool same_start = false;
+    while (std::getline( stream, line )) {
+        std::istringstream fields( line );
+        std::string tag;
+        fields >> tag;
+
+        if (tag == "END")
+            return same_case && same_start && report_step >= 0;
+
+        if (tag == "CASE") {
+            fields.get();
+
+            std::string name;
+            std::getline( fields, name );
+            same_case = name == this->case_name;
+        } else if (tag == "START") {
+            std::int64_t start = 0;
+            same_start = (fields >> start) && start == std::int64_t( this->start_time );
+        } else if (tag == "STEP") {
+            fields >> report_step;
+        } else if (tag == "FILE") {
+            std::uint64_t size;
+            fields >> size;
+            fields.get();
+
+            std::string file;
+            std::getline( fields, file );
+            sizes.emplace_back( file, size );
+        }
+    }
+
+    return false;
+}
+
+
+int CommitLog::lastCommitted() const {
+    int report_step;
+    std::vector< std::pair< std::string, std::uint64_t > > sizes;
+    return this->read( report_step, sizes ) ? report_step : -1;
+}
+
+
+std::vector< std::pair< std::string, std::uint64_t > > CommitLog::committedSizes() const {
+    int report_step;
+    std::vector< std::pair< std::string, std::uint64_t > > sizes;
+    if (!this->read( report_step, sizes ))
+        sizes.clear();
+    return sizes;
+}
+
+
+int CommitLog::recover() const {
+    int report_step;
+    std::vector< std::pair< std::string, std::uint64_t > > sizes;
+    if (!this->read( report_step, sizes ))
+        return -1;
+
+    for (const auto& file : sizes) {
+        struct stat st;
+        if (::stat( file.first.c_str(), &st ) != 0 || std::uint64_t( st.st_size ) <= file.second)
+            continue;
+
+        if (::truncate( file.first.c_str(), off_t( file.second ) ) != 0)
+            throw commitError( "could not truncate " + file.first );
+    }
+
+    return report_step;
+}
+
+}
+}
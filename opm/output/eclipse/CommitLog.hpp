@@ -0,0 +1,87 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_COMMIT_LOG_HPP
+#define OPM_COMMIT_LOG_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+namespace out {
+
+    /*
+      Commit marker for the output files of a run.
+
+      The files of a report step - the unified restart and summary
+      files - are appended to in place. When a report step is complete,
+      commit() syncs the files and then atomically replaces the marker
+      file with the report step and the size of every file. A crash
+      while a step is written leaves the files longer than the marker
+      says; recover() truncates them back to the sizes of the last
+      committed step, without reading the files.
+
+      The marker is a small text file, written to a temporary file and
+      renamed into place, so it is itself never torn. It names the case
+      and the start time of the run; a marker left by a different run
+      is ignored, and its files are not truncated.
+    */
+    class CommitLog {
+    public:
+        CommitLog( const std::string& marker_file,
+                   const std::string& case_name,
+                   std::time_t start_time );
+
+        /*
+          Sync the files, then record report_step and their sizes as the
+          last complete step. Files which do not exist are left out.
+          Throws std::runtime_error if the marker can not be written.
+        */
+        void commit( int report_step, const std::vector< std::string >& files );
+
+        /*
+          Truncate the files of the marker to their committed sizes;
+          files shorter than the committed size are left alone.
+          Returns the last committed report step, or -1 if there is no
+          marker of this case and start time.
+        */
+        int recover() const;
+
+        /*
+          The committed report step and file sizes of the marker; the
+          step is -1 if there is none.
+        */
+        int lastCommitted() const;
+        std::vector< std::pair< std::string, std::uint64_t > > committedSizes() const;
+
+    private:
+        bool read( int& report_step, std::vector< std::pair< std::string, std::uint64_t > >& sizes ) const;
+
+        std::string marker_file;
+        std::string case_name;
+        std::time_t start_time;
+    };
+
+}
+}
+
+#endif
@@ -40,7 +40,12 @@
 #include <opm/parser/eclipse/Utility/Functional.hpp>
 #include <opm/output/eclipse/Summary.hpp>
 #include <opm/output/eclipse/Tables.hpp>
+#include <opm/output/eclipse/TablesCache.hpp>
 #include <opm/output/eclipse/RestartIO.hpp>
+#include <opm/output/eclipse/ScheduleSnapshot.hpp>
+#include <opm/output/eclipse/FortranIO.hpp>
+#include <opm/output/eclipse/CommitLog.hpp>
+#include <opm/output/util/ThreadPool.hpp>
 
 #include <cstdlib>
 #include <memory>     // unique_ptr
@@ -72,9 +77,11 @@ namespace {
 
 void writeKeyword( ERT::FortIO& fortio ,
                    const std::string& keywordName,
-                   const std::vector<int> &data ) {
-    ERT::EclKW< int > kw( keywordName, data );
-    kw.fwrite( fortio );
+                   const std::vector<int> &data,
+                   out::ThreadPool& pool ) {
+    out::FortranWriter writer( fortio.get() );
+    writer.setThreadPool( pool );
+    writer.write( keywordName, data );
 }
 
 /*
@@ -85,11 +92,12 @@ void writeKeyword( ERT::FortIO& fortio ,
 
 void writeKeyword( ERT::FortIO& fortio ,
                    const std::string& keywordName,
-                   const std::vector<double> &data) {
-
-    ERT::EclKW< float > kw( keywordName, data );
-    kw.fwrite( fortio );
+                   const std::vector<double> &data,
+                   out::ThreadPool& pool ) {
 
+    out::FortranWriter writer( fortio.get() );
+    writer.setThreadPool( pool );
+    writer.writeAsFloat( keywordName, data.data(), data.size() );
 }
 
 
@@ -123,6 +131,13 @@ class RFT {
 {}
 
 
+/*
+  The RFT nodes are written by ecl_rft_node_fwrite(), which owns the
+  layout of the node keywords and the unit strings of WELLETC, and not
+  through FortranWriter and AsyncFile. An RFT step is a few small
+  keywords per well with RFT output, written once per report step, so
+  there is little system call overhead to batch.
+*/
 void RFT::writeTimeStep( std::vector< const Well* > wells,
                          const EclipseGrid& grid,
                          int report_step,
@@ -206,6 +221,9 @@ class EclipseIO::Impl {
         void writeINITFile( const data::Solution& simProps, std::map<std::string, std::vector<int> > int_data, const NNC& nnc) const;
         void writeEGRIDFile( const NNC& nnc ) const;
 
+        /* The schedule snapshot of a report step, shared by all writers of the step. */
+        const out::ScheduleSnapshot& scheduleSnapshot( int report_step );
+
         const EclipseState& es;
         EclipseGrid grid;
         const Schedule& schedule;
@@ -214,8 +232,42 @@ class EclipseIO::Impl {
         out::Summary summary;
         RFT rft;
         bool output_enabled;
+        std::unique_ptr< TablesCache > tables_cache;
+        out::ThreadPool* pool = &out::ThreadPool::serial();
+        std::unique_ptr< out::ScheduleSnapshot > snapshot;
+        RestartIO::WellBuffers restart_buffers;
+        std::unique_ptr< RestartIO::DeltaEncoder > restart_delta;
+        RestartIO::AuxiliaryCompression aux_compression;
+        bool drop_page_cache = false;
+        std::unique_ptr< out::CommitLog > commit_log;
+
+        /* The files covered by the commit marker: the ones appended to over the run. */
+        std::vector< std::string > committedFiles( int report_step ) const;
 };
 
+std::vector< std::string > EclipseIO::Impl::committedFiles( int report_step ) const {
+    const auto& ioConfig = this->es.getIOConfig();
+    const bool fmt = ioConfig.getFMTOUT();
+
+    std::vector< std::string > files;
+    if (ioConfig.getUNIFOUT()) {
+        files.push_back( ERT::EclFilename( this->outputDir, this->baseName, ECL_UNIFIED_RESTART_FILE, fmt ) );
+        files.push_back( ERT::EclFilename( this->outputDir, this->baseName, ECL_UNIFIED_SUMMARY_FILE, fmt ) );
+    } else {
+        files.push_back( ERT::EclFilename( this->outputDir, this->baseName, ECL_SUMMARY_FILE, report_step, fmt ) );
+    }
+    files.push_back( ERT::EclFilename( this->outputDir, this->baseName, ECL_RFT_FILE, fmt ) );
+
+    return files;
+}
+
+const out::ScheduleSnapshot& EclipseIO::Impl::scheduleSnapshot( int report_step ) {
+    if (!this->snapshot || this->snapshot->reportStep() != size_t( report_step ))
+        this->snapshot.reset( new out::ScheduleSnapshot( this->schedule, this->grid, report_step ) );
+
+    return *this->snapshot;
+}
+
 EclipseIO::Impl::Impl( const EclipseState& eclipseState,
                        EclipseGrid grid_,
                        const Schedule& schedule_,
@@ -270,7 +322,7 @@ void EclipseIO::Impl::writeINITFile( const data::Solution& simProps, std::map<st
                                      this->schedule.posixStartTime( ));
 
         units.from_si( UnitSystem::measure::volume, ecl_data );
-        writeKeyword( fortio, "PORV" , ecl_data );
+        writeKeyword( fortio, "PORV" , ecl_data , *this->pool );
     }
 
     // Writing quantities which are calculated by the grid to the INIT file.
@@ -303,7 +355,7 @@ void EclipseIO::Impl::writeINITFile( const data::Solution& simProps, std::map<st
                 auto ecl_data = opm_property.compressedCopy( this->grid );
 
                 units.from_si( kw_pair.second, ecl_data );
-                writeKeyword( fortio, kw_pair.first, ecl_data );
+                writeKeyword( fortio, kw_pair.first, ecl_data , *this->pool );
             }
         }
     }
@@ -313,19 +365,38 @@ void EclipseIO::Impl::writeINITFile( const data::Solution& simProps, std::map<st
     {
         for (const auto& prop : simProps) {
             auto ecl_data = this->grid.compressedVector( prop.second.data );
-            writeKeyword( fortio, prop.first, ecl_data );
+            writeKeyword( fortio, prop.first, ecl_data , *this->pool );
         }
     }
 
     // Write tables
     {
-        Tables tables( this->es.getUnits() );
-        tables.addPVTO( this->es.getTableManager().getPvtoTables() );
-        tables.addPVTG( this->es.getTableManager().getPvtgTables() );
-        tables.addPVTW( this->es.getTableManager().getPvtwTable() );
-        tables.addDensity( this->es.getTableManager().getDensityTable( ) );
-        tables.addSatFunc(this->es);
-        fwrite(tables, fortio);
+        bool cached = false;
+        std::string tables_key;
+        if (this->tables_cache) {
+            std::vector<int> tabdims;
+            std::vector<double> tab;
+
+            tables_key = TablesCache::key( this->es );
+            if (this->tables_cache->load( tables_key, tabdims, tab )) {
+                fwrite( Tables( units, std::move( tabdims ), std::move( tab ) ), fortio );
+                cached = true;
+            }
+        }
+
+        if (!cached) {
+            Tables tables( this->es.getUnits() );
+            tables.setThreadPool( *this->pool );
+            tables.addPVTO( this->es.getTableManager().getPvtoTables() );
+            tables.addPVTG( this->es.getTableManager().getPvtgTables() );
+            tables.addPVTW( this->es.getTableManager().getPvtwTable() );
+            tables.addDensity( this->es.getTableManager().getDensityTable( ) );
+            tables.addSatFunc(this->es);
+            fwrite(tables, fortio);
+
+            if (this->tables_cache)
+                this->tables_cache->store( tables_key, tables.tabdims(), tables.tab() );
+        }
     }
 
     // Write all integer field properties from the input deck.
@@ -343,7 +414,7 @@ void EclipseIO::Impl::writeINITFile( const data::Solution& simProps, std::map<st
 
         for (const auto& property : properties) {
             auto ecl_data = property.compressedCopy( this->grid );
-            writeKeyword( fortio , property.getKeywordName() , ecl_data );
+            writeKeyword( fortio , property.getKeywordName() , ecl_data , *this->pool );
         }
     }
 
@@ -356,7 +427,7 @@ void EclipseIO::Impl::writeINITFile( const data::Solution& simProps, std::map<st
             if (key.size() > ECL_STRING8_LENGTH)
               throw std::invalid_argument("Keyword is too long.");            
 
-            writeKeyword( fortio , key , int_vector );
+            writeKeyword( fortio , key , int_vector , *this->pool );
         }
     }
 
@@ -368,7 +439,7 @@ void EclipseIO::Impl::writeINITFile( const data::Solution& simProps, std::map<st
             tran.push_back( nd.trans );
 
         units.from_si( UnitSystem::measure::transmissibility , tran );
-        writeKeyword( fortio, "TRANNNC" , tran );
+        writeKeyword( fortio, "TRANNNC" , tran , *this->pool );
     }
 }
 
@@ -405,13 +476,68 @@ void EclipseIO::writeInitial( data::Solution simProps, std::map<std::string, std
         const IOConfig& ioConfig = es.cfg().io();
 
         simProps.convertFromSI( es.getUnits() );
-        if( ioConfig.getWriteINITFile() )
+        if( ioConfig.getWriteINITFile() ) {
             this->impl->writeINITFile( simProps , int_data, nnc );
+            if (this->impl->drop_page_cache)
+                out::dropFromPageCache( ERT::EclFilename( this->impl->outputDir, this->impl->baseName,
+                                                          ECL_INIT_FILE, ioConfig.getFMTOUT() ) );
+        }
 
-        if( ioConfig.getWriteEGRIDFile( ) )
+        if( ioConfig.getWriteEGRIDFile( ) ) {
             this->impl->writeEGRIDFile( nnc );
+            if (this->impl->drop_page_cache)
+                out::dropFromPageCache( ERT::EclFilename( this->impl->outputDir, this->impl->baseName,
+                                                          ECL_EGRID_FILE, ioConfig.getFMTOUT() ) );
+        }
+    }
+
+}
+
+void EclipseIO::setTablesCache( const std::string& directory ) {
+    if (directory.empty())
+        this->impl->tables_cache.reset();
+    else
+        this->impl->tables_cache.reset( new TablesCache( directory ) );
+}
+
+void EclipseIO::setThreadPool( out::ThreadPool& pool ) {
+    this->impl->pool = &pool;
+    this->impl->summary.set_thread_pool( pool );
+}
+
+void EclipseIO::setCrashConsistentOutput( bool enable ) {
+    if (!enable) {
+        this->impl->commit_log.reset();
+        return;
     }
 
+    const auto marker = this->impl->outputDir + "/" + this->impl->baseName + ".OPM_COMMIT";
+    this->impl->commit_log.reset( new out::CommitLog( marker, this->impl->baseName,
+                                                      this->impl->schedule.posixStartTime() ) );
+    if (this->impl->output_enabled && this->impl->commit_log->recover() >= 0)
+        this->impl->summary.resume();
+}
+
+void EclipseIO::setAuxiliaryCompression( const RestartIO::AuxiliaryCompression& options ) {
+    this->impl->aux_compression = options;
+}
+
+void EclipseIO::setDeltaRestart( int keyframe_interval ) {
+    if (keyframe_interval <= 0) {
+        this->impl->restart_delta.reset();
+        return;
+    }
+
+    this->impl->restart_delta.reset( new RestartIO::DeltaEncoder() );
+    this->impl->restart_delta->keyframe_interval = keyframe_interval;
+}
+
+void EclipseIO::setDropPageCache( bool enable ) {
+    this->impl->drop_page_cache = enable;
+}
+
+void EclipseIO::setSummaryCadence( const out::SummaryCadence& cadence ) {
+    this->impl->summary.set_substep_cadence( cadence );
 }
 
 // implementation of the writeTimeStep method
@@ -437,22 +563,28 @@ void EclipseIO::writeTimeStep(int report_step,
     const auto& units = es.getUnits();
     const auto& ioConfig = es.getIOConfig();
     const auto& restart = es.cfg().restart();
+    const auto& snapshot = this->impl->scheduleSnapshot( report_step );
 
 
 
     /*
-      Summary data is written unconditionally for every timestep.
+      Summary data is written for every report step, and for substeps
+      as given by the summary cadence.
     */
     {
-        this->impl->summary.add_timestep( report_step,
-                                          secs_elapsed,
-                                          es,
-                                          schedule,
-                                          wells ,
-                                          single_summary_values ,
-                                          region_summary_values,
-                                          block_summary_values);
-        this->impl->summary.write();
+        const bool recorded = this->impl->summary.add_timestep( report_step,
+                                                                secs_elapsed,
+                                                                es,
+                                                                schedule,
+                                                                wells ,
+                                                                single_summary_values ,
+                                                                region_summary_values,
+                                                                block_summary_values,
+                                                                cells,
+                                                                isSubstep,
+                                                                &snapshot);
+        if (recorded)
+            this->impl->summary.write();
     }
 
 
@@ -469,7 +601,21 @@ void EclipseIO::writeTimeStep(int report_step,
                                                  report_step,
                                                  ioConfig.getFMTOUT() );
 
-        RestartIO::save( filename , report_step, secs_elapsed, cells, wells, es , grid , schedule, extra_restart , write_double);
+        /* The summary totals are checkpointed so that a restarted run continues them exactly. */
+        auto restart_data = extra_restart;
+        for (auto& vector : this->impl->summary.totals_checkpoint())
+            restart_data.emplace( vector.first, std::move( vector.second ) );
+
+        RestartIO::SaveOptions options;
+        options.snapshot = &snapshot;
+        options.buffers = &this->impl->restart_buffers;
+        options.delta = this->impl->restart_delta.get();
+        options.compression = &this->impl->aux_compression;
+        options.rename_into_place = bool( this->impl->commit_log );
+
+        RestartIO::save( filename , report_step, secs_elapsed, cells, wells, es , grid , schedule, restart_data , write_double, options );
+        if (this->impl->drop_page_cache)
+            out::dropFromPageCache( filename );
     }
 
 
@@ -480,10 +626,8 @@ void EclipseIO::writeTimeStep(int report_step,
         return;
 
     {
-        std::vector<const Well*> sched_wells = this->impl->schedule.getWells( report_step );
-        const auto rft_active = [report_step] (const Well* w) { return w->getRFTActive( report_step ) || w->getPLTActive( report_step ); };
-        if (std::any_of(sched_wells.begin(), sched_wells.end(), rft_active)) {
-            this->impl->rft.writeTimeStep( sched_wells,
+        if (snapshot.anyRFTActive()) {
+            this->impl->rft.writeTimeStep( snapshot.wells(),
                                            grid,
                                            report_step,
                                            secs_elapsed + this->impl->schedule.posixStartTime(),
@@ -493,6 +637,8 @@ void EclipseIO::writeTimeStep(int report_step,
         }
     }
 
+    if (this->impl->commit_log)
+        this->impl->commit_log->commit( report_step, this->impl->committedFiles( report_step ) );
  }
 
 
@@ -508,7 +654,21 @@ RestartValue EclipseIO::loadRestart(const std::map<std::string, RestartKey>& key
                                                                         report_step,
                                                                         false );
 
-    return RestartIO::load( filename , report_step , keys , es, grid , schedule, extra_keys);
+    auto restart_keys = extra_keys;
+    const auto totals_requested = std::make_pair( restart_keys.count( out::Summary::totals_key ) > 0,
+                                                  restart_keys.count( out::Summary::totals_names_key ) > 0 );
+    restart_keys.emplace( out::Summary::totals_key, false );
+    restart_keys.emplace( out::Summary::totals_names_key, false );
+
+    auto value = RestartIO::load( filename , report_step , keys , es, grid , schedule, restart_keys);
+    this->impl->summary.restore_totals( value.extra );
+
+    if (!totals_requested.first)
+        value.extra.erase( out::Summary::totals_key );
+    if (!totals_requested.second)
+        value.extra.erase( out::Summary::totals_names_key );
+
+    return value;
 }
 
 EclipseIO::EclipseIO( const EclipseState& es,
@@ -42,6 +42,15 @@ class EclipseState;
 class SummaryConfig;
 class Schedule;
 
+namespace out {
+    struct SummaryCadence;
+    class ThreadPool;
+}
+
+namespace RestartIO {
+    struct AuxiliaryCompression;
+}
+
 /*!
  * \brief A class to write the reservoir state and the well state of a
  *        blackoil simulation to disk using the Eclipse binary format.
@@ -109,6 +118,92 @@ public:
 
     void writeInitial( data::Solution simProps = data::Solution(), std::map<std::string, std::vector<int> > int_data = {}, const NNC& nnc = NNC());
 
+    /**
+     * \brief Reuse PVT and saturation function tables across runs.
+     *
+     * Enables an on-disk cache of the TABDIMS and TAB vectors written
+     * to the INIT file, keyed on the contents of the input tables and
+     * the unit system. Runs sharing the same tables, e.g. the
+     * realisations of an ensemble, then only build the tables once.
+     * The directory must exist and may be shared between concurrently
+     * running processes. An empty string disables the cache, which is
+     * the default. Must be called before writeInitial() to take effect.
+     */
+    void setTablesCache( const std::string& directory );
+
+    /**
+     * \brief Run the data-parallel parts of the output on a pool.
+     *
+     * By default all output is produced serially on the calling thread,
+     * so the writer does not start threads behind the back of a
+     * simulator managing its own. The pool must outlive this object.
+     */
+    void setThreadPool( out::ThreadPool& pool );
+
+    /**
+     * \brief Set how often substeps are written to the summary file.
+     *
+     * By default every call to writeTimeStep() adds a summary record.
+     * With many short substeps this produces large summary files; the
+     * cadence can limit substep records to every Nth substep, to a
+     * minimum simulated time between records, or to a subset of the
+     * vectors. Report steps are always written in full, and cumulative
+     * totals stay exact.
+     */
+    void setSummaryCadence( const out::SummaryCadence& cadence );
+
+    /**
+     * \brief Keep the INIT, EGRID and restart files out of the page cache.
+     *
+     * Large restart files written through the page cache evict the
+     * simulator's working set, and their writeback can stall later
+     * writes. When enabled, every INIT, EGRID and restart file is
+     * synced and dropped from the page cache right after it has been
+     * written. Disabled by default.
+     */
+    void setDropPageCache( bool enable );
+
+    /**
+     * \brief Keep the output files consistent across crashes.
+     *
+     * When enabled, every completed report step is committed: the
+     * unified restart and summary files and the RFT file are synced,
+     * and their sizes are recorded in a marker file, <BASE>.OPM_COMMIT,
+     * next to them, together with the case name and start time.
+     * Enabling it truncates files left by a crashed run of the same
+     * case and start time back to the last committed step, which only
+     * needs the marker; a marker of any other run is ignored. The
+     * unified summary file is then continued, not rewritten, so the
+     * run should be restarted from that step. Non-unified restart
+     * files are written under a temporary name, synced and renamed
+     * into place. Disabled by default; the commits cost one sync of
+     * each file per report step.
+     */
+    void setCrashConsistentOutput( bool enable );
+
+    /**
+     * \brief Write restart solution fields as deltas between keyframes.
+     *
+     * Every keyframe_interval'th restart step written stores the
+     * solution fields in full; the steps in between store the fields
+     * which changed in few cells as the changed cells only, see
+     * RestartIO::DeltaEncoder. Loading a delta encoded step needs its
+     * keyframe step. A keyframe_interval of zero, the default,
+     * disables the encoding.
+     */
+    void setDeltaRestart( int keyframe_interval );
+
+    /**
+     * \brief Encode the auxiliary restart fields lossily.
+     *
+     * The RESTART_AUXILIARY fields of the restart files are quantised
+     * within the error bounds of the options and entropy coded, see
+     * RestartIO::AuxiliaryCompression; the RESTART_SOLUTION fields
+     * stay lossless. Absolute bounds are in the output units of the
+     * fields, not SI. By default all fields are written in full.
+     */
+    void setAuxiliaryCompression( const RestartIO::AuxiliaryCompression& options );
+
     /**
      * \brief Overwrite the initial OIP values.
      *
@@ -219,6 +314,10 @@ public:
       required, and the output layer will throw an exception if it is
       missing, if the bool is false missing keywords will be ignored
       (there will *not* be an empty vector in the return value).
+
+      The running totals of the cumulative summary vectors are also
+      stored in the restart file, and are restored by loadRestart() so
+      that the summary totals of the restarted run continue exactly.
     */
     RestartValue loadRestart(const std::map<std::string, RestartKey>& keys, const std::map<std::string, bool>& extra_keys = {}) const;
 
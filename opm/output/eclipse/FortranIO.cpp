@@ -0,0 +1,799 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opm/output/eclipse/FortranIO.hpp>
+#include <opm/output/util/ByteSwap.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace Opm {
+namespace out {
+
+namespace {
+    const std::size_t numeric_block = 1000;
+    const std::size_t char_block = 105;
+    const std::size_t char_length = 8;
+
+#ifndef IOV_MAX
+    const int iov_max = 1024;
+#else
+    const int iov_max = IOV_MAX;
+#endif
+
+    /* Formatted blocks encoded per parallel task. */
+    const std::size_t blocks_per_task = 16;
+
+    std::runtime_error ioError( const std::string& what ) {
+        return std::runtime_error( "Fortran I/O: " + what + ": " + std::strerror( errno ) );
+    }
+
+    bool littleEndian() {
+        const std::uint32_t one = 1;
+        char first;
+        std::memcpy( &first, &one, 1 );
+        return first == 1;
+    }
+
+    std::int32_t toBigEndian( std::int32_t value ) {
+        if (littleEndian())
+            byteSwap( &value, &value, 1, 4 );
+        return value;
+    }
+
+    const char* typeName( EclType type ) {
+        switch (type) {
+            case EclType::INTE: return "INTE";
+            case EclType::REAL: return "REAL";
+            case EclType::DOUB: return "DOUB";
+            case EclType::CHAR: return "CHAR";
+            case EclType::LOGI: return "LOGI";
+            case EclType::MESS: return "MESS";
+        }
+        throw std::invalid_argument( "Fortran I/O: unknown keyword type" );
+    }
+
+    std::size_t blockSize( EclType type ) {
+        return type == EclType::CHAR ? char_block : numeric_block;
+    }
+
+    std::size_t elementSize( EclType type ) {
+        switch (type) {
+            case EclType::INTE: return sizeof( std::int32_t );
+            case EclType::REAL: return sizeof( float );
+            case EclType::DOUB: return sizeof( double );
+            case EclType::CHAR: return char_length;
+            case EclType::LOGI: return sizeof( std::int32_t );
+            case EclType::MESS: return 0;
+        }
+        throw std::invalid_argument( "Fortran I/O: unknown keyword type" );
+    }
+
+    /* Write all of iov, also across short writes and IOV_MAX. */
+    void writeAll( int fd, std::vector< struct iovec >& iov ) {
+        std::size_t first = 0;
+        while (first < iov.size()) {
+            const int count = int( std::min< std::size_t >( iov.size() - first, iov_max ) );
+            ssize_t written = ::writev( fd, &iov[first], count );
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw ioError( "writev failed" );
+            }
+
+            while (first < iov.size() && std::size_t( written ) >= iov[first].iov_len) {
+                written -= iov[first].iov_len;
+                first++;
+            }
+
+            if (first < iov.size()) {
+                iov[first].iov_base = static_cast< char* >( iov[first].iov_base ) + written;
+                iov[first].iov_len -= written;
+            }
+        }
+    }
+
+    /*
+      Formatted numbers as written by libecl: a mantissa in [0.1, 1) and
+      a decimal exponent, printed with fmt.  Used for values the fast
+      encoder below does not handle.
+    */
+    void scientific( std::string& text, const char* fmt, double x ) {
+        double pow_x = std::ceil( std::log10( std::fabs( x ) ) );
+        double arg_x = x / std::pow( 10.0, pow_x );
+        if (x != 0.0) {
+            if (std::fabs( arg_x ) == 1.0) {
+                arg_x *= 0.10;
+                pow_x += 1;
+            }
+        } else {
+            arg_x = 0.0;
+            pow_x = 0.0;
+        }
+
+        char buffer[32];
+        const int n = std::snprintf( buffer, sizeof buffer, fmt, arg_x, int( pow_x ) );
+        text.append( buffer, n );
+    }
+
+    /* Write the decimal digits of value right aligned in [begin, end). */
+    char* digitsBackwards( char* end, std::uint64_t value, int min_digits ) {
+        int n = 0;
+        do {
+            *--end = char( '0' + value % 10 );
+            value /= 10;
+            n++;
+        } while (value > 0 || n < min_digits);
+        return end;
+    }
+
+    /*
+      The same text as scientific( text, "  %<width>.<decimals>f<exp>%+03d",
+      x ) without stdio: the mantissa is split exactly as libecl does it,
+      and rounded to decimals digits with the correctly rounded, ties to
+      even, result printf gives.  The product mantissa * 10^decimals is
+      kept exact as a sum of two doubles with fma, so the rounding
+      decision is exact as well.  The output does not depend on the
+      locale.
+    */
+    void encodeScientific( std::string& text, double x, int width, int decimals,
+                           double scale, char exp_char, const char* fmt ) {
+        if (!std::isfinite( x )) {
+            scientific( text, fmt, x );
+            return;
+        }
+
+        double pow_x = std::ceil( std::log10( std::fabs( x ) ) );
+        double arg_x = x / std::pow( 10.0, pow_x );
+        if (x != 0.0) {
+            if (std::fabs( arg_x ) == 1.0) {
+                arg_x *= 0.10;
+                pow_x += 1;
+            }
+        } else {
+            arg_x = 0.0;
+            pow_x = 0.0;
+        }
+
+        const double a = std::fabs( arg_x );
+        if (!(a < 1.0) || std::fabs( pow_x ) > 999) {
+            scientific( text, fmt, x );
+            return;
+        }
+
+        const double scaled = a * scale;
+        const double error = std::fma( a, scale, -scaled );
+        const double floor = std::floor( scaled );
+        const double above_half = (scaled - floor - 0.5) + error;
+
+        auto m = std::uint64_t( floor );
+        if (above_half > 0 || (above_half == 0 && m % 2 == 1))
+            m++;
+
+        const auto unit = std::uint64_t( scale );
+        char buffer[48];
+        char* end = buffer + sizeof buffer;
+        char* p = end;
+
+        /* Exponent, at least two digits with sign. */
+        const int e = int( pow_x );
+        p = digitsBackwards( p, std::uint64_t( e < 0 ? -e : e ), 2 );
+        *--p = e < 0 ? '-' : '+';
+        *--p = exp_char;
+
+        /* Mantissa. */
+        const auto mantissa_end = p;
+        p = digitsBackwards( p, m % unit, decimals );
+        *--p = '.';
+        p = digitsBackwards( p, m / unit, 1 );
+        if (std::signbit( arg_x ))
+            *--p = '-';
+
+        while (mantissa_end - p < width)
+            *--p = ' ';
+
+        text += "  ";
+        text.append( p, end - p );
+    }
+
+    void formatValue( std::string& text, int value ) {
+        char buffer[16];
+        char* end = buffer + sizeof buffer;
+        const auto magnitude = value < 0 ? -std::int64_t( value ) : std::int64_t( value );
+        char* p = digitsBackwards( end, std::uint64_t( magnitude ), 1 );
+        if (value < 0)
+            *--p = '-';
+        while (end - p < 11)
+            *--p = ' ';
+        *--p = ' ';
+        text.append( p, end - p );
+    }
+
+    void formatValue( std::string& text, float value ) {
+        encodeScientific( text, value, 11, 8, 1.0e8, 'E', "  %11.8fE%+03d" );
+    }
+
+    void formatValue( std::string& text, double value ) {
+        encodeScientific( text, value, 17, 14, 1.0e14, 'D', "  %17.14fD%+03d" );
+    }
+
+    void formatValue( std::string& text, const std::string& value ) {
+        text += " '";
+        text.append( value, 0, char_length );
+        if (value.size() < char_length)
+            text.append( char_length - value.size(), ' ' );
+        text += "'";
+    }
+
+    template< typename T >
+    std::size_t columns();
+
+    template<> std::size_t columns< int >()         { return 6; }
+    template<> std::size_t columns< float >()       { return 4; }
+    template<> std::size_t columns< double >()      { return 3; }
+    template<> std::size_t columns< std::string >() { return 7; }
+
+    void formatHeader( std::string& text, const std::string& name, std::size_t size, EclType type ) {
+        char buffer[64];
+        const int n = std::snprintf( buffer, sizeof buffer, " '%-8.8s' %11d '%-4s'\n",
+                                     name.c_str(), int( size ), typeName( type ) );
+        text.append( buffer, n );
+    }
+
+    /* The lines of blocks [first, last) of a keyword. */
+    template< typename T >
+    void formatBlocks( std::string& text, const T* data, std::size_t size, std::size_t block,
+                       std::size_t first, std::size_t last ) {
+        const auto cols = columns< T >();
+        const auto end = std::min( last * block, size );
+        for (std::size_t block_begin = first * block; block_begin < end; block_begin += block) {
+            const auto block_end = std::min( block_begin + block, size );
+            for (std::size_t line = block_begin; line < block_end; line += cols) {
+                const auto line_end = std::min( line + cols, block_end );
+                for (auto i = line; i < line_end; i++)
+                    formatValue( text, data[i] );
+                text += '\n';
+            }
+        }
+    }
+
+    std::int32_t readInt( const char* p ) {
+        std::int32_t value;
+        std::memcpy( &value, p, 4 );
+        return toBigEndian( value );
+    }
+}
+
+
+FortranWriter::FortranWriter( const std::string& filename, bool formatted_arg ) :
+    fd( ::open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 ) ),
+    formatted( formatted_arg ),
+    owns_fd( true )
+{
+    if (this->fd < 0)
+        throw ioError( "could not open " + filename );
+}
+
+
+FortranWriter::FortranWriter( int fd_arg, bool formatted_arg ) :
+    fd( fd_arg ),
+    formatted( formatted_arg ),
+    owns_fd( false )
+{}
+
+
+FortranWriter::FortranWriter( AsyncFile& file, bool formatted_arg ) :
+    fd( -1 ),
+    formatted( formatted_arg ),
+    owns_fd( false ),
+    async( &file )
+{}
+
+
+FortranWriter::FortranWriter( fortio_type* fortio_arg ) :
+    fd( fileno( fortio_get_FILE( fortio_arg ) ) ),
+    formatted( fortio_fmt_file( fortio_arg ) ),
+    owns_fd( false ),
+    fortio( fortio_arg )
+{}
+
+
+FortranWriter::~FortranWriter() {
+    try {
+        this->close();
+    } catch (...) {
+        if (this->owns_fd && this->fd >= 0)
+            ::close( this->fd );
+    }
+}
+
+
+void FortranWriter::close() {
+    if (this->async) {
+        auto* file = this->async;
+        this->async = nullptr;
+        file->flush();
+        return;
+    }
+
+    if (this->fd < 0)
+        return;
+
+    if (this->owns_fd)
+        ::close( this->fd );
+    this->fd = -1;
+}
+
+
+/*
+  An asynchronous file gets the gather list as one write; otherwise it
+  goes straight to writev().
+*/
+void FortranWriter::output( std::vector< struct iovec >& iov ) {
+    if (this->async) {
+        std::size_t size = 0;
+        for (const auto& part : iov)
+            size += part.iov_len;
+
+        std::vector< char > data;
+        data.reserve( size );
+        for (const auto& part : iov)
+            data.insert( data.end(), static_cast< const char* >( part.iov_base ),
+                         static_cast< const char* >( part.iov_base ) + part.iov_len );
+
+        this->async->append( std::move( data ) );
+        return;
+    }
+
+    if (this->fd < 0)
+        throw std::logic_error( "Fortran I/O: write after close()" );
+
+    writeAll( this->fd, iov );
+}
+
+
+/* Hand the file position over from the libecl stream, if any. */
+void FortranWriter::begin() {
+    if (!this->fortio)
+        return;
+
+    fortio_fflush( this->fortio );
+    const auto offset = std::ftell( fortio_get_FILE( this->fortio ) );
+    if (offset < 0 || ::lseek( this->fd, offset, SEEK_SET ) < 0)
+        throw ioError( "could not position the output file" );
+}
+
+
+/* Hand the file position back to the libecl stream. */
+void FortranWriter::end() {
+    if (!this->fortio)
+        return;
+
+    const auto offset = ::lseek( this->fd, 0, SEEK_CUR );
+    if (offset < 0 || std::fseek( fortio_get_FILE( this->fortio ), offset, SEEK_SET ) != 0)
+        throw ioError( "could not position the output file" );
+}
+
+
+/*
+  The header record and all data records of a keyword, as marker, data,
+  marker triplets in one gather list.  be_data is already big-endian.
+*/
+void FortranWriter::binary( const std::string& name, EclType type,
+                            const char* be_data, std::size_t size, std::size_t element_size ) {
+    const auto block = blockSize( type );
+    const auto num_blocks = (size + block - 1) / block;
+
+    char header[16];
+    std::memset( header, ' ', sizeof header );
+    std::memcpy( header, name.data(), std::min( name.size(), char_length ) );
+    const auto be_size = toBigEndian( std::int32_t( size ) );
+    std::memcpy( header + 8, &be_size, 4 );
+    std::memcpy( header + 12, typeName( type ), 4 );
+
+    /* markers[0] is the header length, markers[b + 1] the length of block b. */
+    this->markers.resize( num_blocks + 1 );
+    this->markers[0] = toBigEndian( 16 );
+
+    std::vector< struct iovec > iov;
+    iov.reserve( 3 * (num_blocks + 1) );
+    auto record = [&iov]( const void* data, std::size_t length, const std::int32_t* marker ) {
+        iov.push_back( { const_cast< std::int32_t* >( marker ), 4 } );
+        iov.push_back( { const_cast< void* >( data ), length } );
+        iov.push_back( { const_cast< std::int32_t* >( marker ), 4 } );
+    };
+
+    record( header, sizeof header, &this->markers[0] );
+    for (std::size_t b = 0; b < num_blocks; b++) {
+        const auto count = std::min( block, size - b * block );
+        this->markers[b + 1] = toBigEndian( std::int32_t( count * element_size ) );
+        record( be_data + b * block * element_size, count * element_size, &this->markers[b + 1] );
+    }
+
+    this->output( iov );
+}
+
+
+/*
+  The header line and the text of every group of blocks_per_task blocks
+  are encoded into separate buffers, the groups in parallel, and written
+  with one writev() call.
+*/
+template< typename T >
+void FortranWriter::formattedKeyword( const std::string& name, EclType type, const T* data, std::size_t size ) {
+    const auto block = blockSize( type );
+    const auto num_blocks = (size + block - 1) / block;
+    const auto num_tasks = (num_blocks + blocks_per_task - 1) / blocks_per_task;
+
+    this->text.clear();
+    formatHeader( this->text, name, size, type );
+
+    if (this->chunks.size() < num_tasks)
+        this->chunks.resize( num_tasks );
+
+    auto encode = [&]( std::size_t first, std::size_t last ) {
+        for (auto t = first; t < last; t++) {
+            auto& chunk = this->chunks[t];
+            chunk.clear();
+            formatBlocks( chunk, data, size, block, t * blocks_per_task, (t + 1) * blocks_per_task );
+        }
+    };
+
+    if (num_tasks > 1)
+        this->pool->parallelFor( 0, num_tasks, 1, encode );
+    else
+        encode( 0, num_tasks );
+
+    std::vector< struct iovec > iov;
+    iov.reserve( num_tasks + 1 );
+    iov.push_back( { const_cast< char* >( this->text.data() ), this->text.size() } );
+    for (std::size_t t = 0; t < num_tasks; t++)
+        iov.push_back( { const_cast< char* >( this->chunks[t].data() ), this->chunks[t].size() } );
+
+    this->output( iov );
+}
+
+
+void FortranWriter::setThreadPool( ThreadPool& pool_arg ) {
+    this->pool = &pool_arg;
+}
+
+
+template< typename T >
+void FortranWriter::keyword( const std::string& name, EclType type, const T* data, std::size_t size ) {
+    this->begin();
+
+    if (this->formatted) {
+        this->formattedKeyword( name, type, data, size );
+    } else {
+        const char* be_data = reinterpret_cast< const char* >( data );
+        if (littleEndian()) {
+            this->swapped.resize( size * sizeof( T ) );
+            byteSwap( be_data, this->swapped.data(), size, sizeof( T ) );
+            be_data = this->swapped.data();
+        }
+        this->binary( name, type, be_data, size, sizeof( T ) );
+    }
+
+    this->end();
+}
+
+
+void FortranWriter::write( const std::string& name, const int* data, std::size_t size ) {
+    this->keyword( name, EclType::INTE, data, size );
+}
+
+
+void FortranWriter::write( const std::string& name, const float* data, std::size_t size ) {
+    this->keyword( name, EclType::REAL, data, size );
+}
+
+
+void FortranWriter::write( const std::string& name, const double* data, std::size_t size ) {
+    this->keyword( name, EclType::DOUB, data, size );
+}
+
+
+void FortranWriter::writeAsFloat( const std::string& name, const double* data, std::size_t size ) {
+    std::vector< float > values( data, data + size );
+    this->keyword( name, EclType::REAL, values.data(), size );
+}
+
+
+void FortranWriter::write( const std::string& name, const std::vector< std::string >& data ) {
+    this->begin();
+
+    if (this->formatted) {
+        this->formattedKeyword( name, EclType::CHAR, data.data(), data.size() );
+    } else {
+        this->swapped.assign( data.size() * char_length, ' ' );
+        for (std::size_t i = 0; i < data.size(); i++)
+            std::memcpy( &this->swapped[i * char_length], data[i].data(),
+                         std::min( data[i].size(), char_length ) );
+        this->binary( name, EclType::CHAR, this->swapped.data(), data.size(), char_length );
+    }
+
+    this->end();
+}
+
+
+void dropFromPageCache( const std::string& filename ) {
+    const int fd = ::open( filename.c_str(), O_RDONLY );
+    if (fd < 0)
+        return;
+
+    ::fdatasync( fd );
+    ::posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+    ::close( fd );
+}
+
+
+std::size_t EclKeyword::size() const {
+    switch (this->type) {
+        case EclType::INTE: return this->ints.size();
+        case EclType::REAL: return this->floats.size();
+        case EclType::DOUB: return this->doubles.size();
+        case EclType::CHAR: return this->strings.size();
+        case EclType::LOGI: return this->ints.size();
+        case EclType::MESS: return 0;
+    }
+    return 0;
+}
+
+
+FortranReader::FortranReader( const std::string& filename ) :
+    fd( ::open( filename.c_str(), O_RDONLY ) )
+{
+    if (this->fd < 0)
+        throw ioError( "could not open " + filename );
+}
+
+
+FortranReader::~FortranReader() {
+    ::close( this->fd );
+}
+
+
+namespace {
+    /* Read exactly size bytes; false at a clean end of file. */
+    bool readAll( int fd, char* data, std::size_t size ) {
+        std::size_t done = 0;
+        while (done < size) {
+            const auto n = ::read( fd, data + done, size - done );
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw ioError( "read failed" );
+            }
+            if (n == 0) {
+                if (done == 0)
+                    return false;
+                throw std::runtime_error( "Fortran I/O: truncated record" );
+            }
+            done += n;
+        }
+        return true;
+    }
+}
+
+
+bool FortranReader::record( std::vector< char >& data ) {
+    char marker[4];
+    if (!readAll( this->fd, marker, 4 ))
+        return false;
+
+    const auto length = readInt( marker );
+    if (length < 0)
+        throw std::runtime_error( "Fortran I/O: invalid record length" );
+
+    data.resize( length );
+    if (!readAll( this->fd, data.data(), length ) || !readAll( this->fd, marker, 4 ))
+        throw std::runtime_error( "Fortran I/O: truncated record" );
+
+    if (readInt( marker ) != length)
+        throw std::runtime_error( "Fortran I/O: record markers do not match" );
+
+    return true;
+}
+
+
+bool FortranReader::nextHeader( EclHeader& header ) {
+    if (this->data_offset >= 0) {
+        if (::lseek( this->fd, this->data_offset + this->data_length, SEEK_SET ) < 0)
+            throw ioError( "seek failed" );
+        this->data_offset = -1;
+    }
+
+    if (!this->record( this->buffer ))
+        return false;
+
+    if (this->buffer.size() != 16)
+        throw std::runtime_error( "Fortran I/O: invalid keyword header" );
+
+    std::string name( this->buffer.data(), char_length );
+    name.erase( name.find_last_not_of( ' ' ) + 1 );
+    const std::string type( &this->buffer[12], 4 );
+
+    header.name = name;
+    header.size = std::size_t( readInt( &this->buffer[8] ) );
+    if (type == "INTE")
+        header.type = EclType::INTE;
+    else if (type == "REAL")
+        header.type = EclType::REAL;
+    else if (type == "DOUB")
+        header.type = EclType::DOUB;
+    else if (type == "CHAR")
+        header.type = EclType::CHAR;
+    else if (type == "LOGI")
+        header.type = EclType::LOGI;
+    else if (type == "MESS")
+        header.type = EclType::MESS;
+    else
+        throw std::runtime_error( "Fortran I/O: unsupported keyword type " + type );
+
+    const auto offset = ::lseek( this->fd, 0, SEEK_CUR );
+    if (offset < 0)
+        throw ioError( "seek failed" );
+
+    /* The data records, if any, are skipped unless readRanges() is called. */
+    const auto element_size = elementSize( header.type );
+    const auto block = blockSize( header.type );
+    const auto block_bytes = 8 + block * element_size;
+    const auto rest = header.size % block;
+    this->current = header;
+    this->data_offset = offset;
+    this->data_length = element_size == 0 ? 0
+                      : std::int64_t( header.size / block * block_bytes )
+                      + (rest ? std::int64_t( 8 + rest * element_size ) : 0);
+    return true;
+}
+
+
+std::vector< double > FortranReader::readRanges( const std::vector< std::pair< std::size_t, std::size_t > >& ranges ) {
+    if (this->data_offset < 0)
+        throw std::logic_error( "Fortran I/O: readRanges() without a keyword header" );
+
+    const auto type = this->current.type;
+    if (type != EclType::INTE && type != EclType::REAL && type != EclType::DOUB)
+        throw std::invalid_argument( "Fortran I/O: keyword " + this->current.name + " is not numeric" );
+
+    const auto element_size = elementSize( type );
+    const auto block_bytes = 8 + numeric_block * element_size;
+
+    std::vector< double > values;
+    for (const auto& range : ranges) {
+        if (range.first > range.second || range.second > this->current.size)
+            throw std::out_of_range( "Fortran I/O: range outside keyword " + this->current.name );
+
+        std::size_t index = range.first;
+        while (index < range.second) {
+            const auto within = index % numeric_block;
+            const auto count = std::min( range.second - index, numeric_block - within );
+            const auto offset = this->data_offset
+                              + std::int64_t( index / numeric_block * block_bytes + 4 + within * element_size );
+
+            this->buffer.resize( count * element_size );
+            std::size_t done = 0;
+            while (done < this->buffer.size()) {
+                const auto n = ::pread( this->fd, this->buffer.data() + done, this->buffer.size() - done, offset + done );
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n < 0)
+                    throw ioError( "read failed" );
+                if (n == 0)
+                    throw std::runtime_error( "Fortran I/O: keyword " + this->current.name + " is truncated" );
+                done += n;
+            }
+
+            if (littleEndian())
+                byteSwap( this->buffer.data(), this->buffer.data(), count, element_size );
+
+            for (std::size_t i = 0; i < count; i++) {
+                const char* element = &this->buffer[i * element_size];
+                if (type == EclType::DOUB) {
+                    double value;
+                    std::memcpy( &value, element, element_size );
+                    values.push_back( value );
+                } else if (type == EclType::REAL) {
+                    float value;
+                    std::memcpy( &value, element, element_size );
+                    values.push_back( value );
+                } else {
+                    std::int32_t value;
+                    std::memcpy( &value, element, element_size );
+                    values.push_back( value );
+                }
+            }
+
+            index += count;
+        }
+    }
+
+    return values;
+}
+
+
+bool FortranReader::next( EclKeyword& keyword ) {
+    EclHeader header;
+    if (!this->nextHeader( header ))
+        return false;
+
+    this->data_offset = -1;
+    const auto& name = header.name;
+    const auto size = header.size;
+    const auto element_size = elementSize( header.type );
+
+    keyword.name = name;
+    keyword.type = header.type;
+    keyword.ints.clear();
+    keyword.floats.clear();
+    keyword.doubles.clear();
+    keyword.strings.clear();
+
+    std::vector< char > data;
+    data.reserve( size * element_size );
+    while (data.size() < size * element_size) {
+        if (!this->record( this->buffer ))
+            throw std::runtime_error( "Fortran I/O: keyword " + name + " is truncated" );
+        data.insert( data.end(), this->buffer.begin(), this->buffer.end() );
+    }
+
+    if (data.size() != size * element_size)
+        throw std::runtime_error( "Fortran I/O: keyword " + name + " has the wrong size" );
+
+    if (littleEndian() && keyword.type != EclType::CHAR && keyword.type != EclType::MESS)
+        byteSwap( data.data(), data.data(), size, element_size );
+
+    switch (keyword.type) {
+        case EclType::INTE:
+        case EclType::LOGI:
+            keyword.ints.resize( size );
+            std::memcpy( keyword.ints.data(), data.data(), data.size() );
+            break;
+        case EclType::REAL:
+            keyword.floats.resize( size );
+            std::memcpy( keyword.floats.data(), data.data(), data.size() );
+            break;
+        case EclType::DOUB:
+            keyword.doubles.resize( size );
+            std::memcpy( keyword.doubles.data(), data.data(), data.size() );
+            break;
+        case EclType::CHAR:
+            for (std::size_t i = 0; i < size; i++)
+                keyword.strings.emplace_back( &data[i * char_length], char_length );
+            break;
+        case EclType::MESS:
+            break;
+    }
+
+    return true;
+}
+
+}
+}
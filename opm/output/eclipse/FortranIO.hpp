@@ -0,0 +1,206 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_OUTPUT_FORTRAN_IO_HPP
+#define OPM_OUTPUT_FORTRAN_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include <ert/ecl/fortio.h>
+
+#include <opm/output/util/AsyncFile.hpp>
+#include <opm/output/util/ThreadPool.hpp>
+
+namespace Opm {
+namespace out {
+
+    /// Element types of ECLIPSE keywords.  LOGI and MESS keywords are
+    /// only read; MESS keywords have no data.
+    enum class EclType { INTE, REAL, DOUB, CHAR, LOGI, MESS };
+
+    /// Write a file's dirty pages to disk and drop the file from the
+    /// page cache, with fdatasync() and posix_fadvise(DONTNEED).  For
+    /// files written by libecl; missing files are ignored.
+    void dropFromPageCache(const std::string& filename);
+
+
+    /// Writes ECLIPSE keywords as Fortran records, in the same byte
+    /// layout as libecl.
+    ///
+    /// Binary output is big-endian. Every keyword is a 24 byte header
+    /// record followed by data records of at most 1000 numeric or 105
+    /// character elements.  The records of a keyword are emitted with
+    /// one writev() call straight from the caller's array, apart from a
+    /// byte swapped copy on little-endian hosts, which is kept between
+    /// calls.
+    ///
+    /// Formatted output has libecl's column layout and number formats,
+    /// with the same 1000 element blocks, and is byte for byte what
+    /// libecl writes.  Numbers are encoded without stdio and
+    /// independently of the locale, and large keywords are encoded in
+    /// parallel, in groups of blocks, on a thread pool.
+    ///
+    /// Write errors throw std::runtime_error.
+    class FortranWriter {
+    public:
+        /// Write to a new or truncated file.
+        FortranWriter(const std::string& filename, bool formatted);
+
+        /// Write to an open file descriptor, which is not closed by the
+        /// writer.
+        FortranWriter(int fd, bool formatted);
+
+        /// Append to an asynchronous file.  The keywords are queued for
+        /// writing; AsyncFile::flush(), or close(), waits for them.
+        FortranWriter(AsyncFile& file, bool formatted);
+
+        /// Write at the current position of an open libecl stream.  The
+        /// stream is flushed before, and repositioned after, every
+        /// keyword, so libecl and this writer can be mixed on one file.
+        explicit FortranWriter(fortio_type* fortio);
+
+        /// Calls close(), ignoring errors.
+        ~FortranWriter();
+
+        FortranWriter(const FortranWriter&) = delete;
+        FortranWriter& operator=(const FortranWriter&) = delete;
+
+        void write(const std::string& name, const int* data, std::size_t size);
+        void write(const std::string& name, const float* data, std::size_t size);
+        void write(const std::string& name, const double* data, std::size_t size);
+
+        /// CHAR keyword; strings are blank padded or cut to 8 characters.
+        void write(const std::string& name, const std::vector<std::string>& data);
+
+        template <typename T>
+        void write(const std::string& name, const std::vector<T>& data)
+        {
+            this->write(name, data.data(), data.size());
+        }
+
+        /// Write doubles as a REAL keyword.
+        void writeAsFloat(const std::string& name, const double* data, std::size_t size);
+
+        /// Close the file if the writer opened it.  For an AsyncFile, wait for the queued writes.
+        /// Nothing can be written afterwards.
+        void close();
+
+        /// Encode formatted output concurrently on this pool, which
+        /// must outlive the writer.  By default the output is encoded
+        /// serially on the calling thread.
+        void setThreadPool(ThreadPool& pool);
+
+    private:
+        void binary(const std::string& name, EclType type,
+                    const char* be_data, std::size_t size, std::size_t element_size);
+
+        template <typename T>
+        void keyword(const std::string& name, EclType type, const T* data, std::size_t size);
+
+        template <typename T>
+        void formattedKeyword(const std::string& name, EclType type, const T* data, std::size_t size);
+
+        void begin();
+        void end();
+        void output(std::vector<struct iovec>& iov);
+
+        int fd;
+        bool formatted;
+        bool owns_fd;
+        fortio_type* fortio = nullptr;
+        AsyncFile* async = nullptr;
+        ThreadPool* pool = &ThreadPool::serial();
+
+        std::vector<char> swapped;
+        std::vector<std::int32_t> markers;
+        std::string text;
+        std::vector<std::string> chunks;
+    };
+
+
+    /// A keyword read by FortranReader.  Only the vector matching the
+    /// type is filled; LOGI values, zero for false, are read into ints.
+    struct EclKeyword {
+        std::string name;
+        EclType type;
+        std::vector<int> ints;
+        std::vector<float> floats;
+        std::vector<double> doubles;
+        std::vector<std::string> strings;
+
+        std::size_t size() const;
+    };
+
+
+    /// The header of a keyword read by FortranReader::nextHeader().
+    struct EclHeader {
+        std::string name;
+        EclType type;
+        std::size_t size;
+    };
+
+
+    /// Reads the keywords of a binary file written by FortranWriter or
+    /// libecl.  Throws std::runtime_error for damaged records or
+    /// unsupported types, which are all but INTE, REAL, DOUB, CHAR,
+    /// LOGI and MESS.
+    class FortranReader {
+    public:
+        explicit FortranReader(const std::string& filename);
+        ~FortranReader();
+
+        FortranReader(const FortranReader&) = delete;
+        FortranReader& operator=(const FortranReader&) = delete;
+
+        /// Read the next keyword; false at the end of the file.
+        bool next(EclKeyword& keyword);
+
+        /// Read the header of the next keyword only; false at the end
+        /// of the file.  Its data can be read with readRanges() and is
+        /// skipped, without reading it, by the next call to next() or
+        /// nextHeader().
+        bool nextHeader(EclHeader& header);
+
+        /// Elements of the INTE, REAL or DOUB keyword whose header was
+        /// read last, in the half-open index ranges, as doubles in the
+        /// order of the ranges.  Only the records holding the ranges
+        /// are read.
+        std::vector<double> readRanges(const std::vector<std::pair<std::size_t, std::size_t>>& ranges);
+
+    private:
+        bool record(std::vector<char>& data);
+
+        int fd;
+        std::vector<char> buffer;
+
+        /* The data records after the last header from nextHeader(). */
+        EclHeader current;
+        std::int64_t data_offset = -1;
+        std::int64_t data_length = 0;
+    };
+
+}} // namespace Opm::out
+
+#endif // OPM_OUTPUT_FORTRAN_IO_HPP
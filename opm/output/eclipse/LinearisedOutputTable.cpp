@@ -3,8 +3,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <cstddef>
 #include <utility>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+
 Opm::LinearisedOutputTable::
 LinearisedOutputTable(const std::size_t numTables0,
                       const std::size_t numPrimary0,
@@ -16,6 +21,25 @@ LinearisedOutputTable(const std::size_t numTables0,
     , numRows   (numRows0)
 {}
 
+Opm::LinearisedOutputTable::
+LinearisedOutputTable(std::vector<double>& storage,
+                      const std::size_t    offset0,
+                      const std::size_t    numTables0,
+                      const std::size_t    numPrimary0,
+                      const std::size_t    numRows0,
+                      const std::size_t    numCols0)
+    : external  (&storage)
+    , offset    (offset0)
+    , numTables (numTables0)
+    , numPrimary(numPrimary0)
+    , numRows   (numRows0)
+{
+    assert (offset0 + numTables0*numPrimary0*numRows0*numCols0
+            <= storage.size());
+
+    static_cast<void>(numCols0);
+}
+
 std::vector<double>::iterator
 Opm::LinearisedOutputTable::column(const std::size_t tableID,
                                    const std::size_t primID,
@@ -24,12 +48,15 @@ Opm::LinearisedOutputTable::column(const std::size_t tableID,
     // Table format: numRows * numPrimary * numTables values for first
     // column (ID == 0), followed by same number of entries for second
     // column &c.
-    const auto offset =
-        0 + this->numRows*(primID + this->numPrimary*(tableID + this->numTables*colID));
+    auto& buffer = (this->external != nullptr)
+        ? *this->external : this->data;
+
+    const auto start = this->offset +
+        this->numRows*(primID + this->numPrimary*(tableID + this->numTables*colID));
 
-    assert (offset + this->numRows <= this->data.size());
+    assert (start + this->numRows <= buffer.size());
 
-    return this->data.begin() + offset;
+    return buffer.begin() + start;
 }
 
 const std::vector<double>&
@@ -46,6 +73,76 @@ Opm::LinearisedOutputTable::getDataDestructively()
 
 // ---------------------------------------------------------------------
 
+namespace {
+    /// Slope kernel for a single (table, primary key) block.
+    ///
+    /// Rows of each column are contiguous, so we sweep the rows of all
+    /// dependent columns together in blocks of vector width, computing
+    /// the interval widths and the dx == 0 mask once per block.  Slopes
+    /// are stored at the right interval end-point, i.e., in rows
+    /// 1..numActRows-1 of the derivative columns.  Row zero and rows at
+    /// or beyond numActRows keep their existing (padding) values.
+    ///
+    /// \param[in] nDep Number of dependent columns.
+    ///
+    /// \param[in] nRows Number of active rows (>= 2).
+    ///
+    /// \param[in] colStride Distance between consecutive columns.
+    ///
+    /// \param[in,out] x Start of independent column.  Dependent columns
+    ///    start at x + colStride*(1..nDep), derivative columns at x +
+    ///    colStride*(nDep+1..2*nDep).
+    void slopeKernel(const std::size_t nDep,
+                     const std::size_t nRows,
+                     const std::ptrdiff_t colStride,
+                     double* const x)
+    {
+        const double* const y  = x + colStride;
+        double* const       dy = x + (1 + nDep)*colStride;
+
+        auto i = std::size_t{1};
+
+#if defined(__SSE2__)
+        {
+            const auto signMask = _mm_set1_pd(-0.0);
+            const auto zero     = _mm_setzero_pd();
+
+            for (; i + 2 <= nRows; i += 2) {
+                const auto dx =
+                    _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(x + i - 1));
+
+                // Choice for dx==0 somewhat debatable.  Matches the
+                // scalar path, including NaN intervals.
+                const auto valid = _mm_cmpgt_pd(_mm_andnot_pd(signMask, dx), zero);
+
+                for (auto j = 0*nDep; j < nDep; ++j) {
+                    const auto* yj = y + j*colStride;
+
+                    const auto delta =
+                        _mm_sub_pd(_mm_loadu_pd(yj + i), _mm_loadu_pd(yj + i - 1));
+
+                    _mm_storeu_pd(dy + j*colStride + i,
+                                  _mm_and_pd(valid, _mm_div_pd(delta, dx)));
+                }
+            }
+        }
+#endif  // __SSE2__
+
+        // Remaining rows (or all rows if no vector unit available).
+        for (; i < nRows; ++i) {
+            const auto dx = x[i] - x[i - 1];
+
+            for (auto j = 0*nDep; j < nDep; ++j) {
+                const auto* yj    = y + j*colStride;
+                const auto  delta = yj[i] - yj[i - 1];
+
+                // Choice for dx==0 somewhat debatable.
+                dy[j*colStride + i] = (std::abs(dx) > 0.0) ? (delta / dx) : 0.0;
+            }
+        }
+    }
+} // Anonymous
+
 void
 Opm::DifferentiateOutputTable::calcSlopes(const std::size_t      nDep,
                                           const Descriptor&      desc,
@@ -57,48 +154,12 @@ Opm::DifferentiateOutputTable::calcSlopes(const std::size_t      nDep,
         return;
     }
 
-    auto x = table.column(desc.tableID, desc.primID, 0);
-
-    using colIT = decltype(x);
-
-    auto y  = std::vector<colIT>{};  y .reserve(nDep);
-    auto dy = std::vector<colIT>{};  dy.reserve(nDep);
-    auto y0 = std::vector<double>(nDep);
-    auto y1 = y0;
-    for (auto j = 0*nDep; j < nDep; ++j) {
-        y .push_back(table.column(desc.tableID, desc.primID, j + 1 + 0*nDep));
-        dy.push_back(table.column(desc.tableID, desc.primID, j + 1 + 1*nDep));
-
-        y1[j] = *y.back();  ++y.back();
-
-        // Store derivatives at right interval end-point.
-        ++dy.back();
-    }
-
-    using std::swap;
+    // Columns of a single (table, primary key) block are equally spaced
+    // in the underlying storage.
+    auto* x = &*table.column(desc.tableID, desc.primID, 0);
 
-    auto x1 = *x;  ++x;  auto x0 = 0 * x1;
+    const auto colStride =
+        &*table.column(desc.tableID, desc.primID, 1) - x;
 
-    // Recall: Number of slope intervals one less than number of active
-    // table rows.
-    for (auto n = desc.numActRows - 1, i = 0*n; i < n; ++i) {
-        // Save previous right-hand point as this left-hand point, clear
-        // space for new right-hand point.
-        swap(x0, x1);  x1 = *x;  ++x;
-        swap(y0, y1);
-
-        const auto dx = x1 - x0;
-
-        for (auto j = 0*nDep; j < nDep; ++j) {
-            y1[j] = *y[j];
-
-            const auto delta = y1[j] - y0[j];
-
-            // Choice for dx==0 somewhat debatable.
-            *dy[j] = (std::abs(dx) > 0.0) ? (delta / dx) : 0.0;
-
-            // Advance column iterators;
-            ++y[j];  ++dy[j];
-        }
-    }
+    slopeKernel(nDep, desc.numActRows, colStride, x);
 }
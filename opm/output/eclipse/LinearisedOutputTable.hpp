@@ -57,6 +57,41 @@ namespace Opm {
                               const std::size_t numRows,
                               const std::size_t numCols);
 
+        /// Constructor for table in externally managed storage.
+        ///
+        /// Supports building tables in place, directly in the final
+        /// output buffer, without intermediate copies.  The table
+        /// occupies the \code numTables * numPrimary * numRows * numCols
+        /// \endcode elements starting at index \p offset of \p storage.
+        /// Those elements are not initialised by this constructor, so the
+        /// caller is responsible for any padding values.
+        ///
+        /// Distinct tables (\c tableID) occupy disjoint elements of the
+        /// storage so may be filled concurrently.
+        ///
+        /// \param[in,out] storage External buffer.  Must hold at least
+        ///    \code offset + numTables * numPrimary * numRows * numCols
+        ///    \endcode elements and must not be resized while the table
+        ///    is in use.
+        ///
+        /// \param[in] offset Index of first table element in \p storage.
+        ///
+        /// \param[in] numTables Number of tables.  See above.
+        ///
+        /// \param[in] numPrimary Number of primary look-up keys.  See
+        ///    above.
+        ///
+        /// \param[in] numRows Number of rows in each sub-table.  See above.
+        ///
+        /// \param[in] numCols Number of columns in each sub-table.  See
+        ///    above.
+        LinearisedOutputTable(std::vector<double>& storage,
+                              const std::size_t    offset,
+                              const std::size_t    numTables,
+                              const std::size_t    numPrimary,
+                              const std::size_t    numRows,
+                              const std::size_t    numCols);
+
         /// Retrieve iterator to start of \c numRows (contiguous) column
         /// elements of a particular sub-table of a particular main table.
         ///
@@ -81,6 +116,7 @@ namespace Opm {
         /// Read-only access to internal data buffer.
         ///
         /// Mostly to support outputting all table data to external storage.
+        /// Empty for tables in externally managed storage.
         const std::vector<double>& getData() const;
 
         /// Destructive access to internal data buffer.
@@ -94,6 +130,13 @@ namespace Opm {
         /// Internal buffer for tabular data.
         std::vector<double> data;
 
+        /// External buffer for tabular data.  Null if table data is
+        /// stored in \c data.
+        std::vector<double>* external{ nullptr };
+
+        /// Index of first table element in \c external.
+        std::size_t offset{ 0 };
+
         /// Number of tables managed by \c data.
         std::size_t numTables;
 
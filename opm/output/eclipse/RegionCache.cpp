@@ -27,6 +27,9 @@
 
 #include <opm/output/eclipse/RegionCache.hpp>
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace Opm {
 namespace out {
 
@@ -46,9 +49,61 @@ RegionCache::RegionCache(const Eclipse3DProperties& properties, const EclipseGri
             }
         }
     }
+
+    this->addRegionSet( properties, grid, "FIPNUM" );
 }
 
 
+    void RegionCache::addRegionSet(const Eclipse3DProperties& properties, const EclipseGrid& grid, const std::string& region_set) {
+        const auto& regions = properties.getIntGridProperty( region_set );
+
+        std::vector<int> cell_region( grid.getNumActive() , 0 );
+        int max_region = 0;
+        for (size_t global_index = 0; global_index < grid.getCartesianSize(); global_index++) {
+            if (grid.cellActive( global_index )) {
+                const int region_id = regions.iget( global_index );
+                cell_region[ grid.activeIndex( global_index ) ] = region_id;
+                max_region = std::max( max_region , region_id );
+            }
+        }
+
+        /* Counting sort; cells stay in increasing active index order within each region. */
+        RegionCells csr;
+        csr.num_active = cell_region.size();
+        csr.start.assign( max_region + 1 , 0 );
+        for (const int region_id : cell_region) {
+            if (region_id > 0)
+                csr.start[ region_id ] += 1;
+        }
+        for (size_t r = 1; r < csr.start.size(); r++)
+            csr.start[r] += csr.start[r - 1];
+
+        csr.cells.resize( csr.start.back() );
+        std::vector<size_t> next( csr.start.begin() , csr.start.end() - 1 );
+        for (size_t active_index = 0; active_index < cell_region.size(); active_index++) {
+            const int region_id = cell_region[ active_index ];
+            if (region_id > 0)
+                csr.cells[ next[ region_id - 1 ]++ ] = active_index;
+        }
+
+        this->region_sets[ region_set ] = std::move( csr );
+    }
+
+
+    bool RegionCache::hasRegionSet(const std::string& region_set) const {
+        return this->region_sets.count( region_set ) > 0;
+    }
+
+
+    const RegionCache::RegionCells& RegionCache::regionCells(const std::string& region_set) const {
+        const auto iter = this->region_sets.find( region_set );
+        if (iter == this->region_sets.end())
+            throw std::invalid_argument("Region set " + region_set + " has not been added to the region cache");
+
+        return iter->second;
+    }
+
+
     const std::vector<std::pair<std::string,size_t>>& RegionCache::completions( int region_id ) const {
         const auto iter = this->completion_map.find( region_id );
         if (iter == this->completion_map.end())
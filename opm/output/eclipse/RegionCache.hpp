@@ -20,6 +20,10 @@
 #ifndef OPM_REGION_CACHE_HPP
 #define OPM_REGION_CACHE_HPP
 
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace Opm {
@@ -34,10 +38,37 @@ namespace out {
         RegionCache(const Eclipse3DProperties& properties, const EclipseGrid& grid, const Schedule& schedule);
         const std::vector<std::pair<std::string,size_t>>& completions( int region_id ) const;
 
+        /*
+          The active cells of every region in a region set, e.g. FIPNUM,
+          in compressed row form: the active indices of the cells in
+          region r are cells[start[r-1]] ... cells[start[r]-1], in
+          increasing order. Cells with a region id below one are not
+          part of any region.
+        */
+        struct RegionCells {
+            std::vector<size_t> start;
+            std::vector<size_t> cells;
+            size_t num_active = 0;
+
+            size_t numRegions() const { return this->start.empty() ? 0 : this->start.size() - 1; }
+        };
+
+        /*
+          Build the cell lists of the integer property region_set. The
+          FIPNUM lists are built by the constructor; other region sets,
+          like the FIP* sets, must be added before they are used.
+        */
+        void addRegionSet(const Eclipse3DProperties& properties, const EclipseGrid& grid, const std::string& region_set);
+        bool hasRegionSet(const std::string& region_set) const;
+
+        /* Throws std::invalid_argument if the region set has not been added. */
+        const RegionCells& regionCells(const std::string& region_set = "FIPNUM") const;
+
     private:
         std::vector<std::pair<std::string,size_t>> completions_empty;
 
         std::map<int , std::vector<std::pair<std::string,size_t>>> completion_map;
+        std::map<std::string, RegionCells> region_sets;
     };
 }
 }
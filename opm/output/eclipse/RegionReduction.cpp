@@ -0,0 +1,190 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opm/output/eclipse/RegionReduction.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace Opm {
+namespace out {
+
+namespace {
+    /* Cells per block; fixed so that the summation order never changes. */
+    const std::size_t block_size = 4096;
+
+    /* Blocks per parallel task. */
+    const std::size_t blocks_per_task = 8;
+
+    void checkSize( const std::vector< double >& values, std::size_t num_cells, const char* what ) {
+        if (values.size() < num_cells)
+            throw std::invalid_argument( std::string( "RegionReduction: " ) + what
+                                         + " has fewer elements than the number of active cells" );
+    }
+}
+
+
+RegionReduction::RegionReduction( const RegionCache& cache,
+                                  const std::string& region_set,
+                                  ThreadPool& pool_arg ) :
+    regions( cache.regionCells( region_set ) ),
+    pool( pool_arg )
+{
+    for (std::size_t r = 0; r < this->regions.numRegions(); r++) {
+        for (auto begin = this->regions.start[r]; begin < this->regions.start[r + 1]; begin += block_size) {
+            const auto end = std::min( begin + block_size, this->regions.start[r + 1] );
+            this->blocks.push_back( { r, begin, end } );
+        }
+    }
+}
+
+
+std::size_t RegionReduction::numRegions() const {
+    return this->regions.numRegions();
+}
+
+
+/*
+  Runs partial( block, numerator, denominator ) for every block in
+  parallel, then adds the block results of each region in block order.
+*/
+template< typename Partial >
+std::vector< double > RegionReduction::reduceBlocks( Partial partial, bool weighted ) const {
+    std::vector< double > numerator( this->blocks.size(), 0.0 );
+    std::vector< double > denominator( weighted ? this->blocks.size() : 0, 0.0 );
+
+    this->pool.parallelFor( 0, this->blocks.size(), blocks_per_task,
+                            [&]( std::size_t first, std::size_t last ) {
+        for (auto b = first; b < last; b++)
+            partial( this->blocks[b], numerator[b], weighted ? denominator[b] : numerator[b] );
+    });
+
+    std::vector< double > result( this->numRegions(), 0.0 );
+    std::vector< double > total( weighted ? this->numRegions() : 0, 0.0 );
+    for (std::size_t b = 0; b < this->blocks.size(); b++) {
+        result[ this->blocks[b].region ] += numerator[b];
+        if (weighted)
+            total[ this->blocks[b].region ] += denominator[b];
+    }
+
+    if (weighted) {
+        for (std::size_t r = 0; r < result.size(); r++)
+            result[r] = (total[r] != 0.0) ? result[r] / total[r] : 0.0;
+    }
+
+    return result;
+}
+
+
+std::vector< double > RegionReduction::sum( const std::vector< double >& field ) const {
+    checkSize( field, this->regions.num_active, "field" );
+
+    const auto& cells = this->regions.cells;
+    return this->reduceBlocks( [&]( const Block& block, double& value, double& ) {
+        double s = 0.0;
+        for (auto i = block.begin; i < block.end; i++)
+            s += field[ cells[i] ];
+        value = s;
+    }, false );
+}
+
+
+std::vector< double > RegionReduction::average( const std::vector< double >& field,
+                                                const std::vector< double >& weight ) const {
+    checkSize( field, this->regions.num_active, "field" );
+    checkSize( weight, this->regions.num_active, "weight" );
+
+    const auto& cells = this->regions.cells;
+    return this->reduceBlocks( [&]( const Block& block, double& value, double& total ) {
+        double s = 0.0;
+        double w = 0.0;
+        for (auto i = block.begin; i < block.end; i++) {
+            const auto c = cells[i];
+            s += field[c] * weight[c];
+            w += weight[c];
+        }
+        value = s;
+        total = w;
+    }, true );
+}
+
+
+std::vector< double > RegionReduction::reduce( const data::Solution& cells,
+                                               const std::string& field,
+                                               Kind kind,
+                                               const std::vector< double >& porv ) const {
+    const auto& values = cells.data( field );
+
+    switch (kind) {
+        case Kind::Sum:
+            return this->sum( values );
+
+        case Kind::PoreVolumeAverage:
+            return this->average( values, porv );
+
+        case Kind::HydrocarbonVolumeAverage: {
+            if (!cells.has( "SWAT" ))
+                throw std::invalid_argument( "RegionReduction: the hydrocarbon volume average of "
+                                             + field + " requires the SWAT field" );
+
+            const auto& swat = cells.data( "SWAT" );
+            checkSize( porv, this->regions.num_active, "porv" );
+            checkSize( swat, this->regions.num_active, "SWAT" );
+
+            std::vector< double > hcpv( porv.size() );
+            for (std::size_t i = 0; i < porv.size() && i < swat.size(); i++)
+                hcpv[i] = porv[i] * (1.0 - swat[i]);
+
+            return this->average( values, hcpv );
+        }
+    }
+
+    throw std::invalid_argument( "RegionReduction: unknown reduction kind" );
+}
+
+
+std::map< std::string, std::vector< double > >
+RegionReduction::regionValues( const data::Solution& cells,
+                               const std::vector< double >& porv ) const {
+    static const std::vector< std::pair< std::string, std::string > > sums = {
+        { "ROIP"  , "OIP"  },
+        { "ROIPL" , "OIPL" },
+        { "ROIPG" , "OIPG" },
+        { "RGIP"  , "GIP"  },
+        { "RGIPL" , "GIPL" },
+        { "RGIPG" , "GIPG" },
+        { "RWIP"  , "WIP"  },
+    };
+
+    std::map< std::string, std::vector< double > > values;
+
+    for (const auto& vector_field : sums) {
+        if (cells.has( vector_field.second ))
+            values.emplace( vector_field.first, this->sum( cells.data( vector_field.second ) ) );
+    }
+
+    if (cells.has( "PRESSURE" ) && cells.has( "SWAT" ))
+        values.emplace( "RPR", this->reduce( cells, "PRESSURE", Kind::HydrocarbonVolumeAverage, porv ) );
+
+    return values;
+}
+
+}
+}
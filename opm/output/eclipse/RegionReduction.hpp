@@ -0,0 +1,111 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_REGION_REDUCTION_HPP
+#define OPM_REGION_REDUCTION_HPP
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <opm/output/data/Solution.hpp>
+#include <opm/output/eclipse/RegionCache.hpp>
+#include <opm/output/util/ThreadPool.hpp>
+
+namespace Opm {
+namespace out {
+
+    /*
+      Reduces per-cell solution fields to per-region values over one
+      region set of a RegionCache, e.g. for the region summary vectors.
+
+      The cells of every region are split into fixed-size blocks which
+      are reduced concurrently; the block results are then combined in
+      block order. The result is therefore bitwise reproducible and
+      independent of the number of threads.
+
+      All field and weight vectors are indexed by active cell. The
+      result vectors have one element per region, with region r at
+      index r - 1.
+    */
+    class RegionReduction {
+    public:
+        enum class Kind {
+            Sum,                        // Plain sum over the region.
+            PoreVolumeAverage,          // Weighted by pore volume.
+            HydrocarbonVolumeAverage    // Weighted by pore volume * (1 - SWAT).
+        };
+
+        /* The cache and pool must outlive the RegionReduction. */
+        RegionReduction( const RegionCache& cache,
+                         const std::string& region_set = "FIPNUM",
+                         ThreadPool& pool = ThreadPool::serial() );
+
+        std::size_t numRegions() const;
+
+        std::vector< double > sum( const std::vector< double >& field ) const;
+
+        /* Regions with zero total weight get the value zero. */
+        std::vector< double > average( const std::vector< double >& field,
+                                       const std::vector< double >& weight ) const;
+
+        /*
+          Reduce the named field of the solution. The pore volumes are
+          required for the averages; the hydrocarbon volume average also
+          requires the SWAT field of the solution and throws
+          std::invalid_argument without it. Throws std::out_of_range if
+          the field is missing.
+        */
+        std::vector< double > reduce( const data::Solution& cells,
+                                      const std::string& field,
+                                      Kind kind,
+                                      const std::vector< double >& porv = {} ) const;
+
+        /*
+          Evaluate the standard region vectors from the solution: RPR
+          as the hydrocarbon volume weighted PRESSURE, and ROIP, ROIPL,
+          ROIPG, RGIP, RGIPL, RGIPG and RWIP as sums of the
+          corresponding OIP, OIPL, ... fields. Vectors whose fields are
+          missing are left out; RPR also needs SWAT. The result has the
+          layout of the region_values argument of Summary::add_timestep().
+        */
+        std::map< std::string, std::vector< double > >
+        regionValues( const data::Solution& cells,
+                      const std::vector< double >& porv ) const;
+
+    private:
+        struct Block {
+            std::size_t region;
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        const RegionCache::RegionCells& regions;
+        ThreadPool& pool;
+        std::vector< Block > blocks;
+
+        template< typename Partial >
+        std::vector< double > reduceBlocks( Partial partial, bool weighted ) const;
+    };
+
+}
+}
+
+#endif
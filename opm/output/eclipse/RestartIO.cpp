@@ -20,14 +20,27 @@
   You should have received a copy of the GNU General Public License
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 
+#include <opm/output/eclipse/FortranIO.hpp>
 #include <opm/output/eclipse/RestartIO.hpp>
+#include <opm/output/eclipse/ScheduleSnapshot.hpp>
+#include <opm/output/util/LossyCodec.hpp>
 
 #include <ert/ecl/EclKW.hpp>
 #include <ert/ecl/FortIO.hpp>
@@ -44,8 +57,15 @@
 #include <ert/ecl_well/well_const.h>
 #include <ert/ecl/ecl_rsthead.h>
 #include <ert/util/util.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 #define OPM_XWEL      "OPM_XWEL"
 #define OPM_IWEL      "OPM_IWEL"
+#define OPM_DLTA      "OPM_DLTA"
+#define OPM_DREF      "OPM_DREF"
+#define OPM_LOSY      "OPM_LOSY"
 
 namespace Opm {
 namespace RestartIO  {
@@ -88,6 +108,30 @@ namespace {
         }
     }
 
+    /*
+      The simulator data of the completions of one well, by active cell
+      index. Building the table is linear in the number of completions,
+      so matching all schedule completions of a well costs O(n) instead
+      of a linear search per completion. The first data completion of a
+      cell wins, as in a linear search.
+    */
+    class CompletionLookup {
+    public:
+        void reset( const data::Well& well ) {
+            this->by_index.clear();
+            for( const auto& completion : well.completions )
+                this->by_index.emplace( completion.index, &completion );
+        }
+
+        const data::Completion* find( int active_index ) const {
+            const auto completion = this->by_index.find( size_t( active_index ) );
+            return completion == this->by_index.end() ? nullptr : completion->second;
+        }
+
+    private:
+        std::unordered_map< size_t, const data::Completion* > by_index;
+    };
+
     std::vector<double> double_vector( const ecl_kw_type * ecl_kw ) {
         size_t size = ecl_kw_get_size( ecl_kw );
 
@@ -102,10 +146,146 @@ namespace {
     }
 
 
+    /*
+      The name of a keyword of the n'th delta or lossy encoded field,
+      like OPMDI001.
+    */
+    std::string numbered_kw( const char* prefix, int n ) {
+        char name[9];
+        std::snprintf( name, sizeof name, "%s%03d", prefix, n );
+        return name;
+    }
+
+    /*
+      The separate restart file of the keyframe step, in the directory
+      and format of filename.
+    */
+    std::string keyframe_filename( const std::string& filename, int keyframe_step ) {
+        bool fmt_file = false;
+        int report_nr;
+        ecl_util_get_file_type( filename.c_str(), &fmt_file, &report_nr );
+
+        char* path = nullptr;
+        char* base = nullptr;
+        util_alloc_file_components( filename.c_str(), &path, &base, nullptr );
+        const std::string stem = path ? std::string( path ) + "/" + base : std::string( base ? base : "" );
+        std::free( path );
+        std::free( base );
+
+        return ERT::EclFilename( stem, ECL_RESTART_FILE, keyframe_step, fmt_file );
+    }
+
+    /*
+      The fields a restart step stores as sparse deltas against a
+      keyframe step, with the number n of their OPMDInnn and OPMDVnnn
+      keywords.
+    */
+    struct StepDeltas {
+        int keyframe_step = -1;
+        std::map< std::string, int > fields;
+    };
+
+    StepDeltas stepDeltas( ecl_file_view_type* file_view ) {
+        StepDeltas deltas;
+        if( !ecl_file_view_has_kw( file_view, OPM_DLTA ) )
+            return deltas;
+
+        const ecl_kw_type * names = ecl_file_view_iget_named_kw( file_view, OPM_DLTA, 0 );
+        deltas.keyframe_step = ecl_kw_iget_int( ecl_file_view_iget_named_kw( file_view, OPM_DREF, 0 ), 0 );
+        for( int n = 0; n < ecl_kw_get_size( names ); n++ ) {
+            std::string name = ecl_kw_iget_char_ptr( names, n );
+            name.erase( name.find_last_not_of( ' ' ) + 1 );
+            deltas.fields[ name ] = n;
+        }
+
+        return deltas;
+    }
+
+    /*
+      Apply the delta of field n to data, where the value of active cell
+      i is at position( i ), or not present when that is negative.
+    */
+    template< typename Position >
+    void applyDelta( ecl_file_view_type* file_view, int n, const std::string& name,
+                     int numcells, std::vector< double >& data, Position position ) {
+        const ecl_kw_type * index_kw = ecl_file_view_iget_named_kw( file_view, numbered_kw( "OPMDI", n ).c_str(), 0 );
+        const auto values = double_vector( ecl_file_view_iget_named_kw( file_view, numbered_kw( "OPMDV", n ).c_str(), 0 ) );
+        const int * index = ecl_kw_get_int_ptr( index_kw );
+
+        if( size_t( ecl_kw_get_size( index_kw ) ) != values.size() )
+            throw std::runtime_error( "Restart file: mismatched delta of " + name );
+
+        for( size_t i = 0; i < values.size(); i++ ) {
+            if( index[i] < 0 || index[i] >= numcells )
+                throw std::runtime_error( "Restart file: delta of " + name + " out of range" );
+
+            const auto pos = position( index[i] );
+            if( pos >= 0 )
+                data[ pos ] = values[i];
+        }
+    }
+
+    /*
+      The requested fields which the restart step stores as sparse
+      deltas, reconstructed from the keyframe step in the units of the
+      file.
+    */
+    std::map< std::string, std::vector< double > > restoreDeltaFields( ecl_file_type* file,
+                                                                      ecl_file_view_type* file_view,
+                                                                      const std::string& filename,
+                                                                      bool unified,
+                                                                      const std::map<std::string, RestartKey>& keys,
+                                                                      int numcells ) {
+        std::map< std::string, std::vector< double > > fields;
+        const auto deltas = stepDeltas( file_view );
+        if( std::none_of( deltas.fields.begin(), deltas.fields.end(),
+                          [&keys]( const std::pair< const std::string, int >& field ) { return keys.count( field.first ) > 0; } ) )
+            return fields;
+
+        const int keyframe_step = deltas.keyframe_step;
+        ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > keyframe_file;
+        ecl_file_view_type * keyframe_view = nullptr;
+        if( unified )
+            keyframe_view = ecl_file_get_restart_view( file, -1, keyframe_step, -1, -1 );
+        else {
+            keyframe_file.reset( ecl_file_open( keyframe_filename( filename, keyframe_step ).c_str(), 0 ) );
+            if( keyframe_file )
+                keyframe_view = ecl_file_get_global_view( keyframe_file.get() );
+        }
+
+        if( !keyframe_view )
+            throw std::runtime_error( "Restart file " + filename
+                                      + " refers to keyframe report step "
+                                      + std::to_string( keyframe_step ) + " which is not available" );
+
+        for( const auto& field : deltas.fields ) {
+            const auto& name = field.first;
+            if( !keys.count( name ) )
+                continue;
+
+            if( !ecl_file_view_has_kw( keyframe_view, name.c_str() ) )
+                throw std::runtime_error( "Keyframe report step " + std::to_string( keyframe_step )
+                                          + " does not contain " + name + " data" );
+
+            auto data = double_vector( ecl_file_view_iget_named_kw( keyframe_view, name.c_str(), 0 ) );
+            if( data.size() != size_t( numcells ) )
+                throw std::runtime_error( "Restart file: Could not restore "
+                                          + name
+                                          + ", mismatched number of cells" );
+
+            applyDelta( file_view, field.second, name, numcells, data, []( int cell ) { return long( cell ); } );
+            fields[ name ] = std::move( data );
+        }
+
+        return fields;
+    }
+
+
     inline data::Solution restoreSOLUTION( ecl_file_view_type* file_view,
                                            const std::map<std::string, RestartKey>& keys,
                                            const UnitSystem& units,
-                                           int numcells) {
+                                           int numcells,
+                                           std::map< std::string, std::vector< double > > delta_fields) {
 
         data::Solution sol;
         for (const auto& pair : keys) {
@@ -113,23 +293,25 @@ namespace {
             UnitSystem::measure dim = pair.second.dim;
             bool required = pair.second.required;
 
-            if( !ecl_file_view_has_kw( file_view, key.c_str() ) ) {
-                if (required)
-                    throw std::runtime_error("Read of restart file: "
-                                             "File does not contain "
-                                             + key
-                                             + " data" );
-                else
-                    continue;
-            }
+            std::vector<double> data;
+            const auto delta = delta_fields.find( key );
+            if( delta != delta_fields.end() )
+                data = std::move( delta->second );
+            else if( ecl_file_view_has_kw( file_view, key.c_str() ) )
+                data = double_vector( ecl_file_view_iget_named_kw( file_view , key.c_str() , 0 ) );
+            else if (required)
+                throw std::runtime_error("Read of restart file: "
+                                         "File does not contain "
+                                         + key
+                                         + " data" );
+            else
+                continue;
 
-            const ecl_kw_type * ecl_kw = ecl_file_view_iget_named_kw( file_view , key.c_str() , 0 );
-            if( ecl_kw_get_size(ecl_kw) != numcells)
+            if( data.size() != size_t( numcells ) )
                 throw std::runtime_error("Restart file: Could not restore "
-                                         + std::string( ecl_kw_get_header( ecl_kw ) )
+                                         + key
                                          + ", mismatched number of cells" );
 
-            std::vector<double> data = double_vector( ecl_kw );
             units.to_si( dim , data );
 
             sol.insert( key, dim, data , data::TargetType::RESTART_SOLUTION );
@@ -139,6 +321,154 @@ namespace {
     }
 
 
+    /*
+      Decode the requested auxiliary fields which the restart step
+      stores lossily and which are not in fields yet, in the units of
+      the file.
+    */
+    void restoreQuantisedFields( ecl_file_view_type* file_view,
+                                 const std::map<std::string, RestartKey>& keys,
+                                 std::map< std::string, std::vector< double > >& fields ) {
+        if( !ecl_file_view_has_kw( file_view, OPM_LOSY ) )
+            return;
+
+        const ecl_kw_type * names = ecl_file_view_iget_named_kw( file_view, OPM_LOSY, 0 );
+        for( int n = 0; n < ecl_kw_get_size( names ); n++ ) {
+            std::string name = ecl_kw_iget_char_ptr( names, n );
+            name.erase( name.find_last_not_of( ' ' ) + 1 );
+            if( !keys.count( name ) || fields.count( name ) )
+                continue;
+
+            const ecl_kw_type * header = ecl_file_view_iget_named_kw( file_view, numbered_kw( "OPMQH", n ).c_str(), 0 );
+            const ecl_kw_type * words = ecl_file_view_iget_named_kw( file_view, numbered_kw( "OPMQD", n ).c_str(), 0 );
+            if( ecl_kw_get_size( header ) != 3 )
+                throw std::runtime_error( "Restart file: invalid encoding of " + name );
+
+            out::QuantisedField field;
+            field.minimum = ecl_kw_iget_double( header, 0 );
+            field.step = ecl_kw_iget_double( header, 1 );
+            field.size = size_t( ecl_kw_iget_double( header, 2 ) );
+
+            const int * data = ecl_kw_get_int_ptr( words );
+            field.words.assign( data, data + ecl_kw_get_size( words ) );
+            fields[ name ] = out::dequantise( field );
+        }
+    }
+
+
+    using CellRanges = std::vector< std::pair< size_t, size_t > >;
+
+    std::vector< double > gatherRanges( const std::vector< double >& data, const CellRanges& ranges ) {
+        std::vector< double > selected;
+        for( const auto& range : ranges )
+            selected.insert( selected.end(), data.begin() + range.first, data.begin() + range.second );
+        return selected;
+    }
+
+    /*
+      The cells of the named fields of a report step in a binary restart
+      file, read with FortranReader::readRanges() and seeking past all
+      other data. In a unified file the step runs from its SEQNUM
+      keyword to the next one.
+    */
+    std::map< std::string, std::vector< double > > readCellRanges( const std::string& filename,
+                                                                  bool unified,
+                                                                  int report_step,
+                                                                  const std::set< std::string >& names,
+                                                                  const CellRanges& ranges ) {
+        std::map< std::string, std::vector< double > > fields;
+        out::FortranReader reader( filename );
+        out::EclHeader header;
+        bool in_step = !unified;
+
+        while( fields.size() < names.size() && reader.nextHeader( header ) ) {
+            if( unified && header.name == "SEQNUM" ) {
+                if( in_step )
+                    break;
+                in_step = reader.readRanges( { { 0, 1 } } )[0] == report_step;
+            } else if( in_step && names.count( header.name ) && !fields.count( header.name ) )
+                fields[ header.name ] = reader.readRanges( ranges );
+        }
+
+        return fields;
+    }
+
+    /*
+      The solution in the cell ranges of a step of a binary restart
+      file, including fields stored as deltas against a keyframe.
+    */
+    data::Solution restoreCells( ecl_file_view_type* file_view,
+                                 const std::string& filename,
+                                 bool unified,
+                                 int report_step,
+                                 const std::map<std::string, RestartKey>& keys,
+                                 const UnitSystem& units,
+                                 int numcells,
+                                 const CellRanges& ranges ) {
+        std::set< std::string > names;
+        for( const auto& pair : keys )
+            names.insert( pair.first );
+
+        auto fields = readCellRanges( filename, unified, report_step, names, ranges );
+
+        const auto deltas = stepDeltas( file_view );
+        std::set< std::string > from_keyframe;
+        for( const auto& field : deltas.fields )
+            if( names.count( field.first ) && !fields.count( field.first ) )
+                from_keyframe.insert( field.first );
+
+        size_t num_selected = 0;
+        for( const auto& range : ranges )
+            num_selected += range.second - range.first;
+
+        if( !from_keyframe.empty() ) {
+            const auto keyframe_file = unified ? filename : keyframe_filename( filename, deltas.keyframe_step );
+            auto keyframe = readCellRanges( keyframe_file, unified, deltas.keyframe_step, from_keyframe, ranges );
+
+            /* The position of a cell in the selection, by binary search in the ranges sorted by begin. */
+            std::vector< std::pair< size_t, size_t > > sorted;
+            std::vector< size_t > offsets;
+            size_t offset = 0;
+            for( size_t r = 0; r < ranges.size(); r++ ) {
+                if( ranges[r].first < ranges[r].second )
+                    sorted.emplace_back( ranges[r].first, r );
+                offsets.push_back( offset );
+                offset += ranges[r].second - ranges[r].first;
+            }
+            std::sort( sorted.begin(), sorted.end() );
+
+            const auto position = [&]( int cell ) -> long {
+                auto it = std::upper_bound( sorted.begin(), sorted.end(), std::make_pair( size_t( cell ), ranges.size() ) );
+                if( it == sorted.begin() )
+                    return -1;
+                const auto r = std::prev( it )->second;
+                if( size_t( cell ) >= ranges[r].second )
+                    return -1;
+                return long( offsets[r] + size_t( cell ) - ranges[r].first );
+            };
+
+            for( const auto& name : from_keyframe ) {
+                auto field = keyframe.find( name );
+                if( field == keyframe.end() )
+                    throw std::runtime_error( "Keyframe report step " + std::to_string( deltas.keyframe_step )
+                                              + " does not contain " + name + " data" );
+
+                applyDelta( file_view, deltas.fields.at( name ), name, numcells, field->second, position );
+                fields[ name ] = std::move( field->second );
+            }
+        }
+
+        /* Lossy encoded fields are decoded in full. */
+        std::map< std::string, std::vector< double > > quantised;
+        restoreQuantisedFields( file_view, keys, quantised );
+        for( auto& field : quantised )
+            if( !fields.count( field.first ) )
+                fields[ field.first ] = gatherRanges( field.second, ranges );
+
+        return restoreSOLUTION( file_view, keys, units, int( num_selected ), std::move( fields ) );
+    }
+
+
 using rt = data::Rates::opt;
 data::Wells restore_wells( const ecl_kw_type * opm_xwel,
                            const ecl_kw_type * opm_iwel,
@@ -147,7 +477,8 @@ data::Wells restore_wells( const ecl_kw_type * opm_xwel,
                            const EclipseGrid& grid,
                            const Schedule& schedule) {
 
-    const auto& sched_wells = schedule.getWells( restart_step );
+    const out::ScheduleSnapshot snapshot( schedule, grid, restart_step );
+    const auto& sched_wells = snapshot.wells();
     std::vector< rt > phases;
     {
         const auto& phase = es.runspec().phases();
@@ -156,17 +487,8 @@ data::Wells restore_wells( const ecl_kw_type * opm_xwel,
         if( phase.active( Phase::GAS ) )   phases.push_back( rt::gas );
     }
 
-    const auto well_size = [&]( size_t acc, const Well* w ) {
-        return acc
-            + 2 + phases.size()
-            + (  w->getCompletions( restart_step ).size()
-              * (phases.size() + data::Completion::restart_size) );
-    };
-
-    const auto expected_xwel_size = std::accumulate( sched_wells.begin(),
-                                                     sched_wells.end(),
-                                                     0,
-                                                     well_size );
+    const int expected_xwel_size = sched_wells.size() * (2 + phases.size())
+        + snapshot.completions().size() * (phases.size() + data::Completion::restart_size);
 
     if( ecl_kw_get_size( opm_xwel ) != expected_xwel_size ) {
         throw std::runtime_error(
@@ -184,8 +506,9 @@ data::Wells restore_wells( const ecl_kw_type * opm_xwel,
     data::Wells wells;
     const double * opm_xwel_data = ecl_kw_get_double_ptr( opm_xwel );
     const int * opm_iwel_data = ecl_kw_get_int_ptr( opm_iwel );
-    for( const auto* sched_well : sched_wells ) {
-        data::Well& well = wells[ sched_well->name() ];
+    const auto& completions = snapshot.completions();
+    for( const auto& info : snapshot.wellInfo() ) {
+        data::Well& well = wells[ info.well->name() ];
 
         well.bhp = *opm_xwel_data++;
         well.temperature = *opm_xwel_data++;
@@ -194,14 +517,14 @@ data::Wells restore_wells( const ecl_kw_type * opm_xwel,
         for( auto phase : phases )
             well.rates.set( phase, *opm_xwel_data++ );
 
-        for( const auto& sc : sched_well->getCompletions( restart_step ) ) {
-            const auto i = sc.getI(), j = sc.getJ(), k = sc.getK();
-            if( !grid.cellActive( i, j, k ) || sc.getState() == WellCompletion::SHUT ) {
+        for( size_t c = info.completion_begin; c < info.completion_end; c++ ) {
+            const auto& sc = completions[c];
+            if( sc.active_index < 0 || sc.shut ) {
                 opm_xwel_data += data::Completion::restart_size + phases.size();
                 continue;
             }
 
-            const auto active_index = grid.activeIndex( i, j, k );
+            const auto active_index = sc.active_index;
 
             well.completions.emplace_back();
             auto& completion = well.completions.back();
@@ -215,6 +538,56 @@ data::Wells restore_wells( const ecl_kw_type * opm_xwel,
 
     return wells;
 }
+
+    /* A restart file opened at the view of a report step. */
+    struct RestartStep {
+        RestartStep( const std::string& filename, int report_step ) :
+            unified( ERT::EclFiletype( filename ) == ECL_UNIFIED_RESTART_FILE ),
+            file( ecl_file_open( filename.c_str(), 0 ) )
+        {
+            if( !file )
+                throw std::runtime_error( "Restart file " + filename + " not found!" );
+
+            if( unified ) {
+                view = ecl_file_get_restart_view( file.get() , -1 , report_step , -1 , -1 );
+                if (!view)
+                    throw std::runtime_error( "Restart file " + filename
+                                              + " does not contain data for report step "
+                                              + std::to_string( report_step ) + "!" );
+            } else
+                view = ecl_file_get_global_view( file.get() );
+        }
+
+        UnitSystem units() const {
+            const ecl_kw_type * intehead = ecl_file_view_iget_named_kw( view , "INTEHEAD", 0 );
+            return UnitSystem( static_cast<ert_ecl_unit_enum>(ecl_kw_iget_int( intehead , INTEHEAD_UNIT_INDEX )));
+        }
+
+        data::Wells wells( int report_step, const EclipseState& es, const EclipseGrid& grid, const Schedule& schedule ) const {
+            const ecl_kw_type * opm_xwel = ecl_file_view_iget_named_kw( view , "OPM_XWEL", 0 );
+            const ecl_kw_type * opm_iwel = ecl_file_view_iget_named_kw( view, "OPM_IWEL", 0 );
+            return restore_wells( opm_xwel, opm_iwel, report_step , es, grid, schedule);
+        }
+
+        void restoreExtra( RestartValue& rst_value, const std::map<std::string, bool>& extra_keys ) const {
+            for (const auto& pair : extra_keys) {
+                const std::string& key = pair.first;
+                bool required = pair.second;
+
+                if (ecl_file_view_has_kw( view , key.c_str())) {
+                    const ecl_kw_type * ecl_kw = ecl_file_view_iget_named_kw( view , key.c_str() , 0 );
+                    const double * data_ptr = ecl_kw_get_double_ptr( ecl_kw );
+                    const double * end_ptr  = data_ptr + ecl_kw_get_size( ecl_kw );
+                    rst_value.extra[ key ] = { data_ptr, end_ptr };
+                } else if (required)
+                    throw std::runtime_error("No such key in file: " + key);
+            }
+        }
+
+        bool unified;
+        ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > file;
+        ecl_file_view_type * view;
+    };
 }
 
 /* should take grid as argument because it may be modified from the simulator */
@@ -226,63 +599,104 @@ RestartValue load( const std::string& filename,
                    const Schedule& schedule,
                    const std::map<std::string, bool>& extra_keys) {
 
-    const bool unified                   = ( ERT::EclFiletype( filename ) == ECL_UNIFIED_RESTART_FILE );
-    ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > file(ecl_file_open( filename.c_str(), 0 ));
-    ecl_file_view_type * file_view;
+    const RestartStep step( filename, report_step );
+    const int numcells = grid.getNumActive( );
+    auto fields = restoreDeltaFields( step.file.get(), step.view, filename, step.unified, keys, numcells );
+    restoreQuantisedFields( step.view, keys, fields );
 
-    if( !file )
-        throw std::runtime_error( "Restart file " + filename + " not found!" );
+    RestartValue rst_value( restoreSOLUTION( step.view, keys, step.units() , numcells, std::move( fields )),
+                            step.wells( report_step, es, grid, schedule ));
 
-    if( unified ) {
-        file_view = ecl_file_get_restart_view( file.get() , -1 , report_step , -1 , -1 );
-        if (!file_view)
-            throw std::runtime_error( "Restart file " + filename
-                                      + " does not contain data for report step "
-                                      + std::to_string( report_step ) + "!" );
-    } else
-        file_view = ecl_file_get_global_view( file.get() );
-
-    const ecl_kw_type * intehead = ecl_file_view_iget_named_kw( file_view , "INTEHEAD", 0 );
-    const ecl_kw_type * opm_xwel = ecl_file_view_iget_named_kw( file_view , "OPM_XWEL", 0 );
-    const ecl_kw_type * opm_iwel = ecl_file_view_iget_named_kw( file_view, "OPM_IWEL", 0 );
-
-    UnitSystem units( static_cast<ert_ecl_unit_enum>(ecl_kw_iget_int( intehead , INTEHEAD_UNIT_INDEX )));
-    RestartValue rst_value( restoreSOLUTION( file_view, keys, units , grid.getNumActive( )),
-                            restore_wells( opm_xwel, opm_iwel, report_step , es, grid, schedule));
+    step.restoreExtra( rst_value, extra_keys );
+    return rst_value;
+}
 
-    for (const auto& pair : extra_keys) {
-        const std::string& key = pair.first;
-        bool required = pair.second;
 
-        if (ecl_file_view_has_kw( file_view , key.c_str())) {
-            const ecl_kw_type * ecl_kw = ecl_file_view_iget_named_kw( file_view , key.c_str() , 0 );
-            const double * data_ptr = ecl_kw_get_double_ptr( ecl_kw );
-            const double * end_ptr  = data_ptr + ecl_kw_get_size( ecl_kw );
-            rst_value.extra[ key ] = { data_ptr, end_ptr };
-        } else if (required)
-            throw std::runtime_error("No such key in file: " + key);
+RestartValue loadCells( const std::string& filename,
+                        int report_step,
+                        const std::map<std::string, RestartKey>& keys,
+                        const std::vector<std::pair<int, int>>& cell_ranges,
+                        const EclipseState& es,
+                        const EclipseGrid& grid,
+                        const Schedule& schedule,
+                        const std::map<std::string, bool>& extra_keys) {
+
+    const int numcells = grid.getNumActive( );
+    CellRanges ranges;
+    for (const auto& range : cell_ranges) {
+        if (range.first < 0 || range.first > range.second || range.second > numcells)
+            throw std::invalid_argument( "Cell range [" + std::to_string( range.first ) + ", "
+                                         + std::to_string( range.second ) + ") is not within the "
+                                         + std::to_string( numcells ) + " active cells" );
+        ranges.emplace_back( range.first, range.second );
+    }
 
+    {
+        auto sorted = ranges;
+        std::sort( sorted.begin(), sorted.end() );
+        size_t end = 0;
+        for (const auto& range : sorted) {
+            if (range.first == range.second)
+                continue;
+            if (range.first < end)
+                throw std::invalid_argument( "The cell ranges overlap" );
+            end = range.second;
+        }
     }
 
+    bool fmt_file = false;
+    int report_nr;
+    ecl_util_get_file_type( filename.c_str(), &fmt_file, &report_nr );
+
+    const RestartStep step( filename, report_step );
+    const auto units = step.units();
+    data::Solution solution;
+    if (fmt_file) {
+        /* Formatted files have no fixed record layout to seek in. */
+        auto fields = restoreDeltaFields( step.file.get(), step.view, filename, step.unified, keys, numcells );
+        restoreQuantisedFields( step.view, keys, fields );
+
+        solution = restoreSOLUTION( step.view, keys, units, numcells, std::move( fields ));
+        for (auto& elm : solution)
+            elm.second.data = gatherRanges( elm.second.data, ranges );
+    } else
+        solution = restoreCells( step.view, filename, step.unified, report_step, keys, units, numcells, ranges );
+
+    RestartValue rst_value( std::move( solution ), step.wells( report_step, es, grid, schedule ));
+    step.restoreExtra( rst_value, extra_keys );
     return rst_value;
 }
 
 
+std::vector<std::pair<int, int>> cellRanges( const std::vector<int>& active_cells ) {
+    std::vector<std::pair<int, int>> ranges;
+    for (const int cell : active_cells) {
+        if (!ranges.empty() && ranges.back().second == cell)
+            ranges.back().second++;
+        else
+            ranges.emplace_back( cell, cell + 1 );
+    }
+
+    return ranges;
+}
+
 
 
 
 namespace {
 
-std::vector<int> serialize_ICON( int report_step,
-                                 int ncwmax,
-                                 const std::vector<const Well*>& sched_wells) {
+void serialize_ICON( const out::ScheduleSnapshot& snapshot, std::vector<int>& data ) {
+
+    const auto& sched_wells = snapshot.wellInfo();
+    const auto& completions = snapshot.completions();
+    const size_t ncwmax = snapshot.maxCompletions();
 
     size_t well_offset = 0;
-    std::vector<int> data( sched_wells.size() * ncwmax * NICONZ , 0 );
-    for (const Well* well : sched_wells) {
-        const auto& completions = well->getCompletions( report_step );
+    data.assign( sched_wells.size() * ncwmax * NICONZ , 0 );
+    for (const auto& well : sched_wells) {
         size_t completion_offset = 0;
-        for( const auto& completion : completions) {
+        for (size_t c = well.completion_begin; c < well.completion_end; c++) {
+            const auto& completion = *completions[c].completion;
             size_t offset = well_offset + completion_offset;
             data[ offset + ICON_IC_INDEX ] = 1;
 
@@ -290,40 +704,34 @@ std::vector<int> serialize_ICON( int report_step,
             data[ offset + ICON_J_INDEX ] = completion.getJ() + 1;
             data[ offset + ICON_K_INDEX ] = completion.getK() + 1;
             data[ offset + ICON_DIRECTION_INDEX ] = completion.getDirection();
-            {
-                const auto open = WellCompletion::StateEnum::OPEN;
-                data[ offset + ICON_STATUS_INDEX ] = completion.getState() == open
-                    ? 1
-                    : 0;
-            }
+            data[ offset + ICON_STATUS_INDEX ] = completions[c].open ? 1 : 0;
 
             completion_offset += NICONZ;
         }
         well_offset += ncwmax * NICONZ;
     }
-    return data;
 }
 
-std::vector<int> serialize_IWEL( size_t step,
-                                 const std::vector<const Well *>& wells) {
+void serialize_IWEL( const out::ScheduleSnapshot& snapshot, std::vector<int>& data ) {
+
+    const size_t step = snapshot.reportStep();
+    const auto& wells = snapshot.wellInfo();
 
-    std::vector<int> data( wells.size() * NIWELZ , 0 );
+    data.assign( wells.size() * NIWELZ , 0 );
     size_t offset = 0;
-    for (const auto well : wells) {
-        const auto& completions = well->getCompletions( step );
+    for (const auto& info : wells) {
+        const auto* well = info.well;
 
         data[ offset + IWEL_HEADI_INDEX ] = well->getHeadI( step ) + 1;
         data[ offset + IWEL_HEADJ_INDEX ] = well->getHeadJ( step ) + 1;
-        data[ offset + IWEL_CONNECTIONS_INDEX ] = completions.size();
+        data[ offset + IWEL_CONNECTIONS_INDEX ] = info.numCompletions();
         data[ offset + IWEL_GROUP_INDEX ] = 1;
 
         data[ offset + IWEL_TYPE_INDEX ] = to_ert_welltype( *well, step );
-        data[ offset + IWEL_STATUS_INDEX ] =
-            well->getStatus( step ) == WellCommon::OPEN ? 1 : 0;
+        data[ offset + IWEL_STATUS_INDEX ] = info.open ? 1 : 0;
 
         offset += NIWELZ;
     }
-    return data;
 }
 
 
@@ -335,24 +743,23 @@ std::vector<int> serialize_IWEL( size_t step,
 
 
 
-std::vector< int > serialize_OPM_IWEL( const data::Wells& wells,
-                                       const std::vector< const Well* >& sched_wells ) {
+void serialize_OPM_IWEL( const data::Wells& wells,
+                         const std::vector< const Well* >& sched_wells,
+                         std::vector< int >& iwel ) {
 
     const auto getctrl = [&]( const Well* w ) {
         const auto itr = wells.find( w->name() );
         return itr == wells.end() ? 0 : itr->second.control;
     };
 
-    std::vector< int > iwel( sched_wells.size(), 0.0 );
+    iwel.resize( sched_wells.size() );
     std::transform( sched_wells.begin(), sched_wells.end(), iwel.begin(), getctrl );
-    return iwel;
 }
 
-std::vector< double > serialize_OPM_XWEL( const data::Wells& wells,
-                                          int report_step,
-                                          const std::vector< const Well* >& sched_wells,
-                                          const Phases& phase_spec,
-                                          const EclipseGrid& grid ) {
+void serialize_OPM_XWEL( const data::Wells& wells,
+                         const out::ScheduleSnapshot& snapshot,
+                         const Phases& phase_spec,
+                         std::vector< double >& xwel ) {
 
     using rt = data::Rates::opt;
 
@@ -361,79 +768,76 @@ std::vector< double > serialize_OPM_XWEL( const data::Wells& wells,
     if( phase_spec.active( Phase::OIL ) )   phases.push_back( rt::oil );
     if( phase_spec.active( Phase::GAS ) )   phases.push_back( rt::gas );
 
-    std::vector< double > xwel;
-    for( const auto* sched_well : sched_wells ) {
+    const auto& completions = snapshot.completions();
+    const auto well_size = 2 /* bhp, temperature */ + phases.size();
+    const auto rs_size = phases.size() + data::Completion::restart_size;
 
-        if( wells.count( sched_well->name() ) == 0 || sched_well->getStatus(report_step) == Opm::WellCommon::SHUT) {
-            const auto elems = (sched_well->getCompletions( report_step ).size()
-                               * (phases.size() + data::Completion::restart_size))
-                + 2 /* bhp, temperature */
-                + phases.size();
+    /* Every slot is written below, or left as zero for missing or shut wells and completions. */
+    xwel.assign( snapshot.wellInfo().size() * well_size + completions.size() * rs_size, 0.0 );
+    CompletionLookup lookup;
 
-            // write zeros if no well data is provided or it is shut
-            xwel.insert( xwel.end(), elems, 0.0 );
+    auto slot = xwel.begin();
+    for( const auto& info : snapshot.wellInfo() ) {
+        const auto* sched_well = info.well;
+        const auto well_data = wells.find( sched_well->name() );
+
+        if( well_data == wells.end() || info.shut ) {
+            slot += well_size + info.numCompletions() * rs_size;
             continue;
         }
 
-        const auto& well = wells.at( sched_well->name() );
+        const auto& well = well_data->second;
 
-        xwel.push_back( well.bhp );
-        xwel.push_back( well.temperature );
+        *slot++ = well.bhp;
+        *slot++ = well.temperature;
         for( auto phase : phases )
-            xwel.push_back( well.rates.get( phase ) );
-
-        for( const auto& sc : sched_well->getCompletions( report_step ) ) {
-            const auto i = sc.getI(), j = sc.getJ(), k = sc.getK();
+            *slot++ = well.rates.get( phase );
 
-            const auto rs_size = phases.size() + data::Completion::restart_size;
-            if( !grid.cellActive( i, j, k ) || sc.getState() == WellCompletion::SHUT ) {
-                xwel.insert( xwel.end(), rs_size, 0.0 );
+        lookup.reset( well );
+        for( size_t c = info.completion_begin; c < info.completion_end; c++, slot += rs_size ) {
+            const auto& sc = completions[c];
+            if( sc.active_index < 0 || sc.shut )
                 continue;
-            }
 
-            const auto active_index = grid.activeIndex( i, j, k );
-            const auto at_index = [=]( const data::Completion& c ) {
-                return c.index == active_index;
-            };
-            const auto& completion = std::find_if( well.completions.begin(),
-                                                   well.completions.end(),
-                                                   at_index );
-
-            if( completion == well.completions.end() ) {
-                xwel.insert( xwel.end(), rs_size, 0.0 );
+            const auto* completion = lookup.find( sc.active_index );
+            if( !completion )
                 continue;
-            }
 
-            xwel.push_back( completion->pressure );
-            xwel.push_back( completion->reservoir_rate );
+            auto value = slot;
+            *value++ = completion->pressure;
+            *value++ = completion->reservoir_rate;
             for( auto phase : phases )
-                xwel.push_back( completion->rates.get( phase ) );
+                *value++ = completion->rates.get( phase );
         }
     }
+}
 
-    return xwel;
-};
 
+/*
+  ZWEL is stored in the layout libecl uses for character keywords, i.e.
+  elements of ecl_type_get_sizeof_ctype( ECL_CHAR ) bytes holding eight
+  blank padded characters and a terminating zero, so that it can be
+  written from the buffer without conversion.
+*/
+void serialize_ZWEL( const std::vector<const Well *>& wells, std::vector<char>& data ) {
+    const size_t element_size = ecl_type_get_sizeof_ctype( ECL_CHAR );
 
-std::vector<const char*> serialize_ZWEL( const std::vector<const Well *>& wells) {
-    std::vector<const char*> data( wells.size( ) * NZWELZ , "");
-    size_t offset = 0;
+    data.assign( wells.size( ) * NZWELZ * element_size , ' ' );
+    for (size_t e = 0; e < wells.size() * NZWELZ; e++)
+        data[ e * element_size + ECL_STRING8_LENGTH ] = '\0';
 
+    size_t offset = 0;
     for (const auto& well : wells) {
-        data[ offset ] = well->name().c_str();
-        offset += NZWELZ;
+        const auto& name = well->name();
+        std::copy_n( name.begin(), std::min( name.size(), size_t( ECL_STRING8_LENGTH ) ), data.begin() + offset );
+        offset += NZWELZ * element_size;
     }
-    return data;
 }
 
 
 
 
 
-template< typename T >
-void write_kw(ecl_rst_file_type * rst_file , ERT::EclKW< T >&& kw) {
-    ecl_rst_file_add_kw( rst_file, kw.get() );
-}
 
 void writeHeader(ecl_rst_file_type * rst_file,
                  int report_step,
@@ -441,7 +845,7 @@ void writeHeader(ecl_rst_file_type * rst_file,
                  double sim_days,
                  int ert_phase_mask,
                  const UnitSystem& units,
-                 const Schedule& schedule,
+                 const out::ScheduleSnapshot& snapshot,
                  const EclipseGrid& grid) {
 
     ecl_rsthead_type rsthead_data = {};
@@ -451,11 +855,11 @@ void writeHeader(ecl_rst_file_type * rst_file,
     rsthead_data.nx          = grid.getNX();
     rsthead_data.ny          = grid.getNY();
     rsthead_data.nz          = grid.getNZ();
-    rsthead_data.nwells      = schedule.numWells(report_step);
+    rsthead_data.nwells      = snapshot.numWells();
     rsthead_data.niwelz      = NIWELZ;
     rsthead_data.nzwelz      = NZWELZ;
     rsthead_data.niconz      = NICONZ;
-    rsthead_data.ncwmax      = schedule.getMaxNumCompletionsForWells(report_step);
+    rsthead_data.ncwmax      = snapshot.maxCompletions();
     rsthead_data.phase_sum   = ert_phase_mask;
     rsthead_data.sim_days    = sim_days;
     rsthead_data.unit_system = units.getEclType( );
@@ -488,18 +892,170 @@ void writeHeader(ecl_rst_file_type * rst_file,
 
 
 
-  void writeSolution(ecl_rst_file_type* rst_file, const data::Solution& solution, bool write_double) {
+  struct SparseDelta {
+      std::vector<int> index;
+      std::vector<double> value;
+  };
+
+  bool same_on_file( double a, double b, bool write_double ) {
+      if (write_double)
+          return std::memcmp( &a, &b, sizeof a ) == 0;
+
+      const float fa = a, fb = b;
+      return std::memcmp( &fa, &fb, sizeof fa ) == 0;
+  }
+
+  /*
+    The deltas of one restart step: on a keyframe step there are none,
+    otherwise the sparse deltas against keyframe_step.
+  */
+  struct DeltaStep {
+      bool keyframe = true;
+      int keyframe_step = -1;
+      std::map<std::string, SparseDelta> deltas;
+  };
+
+  /*
+    The sparse deltas against the keyframe of the solution fields for
+    which the delta is smaller than the full field. The encoder is not
+    changed; commitDeltas() does that once the step has been written.
+  */
+  DeltaStep encodeDeltas(const data::Solution& solution, int report_step, bool write_double, const DeltaEncoder& encoder) {
+      DeltaStep step;
+      step.keyframe = encoder.keyframe_step < 0
+          || report_step <= encoder.keyframe_step
+          || encoder.steps_since_keyframe + 1 >= encoder.keyframe_interval
+          || encoder.write_double != write_double;
+
+      if (step.keyframe)
+          return step;
+
+      step.keyframe_step = encoder.keyframe_step;
+      const size_t element_size = write_double ? sizeof(double) : sizeof(float);
+      for (const auto& elm: solution) {
+          if (elm.second.target != data::TargetType::RESTART_SOLUTION)
+              continue;
+
+          const auto ref = encoder.keyframe.find( elm.first );
+          const auto& data = elm.second.data;
+          if (ref == encoder.keyframe.end() || ref->second.size() != data.size())
+              continue;
+
+          SparseDelta delta;
+          const size_t max_changed = data.size() * element_size / (sizeof(int) + element_size);
+          for (size_t i = 0; i < data.size() && delta.index.size() <= max_changed; i++) {
+              if (!same_on_file( data[i], ref->second[i], write_double )) {
+                  delta.index.push_back( int( i ) );
+                  delta.value.push_back( data[i] );
+              }
+          }
+
+          if (delta.index.size() < max_changed)
+              step.deltas.emplace( elm.first, std::move( delta ) );
+      }
+
+      return step;
+  }
+
+  /*
+    Advance the encoder past a written step; on a keyframe step it takes
+    a copy of the solution fields.
+  */
+  void commitDeltas(const data::Solution& solution, int report_step, bool write_double, const DeltaStep& step, DeltaEncoder& encoder) {
+      if (!step.keyframe) {
+          encoder.steps_since_keyframe++;
+          return;
+      }
+
+      encoder.keyframe.clear();
+      for (const auto& elm: solution)
+          if (elm.second.target == data::TargetType::RESTART_SOLUTION)
+              encoder.keyframe[ elm.first ] = elm.second.data;
+
+      encoder.keyframe_step = report_step;
+      encoder.steps_since_keyframe = 0;
+      encoder.write_double = write_double;
+  }
+
+
+  void writeDeltas(ecl_rst_file_type* rst_file, const std::map<std::string, SparseDelta>& deltas, int keyframe_step, bool write_double) {
+      ERT::ert_unique_ptr< ecl_kw_type, ecl_kw_free > names( ecl_kw_alloc( OPM_DLTA, deltas.size(), ECL_CHAR ) );
+      ERT::ert_unique_ptr< ecl_kw_type, ecl_kw_free > ref( ecl_kw_alloc( OPM_DREF, 1, ECL_INT ) );
+      ecl_kw_iset_int( ref.get(), 0, keyframe_step );
+
+      int n = 0;
+      for (const auto& delta : deltas)
+          ecl_kw_iset_string8( names.get(), n++, delta.first.c_str() );
+
+      ecl_rst_file_add_kw( rst_file, names.get() );
+      ecl_rst_file_add_kw( rst_file, ref.get() );
+
+      n = 0;
+      for (const auto& delta : deltas) {
+          const auto& index = delta.second.index;
+          ERT::ert_unique_ptr< ecl_kw_type, ecl_kw_free > index_kw( ecl_kw_alloc_new( numbered_kw( "OPMDI", n ).c_str(), index.size(), ECL_INT, index.data() ) );
+          ecl_rst_file_add_kw( rst_file, index_kw.get() );
+          ecl_rst_file_add_kw( rst_file, ecl_kw( numbered_kw( "OPMDV", n ), delta.second.value, write_double ).get() );
+          n++;
+      }
+  }
+
+
+  /*
+    Quantise an auxiliary field within the error bound, when that is
+    smaller than the field written in full.
+  */
+  bool quantiseAuxiliary( const std::vector<double>& data, const out::ErrorBound& bound, bool write_double, out::QuantisedField& field ) {
+      const size_t full_size = data.size() * (write_double ? sizeof(double) : sizeof(float));
+      return out::quantise( data.data(), data.size(), bound.absolute( data.data(), data.size() ), field )
+          && field.words.size() * sizeof(int) + 3 * sizeof(double) < full_size;
+  }
+
+
+  void writeQuantised(ecl_rst_file_type* rst_file, const std::vector< std::pair< std::string, out::QuantisedField > >& quantised) {
+      ERT::ert_unique_ptr< ecl_kw_type, ecl_kw_free > names( ecl_kw_alloc( OPM_LOSY, quantised.size(), ECL_CHAR ) );
+      for (size_t n = 0; n < quantised.size(); n++)
+          ecl_kw_iset_string8( names.get(), n, quantised[n].first.c_str() );
+      ecl_rst_file_add_kw( rst_file, names.get() );
+
+      for (size_t n = 0; n < quantised.size(); n++) {
+          const auto& field = quantised[n].second;
+          const double header[] = { field.minimum, field.step, double( field.size ) };
+          ERT::ert_unique_ptr< ecl_kw_type, ecl_kw_free > header_kw( ecl_kw_alloc_new( numbered_kw( "OPMQH", int( n ) ).c_str(), 3, ECL_DOUBLE, header ) );
+          ERT::ert_unique_ptr< ecl_kw_type, ecl_kw_free > words_kw( ecl_kw_alloc_new( numbered_kw( "OPMQD", int( n ) ).c_str(), field.words.size(), ECL_INT, field.words.data() ) );
+          ecl_rst_file_add_kw( rst_file, header_kw.get() );
+          ecl_rst_file_add_kw( rst_file, words_kw.get() );
+      }
+  }
+
+
+  void writeSolution(ecl_rst_file_type* rst_file, const data::Solution& solution, bool write_double, const DeltaStep& delta_step, const AuxiliaryCompression* compression) {
+    const auto& deltas = delta_step.deltas;
+
     ecl_rst_file_start_solution( rst_file );
     for (const auto& elm: solution) {
-        if (elm.second.target == data::TargetType::RESTART_SOLUTION)
+        if (elm.second.target == data::TargetType::RESTART_SOLUTION && !deltas.count( elm.first ))
             ecl_rst_file_add_kw( rst_file , ecl_kw(elm.first, elm.second.data, write_double).get());
      }
      ecl_rst_file_end_solution( rst_file );
 
+     if (!deltas.empty())
+         writeDeltas( rst_file, deltas, delta_step.keyframe_step, write_double );
+
+     std::vector< std::pair< std::string, out::QuantisedField > > quantised;
      for (const auto& elm: solution) {
-        if (elm.second.target == data::TargetType::RESTART_AUXILIARY)
+        if (elm.second.target != data::TargetType::RESTART_AUXILIARY)
+            continue;
+
+        out::QuantisedField field;
+        if (compression && quantiseAuxiliary( elm.second.data, compression->bound( elm.first ), write_double, field ))
+            quantised.emplace_back( elm.first, std::move( field ) );
+        else
             ecl_rst_file_add_kw( rst_file , ecl_kw(elm.first, elm.second.data, write_double).get());
      }
+
+     if (!quantised.empty())
+         writeQuantised( rst_file, quantised );
   }
 
 
@@ -517,29 +1073,47 @@ void writeExtraData(ecl_rst_file_type* rst_file, const std::map<std::string,std:
 
 
 
-void writeWell(ecl_rst_file_type* rst_file, int report_step, const EclipseState& es , const EclipseGrid& grid, const Schedule& schedule, const data::Wells& wells) {
-    const auto sched_wells  = schedule.getWells(report_step);
+/*
+  Write a keyword straight from the buffer; the shared ecl_kw does not
+  copy the data.
+*/
+template< typename T >
+void write_shared_kw( ecl_rst_file_type * rst_file, const char* name, std::vector< T >& data, size_t size, ecl_data_type type ) {
+    ERT::ert_unique_ptr< ecl_kw_type, ecl_kw_free > kw( ecl_kw_alloc_new_shared( name, size, type, data.data() ) );
+    ecl_rst_file_add_kw( rst_file, kw.get() );
+}
+
+void writeWell(ecl_rst_file_type* rst_file, const EclipseState& es , const out::ScheduleSnapshot& snapshot, const data::Wells& wells, WellBuffers& buffers) {
+    const auto& sched_wells  = snapshot.wells();
     const auto& phases = es.runspec().phases();
-    const size_t ncwmax = schedule.getMaxNumCompletionsForWells(report_step);
-
-    const auto opm_xwel  = serialize_OPM_XWEL( wells, report_step, sched_wells, phases, grid );
-    const auto opm_iwel  = serialize_OPM_IWEL( wells, sched_wells );
-    const auto iwel_data = serialize_IWEL(report_step, sched_wells);
-    const auto icon_data = serialize_ICON(report_step , ncwmax, sched_wells);
-    const auto zwel_data = serialize_ZWEL( sched_wells );
-
-    write_kw( rst_file, ERT::EclKW< int >( IWEL_KW, iwel_data) );
-    write_kw( rst_file, ERT::EclKW< const char* >(ZWEL_KW, zwel_data ) );
-    write_kw( rst_file, ERT::EclKW< double >( OPM_XWEL, opm_xwel ) );
-    write_kw( rst_file, ERT::EclKW< int >( OPM_IWEL, opm_iwel ) );
-    write_kw( rst_file, ERT::EclKW< int >( ICON_KW, icon_data ) );
+
+    serialize_OPM_XWEL( wells, snapshot, phases, buffers.opm_xwel );
+    serialize_OPM_IWEL( wells, sched_wells, buffers.opm_iwel );
+    serialize_IWEL( snapshot, buffers.iwel );
+    serialize_ICON( snapshot, buffers.icon );
+    serialize_ZWEL( sched_wells, buffers.zwel );
+
+    write_shared_kw( rst_file, IWEL_KW, buffers.iwel, buffers.iwel.size(), ECL_INT );
+    write_shared_kw( rst_file, ZWEL_KW, buffers.zwel, sched_wells.size() * NZWELZ, ECL_CHAR );
+    write_shared_kw( rst_file, OPM_XWEL, buffers.opm_xwel, buffers.opm_xwel.size(), ECL_DOUBLE );
+    write_shared_kw( rst_file, OPM_IWEL, buffers.opm_iwel, buffers.opm_iwel.size(), ECL_INT );
+    write_shared_kw( rst_file, ICON_KW, buffers.icon, buffers.icon.size(), ECL_INT );
+}
+
+/*
+  Whether key is one of the numbered keywords written by numbered_kw(),
+  e.g. OPMDI001.
+*/
+bool numberedKey(const std::string& key, const char* prefix) {
+    return key.size() == 8 && key.compare( 0, 5, prefix ) == 0
+        && std::all_of( key.begin() + 5, key.end(), []( char c ) { return c >= '0' && c <= '9'; } );
 }
 
 void checkSaveArguments(const data::Solution& cells,
                         const EclipseGrid& grid,
                         const std::map<std::string, std::vector<double>>& extra_data) {
 
-    const std::set<std::string> reserved_keys = {"LOGIHEAD", "INTEHEAD" ,"DOUBHEAD", "IWEL", "XWEL","ICON", "XCON" , "OPM_IWEL" , "OPM_XWEL", "ZWEL"};
+    const std::set<std::string> reserved_keys = {"LOGIHEAD", "INTEHEAD" ,"DOUBHEAD", "IWEL", "XWEL","ICON", "XCON" , "OPM_IWEL" , "OPM_XWEL", "ZWEL", "OPM_DLTA", "OPM_DREF", "OPM_LOSY"};
 
     for (const auto& pair : extra_data) {
         const std::string& key = pair.first;
@@ -549,7 +1123,9 @@ void checkSaveArguments(const data::Solution& cells,
         if (cells.has( key ))
             throw std::runtime_error("The keys used must unique across Solution and extra_data");
 
-        if (reserved_keys.find( key ) != reserved_keys.end())
+        if (reserved_keys.find( key ) != reserved_keys.end()
+            || numberedKey( key, "OPMDI" ) || numberedKey( key, "OPMDV" )
+            || numberedKey( key, "OPMQH" ) || numberedKey( key, "OPMQD" ))
             throw std::runtime_error("The extra_data uses a reserved key");
     }
 
@@ -557,6 +1133,30 @@ void checkSaveArguments(const data::Solution& cells,
         if (elm.second.data.size() != grid.getNumActive())
             throw std::runtime_error("Wrong size on solution vector: " + elm.first);
 }
+
+/*
+  "CASE.X0010" is written as "CASE.tmp.X0010"; libecl derives the file
+  type and format from the extension, which must be kept.
+*/
+std::string temporaryFilename(const std::string& filename) {
+    const auto dot = filename.rfind( '.' );
+    const auto slash = filename.rfind( '/' );
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        throw std::invalid_argument("Restart file name without extension: " + filename);
+
+    return filename.substr( 0, dot ) + ".tmp" + filename.substr( dot );
+}
+
+void syncFile(const std::string& filename) {
+    const int fd = ::open( filename.c_str(), O_RDONLY );
+    if (fd < 0)
+        throw std::runtime_error("Could not open " + filename + ": " + std::strerror( errno ));
+
+    const int status = ::fsync( fd );
+    ::close( fd );
+    if (status < 0)
+        throw std::runtime_error("Could not sync " + filename + ": " + std::strerror( errno ));
+}
 }
 
 
@@ -569,9 +1169,20 @@ void save(const std::string& filename,
           const EclipseGrid& grid,
           const Schedule& schedule,
           std::map<std::string, std::vector<double>> extra_data,
-	  bool write_double)
+	  bool write_double,
+          const SaveOptions& options)
 {
     checkSaveArguments( cells, grid, extra_data );
+
+    const auto* snapshot = options.snapshot;
+    auto* delta = options.delta;
+
+    std::unique_ptr< out::ScheduleSnapshot > local_snapshot;
+    if (!snapshot || snapshot->reportStep() != size_t( report_step )) {
+        local_snapshot.reset( new out::ScheduleSnapshot( schedule, grid, report_step ) );
+        snapshot = local_snapshot.get();
+    }
+
     {
         int ert_phase_mask = es.runspec().eclPhaseMask( );
         const auto& units = es.getUnits();
@@ -579,17 +1190,42 @@ void save(const std::string& filename,
         const auto sim_time = units.from_si( UnitSystem::measure::time, seconds_elapsed );
         ERT::ert_unique_ptr< ecl_rst_file_type, ecl_rst_file_close > rst_file;
 
-        if (ERT::EclFiletype( filename ) == ECL_UNIFIED_RESTART_FILE)
+        const bool unified = ERT::EclFiletype( filename ) == ECL_UNIFIED_RESTART_FILE;
+        const bool renamed = options.rename_into_place && !unified;
+        const auto write_filename = renamed ? temporaryFilename( filename ) : filename;
+        if (unified)
             rst_file.reset( ecl_rst_file_open_write_seek( filename.c_str(), report_step ) );
         else
-            rst_file.reset( ecl_rst_file_open_write( filename.c_str() ) );
-
+            rst_file.reset( ecl_rst_file_open_write( write_filename.c_str() ) );
+
+        DeltaStep delta_step;
+        try {
+            cells.convertFromSI( units );
+            if (delta)
+                delta_step = encodeDeltas( cells, report_step, write_double, *delta );
+
+            writeHeader( rst_file.get() , report_step, posix_time , sim_time, ert_phase_mask, units, *snapshot , grid );
+            WellBuffers local_buffers;
+            writeWell( rst_file.get() , es , *snapshot, wells, options.buffers ? *options.buffers : local_buffers );
+            writeSolution( rst_file.get() , cells , write_double , delta_step , options.compression );
+            writeExtraData( rst_file.get() , extra_data );
+
+            rst_file.reset();
+            if (renamed) {
+                syncFile( write_filename );
+                if (std::rename( write_filename.c_str(), filename.c_str() ) != 0)
+                    throw std::runtime_error( "Could not rename " + write_filename + " to " + filename );
+            }
+        } catch (...) {
+            if (renamed) {
+                rst_file.reset();
+                std::remove( write_filename.c_str() );
+            }
+            throw;
+        }
 
-        cells.convertFromSI( units );
-        writeHeader( rst_file.get() , report_step, posix_time , sim_time, ert_phase_mask, units, schedule , grid );
-        writeWell( rst_file.get() , report_step, es , grid, schedule, wells);
-        writeSolution( rst_file.get() , cells , write_double );
-        writeExtraData( rst_file.get() , extra_data );
+        if (delta)
+            commitDeltas( cells, report_step, write_double, delta_step, *delta );
     }
 }
 }
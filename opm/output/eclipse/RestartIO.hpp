@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <map>
+#include <utility>
 
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
@@ -34,6 +35,7 @@
 #include <opm/output/data/Solution.hpp>
 #include <opm/output/data/Wells.hpp>
 #include <opm/output/eclipse/RestartValue.hpp>
+#include <opm/output/util/LossyCodec.hpp>
 
 #include <ert/ecl/EclKW.hpp>
 #include <ert/ecl/ecl_rsthead.h>
@@ -47,6 +49,10 @@ class EclipseState;
 class Phases;
 class Schedule;
 
+namespace out {
+    class ScheduleSnapshot;
+}
+
 namespace RestartIO {
 
 
@@ -70,7 +76,96 @@ namespace RestartIO {
 
    will read and write to the file "CASE.X0010" - completely ignoring
    the report step argument '99'.
+
+   The optional state and encodings of save() are passed in a
+   SaveOptions object.
+*/
+
+/*
+  Storage for the well arrays of the restart file. The arrays are sized
+  from the schedule snapshot, filled in place and written without an
+  intermediate copy; keeping a WellBuffers object between calls to
+  save() reuses the storage from one report step to the next.
+*/
+struct WellBuffers {
+    std::vector<int> iwel;
+    std::vector<int> icon;
+    std::vector<int> opm_iwel;
+    std::vector<double> opm_xwel;
+    std::vector<char> zwel;
+};
+
+/*
+  Optional delta encoding of the RESTART_SOLUTION fields. Every
+  keyframe_interval'th step saved with the same DeltaEncoder writes the
+  fields in full and becomes the keyframe; in between, a field is
+  written as the indices and values of the cells which differ from the
+  keyframe, in the precision written to file, when that is smaller than
+  the full field. The deltas are stored in the OPM_DLTA, OPM_DREF,
+  OPMDInnn and OPMDVnnn keywords and load() reconstructs the fields
+  from the keyframe step transparently. The encoder only advances when
+  save() has written the step; a failed save leaves it unchanged.
+
+  The keyframe must stay available: for a unified restart file it is an
+  earlier step in the same file, for separate restart files it is the
+  file whose name ends with the four digit keyframe step instead.
+*/
+struct DeltaEncoder {
+    int keyframe_interval = 12;
+
+    int keyframe_step = -1;
+    int steps_since_keyframe = 0;
+    bool write_double = false;
+    std::map<std::string, std::vector<double>> keyframe;
+};
+
+/*
+  Optional lossy encoding of the RESTART_AUXILIARY fields, which are
+  only visualised and never restarted from; RESTART_SOLUTION fields are
+  always written losslessly. An auxiliary field is quantised within the
+  error bound given for its name, or the default bound, and entropy
+  coded, see out::QuantisedField. The fields are encoded after the
+  conversion from SI, so absolute bounds are in the output units of the
+  field, e.g. bars or psi for a pressure, not in SI units. It is stored
+  in the OPM_LOSY, OPMQHnnn and OPMQDnnn keywords, which load() decodes
+  transparently but other readers of restart files do not know about.
+  Fields which can not be encoded within the bound, or would not get
+  smaller, are written in full.
 */
+struct AuxiliaryCompression {
+    out::ErrorBound default_bound;
+    std::map<std::string, out::ErrorBound> fields;
+
+    const out::ErrorBound& bound( const std::string& name ) const {
+        const auto field = fields.find( name );
+        return field == fields.end() ? default_bound : field->second;
+    }
+};
+
+
+/*
+  The optional arguments of save(); all of them are off by default.
+
+  The well data are written from a ScheduleSnapshot of the report step;
+  a caller which already has one can pass it as snapshot, otherwise it
+  is built from the schedule. The well arrays are assembled in buffers,
+  or in temporary buffers if none are given. delta and compression,
+  when given, enable the encodings described above.
+
+  With rename_into_place a separate restart file is written under a
+  temporary name with the same extension, e.g. "CASE.tmp.X0010", synced
+  and renamed to the final name when complete; a crash never leaves a
+  partial file under the final name. A unified restart file is always
+  written in place.
+*/
+struct SaveOptions {
+    const out::ScheduleSnapshot* snapshot = nullptr;
+    WellBuffers* buffers = nullptr;
+    DeltaEncoder* delta = nullptr;
+    const AuxiliaryCompression* compression = nullptr;
+    bool rename_into_place = false;
+};
+
 
 void save(const std::string& filename,
           int report_step,
@@ -81,7 +176,8 @@ void save(const std::string& filename,
           const EclipseGrid& grid,
           const Schedule& schedule,
           std::map<std::string, std::vector<double>> extra_data = {},
-	  bool write_double = false);
+	  bool write_double = false,
+          const SaveOptions& options = SaveOptions());
 
 
 RestartValue load( const std::string& filename,
@@ -92,6 +188,31 @@ RestartValue load( const std::string& filename,
                    const Schedule& schedule,
                    const std::map<std::string, bool>& extra_keys = {});
 
+
+/*
+  Load the solution of a subset of the active cells only, e.g. the
+  partition of one process in a parallel run. The cells are given as
+  half-open ranges [begin, end) of active cell indices which must not
+  overlap, and every solution vector holds the values of these cells in
+  the order of the ranges. From binary restart files only the records
+  holding the ranges are read; formatted files are read in full. The
+  wells and the extra data are loaded as by load().
+*/
+RestartValue loadCells( const std::string& filename,
+                        int report_step,
+                        const std::map<std::string, RestartKey>& keys,
+                        const std::vector<std::pair<int, int>>& cell_ranges,
+                        const EclipseState& es,
+                        const EclipseGrid& grid,
+                        const Schedule& schedule,
+                        const std::map<std::string, bool>& extra_keys = {});
+
+/*
+  The cell ranges of a gather list of active cell indices, for
+  loadCells(): runs of consecutive indices, in the order of the list.
+*/
+std::vector<std::pair<int, int>> cellRanges( const std::vector<int>& active_cells );
+
 }
 }
 #endif
@@ -0,0 +1,129 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Completion.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/CompletionSet.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Well.hpp>
+
+#include <opm/output/eclipse/ScheduleSnapshot.hpp>
+
+#include <algorithm>
+#include <set>
+
+namespace Opm {
+namespace out {
+
+ScheduleSnapshot::ScheduleSnapshot( const Schedule& schedule,
+                                    const EclipseGrid& grid,
+                                    std::size_t report_step_arg ) :
+    report_step( report_step_arg ),
+    well_list( schedule.getWells( report_step_arg ) ),
+    num_wells( schedule.numWells( report_step_arg ) ),
+    max_completions( schedule.getMaxNumCompletionsForWells( report_step_arg ) )
+{
+    const auto step = this->report_step;
+    const auto& group_tree = schedule.getGroupTree( step );
+    std::set< std::string > groups;
+
+    for (const auto* well : this->well_list) {
+        WellInfo info;
+        info.well = well;
+        info.open = well->getStatus( step ) == WellCommon::OPEN;
+        info.shut = well->getStatus( step ) == WellCommon::SHUT;
+        info.rft_active = well->getRFTActive( step );
+        info.plt_active = well->getPLTActive( step );
+        info.completion_begin = this->completion_info.size();
+
+        for (const auto& completion : well->getCompletions( step )) {
+            const auto i = completion.getI(), j = completion.getJ(), k = completion.getK();
+            const int active_index = grid.cellActive( i, j, k ) ? int( grid.activeIndex( i, j, k ) ) : -1;
+
+            this->completion_info.push_back( { &completion,
+                                               active_index,
+                                               completion.getState() == WellCompletion::OPEN,
+                                               completion.getState() == WellCompletion::SHUT } );
+        }
+
+        info.completion_end = this->completion_info.size();
+
+        this->well_index.emplace( well->name(), this->well_info.size() );
+        this->well_info.push_back( info );
+
+        /* The group of the well and all its ancestors. */
+        auto group = well->getGroupName( step );
+        while (schedule.hasGroup( group ) && groups.insert( group ).second)
+            group = group_tree.parent( group );
+    }
+
+    for (const auto& group : groups)
+        this->group_wells.emplace( group, schedule.getWells( group, step ) );
+}
+
+
+std::size_t ScheduleSnapshot::reportStep() const {
+    return this->report_step;
+}
+
+
+const std::vector< const Well* >& ScheduleSnapshot::wells() const {
+    return this->well_list;
+}
+
+
+const std::vector< ScheduleSnapshot::WellInfo >& ScheduleSnapshot::wellInfo() const {
+    return this->well_info;
+}
+
+
+const std::vector< ScheduleSnapshot::CompletionInfo >& ScheduleSnapshot::completions() const {
+    return this->completion_info;
+}
+
+
+const ScheduleSnapshot::WellInfo* ScheduleSnapshot::well( const std::string& name ) const {
+    const auto index = this->well_index.find( name );
+    return index == this->well_index.end() ? nullptr : &this->well_info[ index->second ];
+}
+
+
+const std::vector< const Well* >* ScheduleSnapshot::groupWells( const std::string& group ) const {
+    const auto wells = this->group_wells.find( group );
+    return wells == this->group_wells.end() ? nullptr : &wells->second;
+}
+
+
+std::size_t ScheduleSnapshot::numWells() const {
+    return this->num_wells;
+}
+
+
+std::size_t ScheduleSnapshot::maxCompletions() const {
+    return this->max_completions;
+}
+
+
+bool ScheduleSnapshot::anyRFTActive() const {
+    return std::any_of( this->well_info.begin(), this->well_info.end(),
+                        []( const WellInfo& info ) { return info.rft_active || info.plt_active; } );
+}
+
+}
+}
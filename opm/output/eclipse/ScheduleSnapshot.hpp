@@ -0,0 +1,109 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_SCHEDULE_SNAPSHOT_HPP
+#define OPM_SCHEDULE_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Opm {
+    class Completion;
+    class EclipseGrid;
+    class Schedule;
+    class Well;
+
+namespace out {
+
+    /*
+      The parts of the schedule the output layer needs at one report
+      step, extracted once and shared by the summary, restart and RFT
+      writers: the wells defined at the step with their status and
+      RFT/PLT flags, their completions with the active cell index, and
+      the wells of every group the wells belong to.
+
+      The snapshot refers to the wells and completions of the schedule,
+      which must outlive it. All queries are const and safe to use from
+      several threads.
+    */
+    class ScheduleSnapshot {
+    public:
+        struct CompletionInfo {
+            const Completion* completion;
+            int active_index;           // -1 for completions in inactive cells.
+            bool open;
+            bool shut;
+        };
+
+        struct WellInfo {
+            const Well* well;
+            bool open;
+            bool shut;
+            bool rft_active;
+            bool plt_active;
+
+            /* The completions of the well are completions()[ completion_begin, completion_end ). */
+            std::size_t completion_begin;
+            std::size_t completion_end;
+
+            std::size_t numCompletions() const { return this->completion_end - this->completion_begin; }
+        };
+
+        ScheduleSnapshot( const Schedule& schedule, const EclipseGrid& grid, std::size_t report_step );
+
+        std::size_t reportStep() const;
+
+        /* The wells defined at the report step, in schedule order. */
+        const std::vector< const Well* >& wells() const;
+        const std::vector< WellInfo >& wellInfo() const;
+        const std::vector< CompletionInfo >& completions() const;
+
+        /* Nullptr if no well of that name is defined at the report step. */
+        const WellInfo* well( const std::string& name ) const;
+
+        /*
+          The wells of a group, as Schedule::getWells( group, step ).
+          Only groups which have a well among their descendants are
+          stored; for other groups the result is nullptr.
+        */
+        const std::vector< const Well* >* groupWells( const std::string& group ) const;
+
+        /* The NWELLS and NCWMAX values of the restart header. */
+        std::size_t numWells() const;
+        std::size_t maxCompletions() const;
+
+        bool anyRFTActive() const;
+
+    private:
+        std::size_t report_step;
+        std::vector< const Well* > well_list;
+        std::vector< WellInfo > well_info;
+        std::vector< CompletionInfo > completion_info;
+        std::unordered_map< std::string, std::size_t > well_index;
+        std::unordered_map< std::string, std::vector< const Well* > > group_wells;
+        std::size_t num_wells;
+        std::size_t max_completions;
+    };
+
+}
+}
+
+#endif
@@ -17,10 +17,18 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <opm/parser/eclipse/EclipseState/Eclipse3DProperties.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperty.hpp>
 #include <opm/parser/eclipse/EclipseState/IOConfig/IOConfig.hpp>
@@ -34,9 +42,20 @@
 
 #include <opm/output/eclipse/Summary.hpp>
 #include <opm/output/eclipse/RegionCache.hpp>
-
-#include <ert/ecl/ecl_smspec.h>
+#include <opm/output/eclipse/RegionReduction.hpp>
+#include <opm/output/eclipse/ScheduleSnapshot.hpp>
+#include <opm/output/eclipse/FortranIO.hpp>
+
+#include <ert/ecl/EclFilename.hpp>
+#include <ert/ecl/EclKW.hpp>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_smspec.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
+#include <ert/util/ert_unique_ptr.hpp>
+#include <ert/util/util.h>
 
 /*
  * This class takes simulator state and parser-provided information and
@@ -750,6 +769,16 @@ static const std::unordered_map< std::string, UnitSystem::measure> region_units
   {"RWIP"     , UnitSystem::measure::volume }
 };
 
+/* Solution fields from which block vectors are gathered directly. */
+static const std::unordered_map< std::string, std::string > block_fields = {
+  {"BPR"        , "PRESSURE"},
+  {"BPRESSUR"   , "PRESSURE"},
+  {"BSWAT"      , "SWAT"},
+  {"BWSAT"      , "SWAT"},
+  {"BSGAS"      , "SGAS"},
+  {"BGSAS"      , "SGAS"},
+};
+
 static const std::unordered_map< std::string, UnitSystem::measure> block_units = {
   {"BPR"        , UnitSystem::measure::pressure},
   {"BPRESSUR"   , UnitSystem::measure::pressure},
@@ -760,6 +789,7 @@ static const std::unordered_map< std::string, UnitSystem::measure> block_units =
 };
 
 inline std::vector< const Well* > find_wells( const Schedule& schedule,
+                                              const out::ScheduleSnapshot& snapshot,
                                               const smspec_node_type* node,
                                               size_t timestep,
                                               const out::RegionCache& regionCache ) {
@@ -774,6 +804,9 @@ inline std::vector< const Well* > find_wells( const Schedule& schedule,
     }
 
     if( type == ECL_SMSPEC_GROUP_VAR ) {
+        const auto* group_wells = snapshot.groupWells( name );
+        if( group_wells ) return *group_wells;
+
         if( !schedule.hasGroup( name ) ) return {};
 
         return schedule.getWells( name, timestep );
@@ -811,14 +844,259 @@ namespace out {
 class Summary::keyword_handlers {
     public:
         using fn = ofun;
+
+        /*
+          Output node for a value passed in by the simulator, with the
+          conversion from SI to output units resolved in advance.
+        */
+        struct value_node {
+            smspec_node_type* node;
+            double scale;
+            double offset;
+        };
+
         std::vector< std::pair< smspec_node_type*, fn > > handlers;
-        std::map< std::string, smspec_node_type* > single_value_nodes;
-        std::map< std::pair <std::string, int>, smspec_node_type* > region_nodes;
-        std::map< std::pair <std::string, int>, smspec_node_type* > block_nodes;
 
+        /* Per handler: whether it is evaluated for substeps. */
+        std::vector< bool > substep_evaluated;
 
+        /*
+          Cumulative vectors, indexed by total ordinal: the handler,
+          the rate (output units per second) from the last evaluation
+          and the running total. The rates of a step are evaluated
+          first and then folded into the totals in one pass.
+        */
+        std::vector< size_t > total_handlers;
+        std::vector< double > total_rates;
+        std::vector< double > totals;
+
+        /* The handlers evaluated in the current step, and their values by handler. */
+        std::vector< size_t > pending;
+        std::vector< double > step_values;
+
+        void add_handler( smspec_node_type* node, fn handler ) {
+            if (smspec_node_is_total( node )) {
+                this->total_handlers.push_back( this->handlers.size() );
+                this->total_rates.push_back( 0.0 );
+                this->totals.push_back( 0.0 );
+            }
+
+            this->handlers.emplace_back( node, handler );
+            this->substep_evaluated.push_back( true );
+        }
+        std::vector< value_node > value_nodes;
+        std::map< std::string, size_t > single_value_nodes;
+        std::map< std::pair <std::string, int>, size_t > region_nodes;
+        std::map< std::pair <std::string, int>, size_t > block_nodes;
+        std::vector< double > staged_values;
+
+        /*
+          Block vectors read straight from a solution field: the active
+          cell index and the value handle of every node using the field.
+        */
+        struct block_gather {
+            std::string field;
+            std::vector< size_t > cells;
+            std::vector< size_t > handles;
+        };
+
+        std::vector< block_gather > block_gathers;
+        std::vector< double > gather_buffer;
+
+        void add_block_gather( const std::string& field, size_t active_index, size_t handle ) {
+            auto gather = std::find_if( this->block_gathers.begin(), this->block_gathers.end(),
+                                        [&field]( const block_gather& g ) { return g.field == field; } );
+            if (gather == this->block_gathers.end())
+                gather = this->block_gathers.insert( this->block_gathers.end(), block_gather{ field, {}, {} } );
+
+            gather->cells.push_back( active_index );
+            gather->handles.push_back( handle );
+        }
+
+        size_t add_value_node( smspec_node_type* node, const UnitSystem& units, measure m ) {
+            const double offset = units.from_si( m, 0.0 );
+            const double scale = units.from_si( m, 1.0 ) - offset;
+
+            this->value_nodes.push_back( { node, scale, offset } );
+            return this->value_nodes.size() - 1;
+        }
+
+        template< typename Record >
+        void set( Record& record, size_t handle, double si_value ) const {
+            const auto& vn = this->value_nodes[ handle ];
+            record.set( vn.node, vn.scale * si_value + vn.offset );
+        }
 };
 
+/*
+  Writes the summary records to the UNSMRY file, or to one Snnnn file
+  per report step, as they are added, in the layout libecl uses: a
+  SEQHDR keyword starts every report step, and every record is a
+  MINISTEP and a PARAMS keyword. Only the record being built and the
+  previous record are kept in memory, so the memory use does not grow
+  with the length of the run. The SMSPEC file is written together with
+  the first record.
+
+  The keywords are written asynchronously, in batches, through an
+  AsyncFile; flush() waits until the kernel has completed the writes,
+  but does not sync the file to disk.
+
+  After resume() the records are appended to an existing UNSMRY file,
+  numbered after its last MINISTEP.
+*/
+class Summary::record_stream {
+    public:
+        record_stream( const ecl_sum_type* ecl_sum_arg,
+                       const std::string& basename_arg,
+                       bool formatted_arg,
+                       bool unified_arg ) :
+            ecl_sum( ecl_sum_arg ),
+            basename( basename_arg ),
+            formatted( formatted_arg ),
+            unified( unified_arg )
+        {
+            const auto* smspec = ecl_sum_get_smspec( this->ecl_sum );
+            const auto* defaults = ecl_smspec_get_params_default( smspec );
+
+            this->defaults.assign( defaults, defaults + ecl_smspec_get_params_size( smspec ) );
+            this->current = this->defaults;
+            this->previous = this->defaults;
+
+            if (ecl_smspec_has_general_var( smspec, "TIME" ))
+                this->time_index = smspec_node_get_params_index( ecl_smspec_get_general_var_node( smspec, "TIME" ) );
+        }
+
+        bool has_record() const {
+            return this->ministep > 0;
+        }
+
+        /* Start a new record with the default values. */
+        void begin() {
+            this->previous.swap( this->current );
+            std::copy( this->defaults.begin(), this->defaults.end(), this->current.begin() );
+        }
+
+        void set( const smspec_node_type* node, double value ) {
+            this->current[ smspec_node_get_params_index( node ) ] = value;
+        }
+
+        /* Use the value of the previous record. */
+        void repeat( const smspec_node_type* node ) {
+            const auto index = smspec_node_get_params_index( node );
+            this->current[ index ] = this->previous[ index ];
+        }
+
+        void commit( int report_step, double secs_elapsed ) {
+            if (!this->smspec_written) {
+                ecl_sum_fwrite_smspec( this->ecl_sum );
+                this->smspec_written = true;
+            }
+
+            if (this->time_index >= 0)
+                this->current[ this->time_index ] = secs_elapsed / 86400.0;
+
+            if (!this->file || report_step != this->report_step) {
+                if (!this->unified || !this->file) {
+                    const auto filename = this->unified
+                        ? ERT::EclFilename( this->basename, ECL_UNIFIED_SUMMARY_FILE, this->formatted )
+                        : ERT::EclFilename( this->basename, ECL_SUMMARY_FILE, report_step, this->formatted );
+
+                    if (this->writer)
+                        this->writer->close();
+
+                    const auto mode = this->append
+                        ? out::AsyncFile::Mode::Append
+                        : out::AsyncFile::Mode::Truncate;
+
+                    this->writer.reset();
+                    this->file.reset( new out::AsyncFile( filename, out::AsyncFile::Backend::Automatic, mode ) );
+                    this->append = false;
+                    this->writer.reset( new out::FortranWriter( *this->file, this->formatted ) );
+                }
+
+                const int seqhdr = 0;
+                this->writer->write( SEQHDR_KW, &seqhdr, 1 );
+                this->report_step = report_step;
+            }
+
+            this->writer->write( MINISTEP_KW, &this->ministep, 1 );
+            this->writer->write( PARAMS_KW, this->current.data(), this->current.size() );
+
+            this->ministep += 1;
+        }
+
+        /* The latest record, in PARAMS order. */
+        const std::vector< float >& values() const {
+            return this->current;
+        }
+
+        /* Wait until all records have been written. */
+        void flush() {
+            if (this->file)
+                this->file->flush();
+        }
+
+        /*
+          Continue the UNSMRY file left by an earlier run: the next
+          record is appended to it, and its last record is the previous
+          one. Returns false, and changes nothing, for separate summary
+          files or if there is no UNSMRY file with a record.
+        */
+        bool resume() {
+            if (!this->unified || this->file)
+                return false;
+
+            const std::string filename = ERT::EclFilename( this->basename, ECL_UNIFIED_SUMMARY_FILE, this->formatted );
+            if (!util_file_exists( filename.c_str() ))
+                return false;
+
+            ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > ecl_file( ecl_file_open( filename.c_str(), 0 ) );
+            if (!ecl_file)
+                return false;
+
+            const int records = std::min( ecl_file_get_num_named_kw( ecl_file.get(), MINISTEP_KW ),
+                                          ecl_file_get_num_named_kw( ecl_file.get(), PARAMS_KW ) );
+            if (records == 0)
+                return false;
+
+            const auto* ministep_kw = ecl_file_iget_named_kw( ecl_file.get(), MINISTEP_KW, records - 1 );
+            const auto* params_kw = ecl_file_iget_named_kw( ecl_file.get(), PARAMS_KW, records - 1 );
+            if (std::size_t( ecl_kw_get_size( params_kw ) ) != this->current.size())
+                throw std::runtime_error( "The PARAMS of " + filename + " do not match the SMSPEC" );
+
+            const auto* params = ecl_kw_get_float_ptr( params_kw );
+            std::copy( params, params + this->current.size(), this->current.begin() );
+            this->ministep = ecl_kw_iget_int( ministep_kw, 0 ) + 1;
+            this->append = true;
+            return true;
+        }
+
+    private:
+        const ecl_sum_type* ecl_sum;
+        std::string basename;
+        bool formatted;
+        bool unified;
+
+        std::vector< float > defaults;
+        std::vector< float > current;
+        std::vector< float > previous;
+        int time_index = -1;
+
+        std::unique_ptr< out::AsyncFile > file;
+        std::unique_ptr< out::FortranWriter > writer;
+        int report_step = -1;
+        int ministep = 0;
+        bool smspec_written = false;
+        bool append = false;
+};
+
+constexpr std::size_t Summary::no_handle;
+
+namespace {
+    /* Handlers evaluated per parallel task. */
+    const size_t handlers_per_task = 64;
+}
+
 Summary::Summary( const EclipseState& st,
                   const SummaryConfig& sum ,
                   const EclipseGrid& grid_arg,
@@ -896,7 +1174,8 @@ Summary::Summary( const EclipseState& st,
                                              st.getUnits().name( single_value_pair->second ),
                                              0 );
 
-            this->handlers->single_value_nodes.emplace( keyword, nodeptr );
+            const auto handle = this->handlers->add_value_node( nodeptr, st.getUnits(), single_value_pair->second );
+            this->handlers->single_value_nodes.emplace( keyword, handle );
         } else if (region_pair != region_units.end()) {
 
             auto* nodeptr = ecl_sum_add_var( this->ecl_sum.get(),
@@ -906,7 +1185,8 @@ Summary::Summary( const EclipseState& st,
                                              st.getUnits().name( region_pair->second ),
                                              0 );
 
-            this->handlers->region_nodes.emplace( std::make_pair(keyword, node.num()), nodeptr );
+            const auto handle = this->handlers->add_value_node( nodeptr, st.getUnits(), region_pair->second );
+            this->handlers->region_nodes.emplace( std::make_pair(keyword, node.num()), handle );
 
         } else if (block_pair != block_units.end()) {
             if (node.type() != ECL_SMSPEC_BLOCK_VAR)
@@ -923,7 +1203,12 @@ Summary::Summary( const EclipseState& st,
                                              st.getUnits().name( block_pair->second ),
                                              0 );
 
-            this->handlers->block_nodes.emplace( std::make_pair(keyword, node.num()), nodeptr );
+            const auto handle = this->handlers->add_value_node( nodeptr, st.getUnits(), block_pair->second );
+            this->handlers->block_nodes.emplace( std::make_pair(keyword, node.num()), handle );
+
+            const auto field = block_fields.find( keyword );
+            if (field != block_fields.end())
+                this->handlers->add_block_gather( field->second, this->grid.activeIndex( global_index ), handle );
 
 
 
@@ -956,7 +1241,7 @@ Summary::Summary( const EclipseState& st,
                                              st.getUnits().name( val.unit ),
                                              0 );
 
-            this->handlers->handlers.emplace_back( nodeptr, handle );
+            this->handlers->add_handler( nodeptr, handle );
         } else {
             unsupported_keywords.insert(keyword);
         }
@@ -964,6 +1249,11 @@ Summary::Summary( const EclipseState& st,
     for ( const auto& keyword : unsupported_keywords ) {
         Opm::OpmLog::info("Keyword " + std::string(keyword) + " is unhandled");
     }
+
+    this->stream.reset( new record_stream( this->ecl_sum.get(),
+                                           basename,
+                                           st.getIOConfig().getFMTOUT(),
+                                           st.getIOConfig().getUNIFOUT() ) );
 }
 
 /*
@@ -1026,28 +1316,68 @@ well_efficiency_factors( const smspec_node_type* type,
     return efac;
 }
 
-void Summary::add_timestep( int report_step,
+void Summary::set_thread_pool( ThreadPool& pool_arg ) {
+    this->pool = &pool_arg;
+    this->region_reduction.reset();
+}
+
+void Summary::set_substep_cadence( const SummaryCadence& cadence_arg ) {
+    this->cadence = cadence_arg;
+
+    auto& handlers = this->handlers->handlers;
+    for (size_t i = 0; i < handlers.size(); ++i) {
+        const auto* keyword = smspec_node_get_keyword( handlers[i].first );
+        this->handlers->substep_evaluated[i] = this->cadence.keywords.empty()
+            || this->cadence.keywords.count( keyword ) > 0;
+    }
+}
+
+bool Summary::add_timestep( int report_step,
                             double secs_elapsed,
                             const EclipseState& es,
                             const Schedule& schedule,
                             const data::Wells& wells ,
                             const std::map<std::string, double>& single_values,
                             const std::map<std::string, std::vector<double>>& region_values,
-                            const std::map<std::pair<std::string, int>, double>& block_values) {
+                            const std::map<std::pair<std::string, int>, double>& block_values,
+                            const data::Solution& cells,
+                            bool is_substep,
+                            const ScheduleSnapshot* snapshot) {
 
-    auto* tstep = ecl_sum_add_tstep( this->ecl_sum.get(), report_step, secs_elapsed );
     const double duration = secs_elapsed - this->prev_time_elapsed;
     const size_t timestep = report_step;
 
-    for( auto& f : this->handlers->handlers ) {
+    bool emit = true;
+    if (is_substep) {
+        this->substeps_since_record += 1;
+        emit = (this->cadence.every > 0)
+            && (this->substeps_since_record >= this->cadence.every)
+            && (secs_elapsed - this->prev_record_elapsed >= this->cadence.min_interval);
+    }
+
+    /*
+      Totals are accumulated internally for every call, so that they stay
+      exact also when some substeps are not written.
+    */
+    auto& record = *this->stream;
+    if (emit)
+        record.begin();
+
+    if (!snapshot || snapshot->reportStep() != timestep) {
+        if (!this->snapshot || this->snapshot->reportStep() != timestep)
+            this->snapshot.reset( new ScheduleSnapshot( schedule, this->grid, timestep ) );
+
+        snapshot = this->snapshot.get();
+    }
+
+    const auto evaluate = [&]( const std::pair< smspec_node_type*, ofun >& f, double dt ) {
         const int num = smspec_node_get_num( f.first );
-        const auto* genkey = smspec_node_get_gen_key1( f.first );
 
-        const auto schedule_wells = find_wells( schedule, f.first, timestep, this->regionCache );
+        const auto schedule_wells = find_wells( schedule, *snapshot, f.first, timestep, this->regionCache );
         auto eff_factors = well_efficiency_factors( f.first, schedule, schedule_wells, timestep );
 
         const auto val = f.second( { schedule_wells,
-                                     duration,
+                                     dt,
                                      timestep,
                                      num,
                                      wells,
@@ -1055,59 +1385,286 @@ void Summary::add_timestep( int report_step,
                                      this->grid,
                                      eff_factors});
 
-        const auto unit_applied_val = es.getUnits().from_si( val.unit, val.value );
-        const auto res = smspec_node_is_total( f.first ) && prev_tstep
-            ? ecl_sum_tstep_get_from_key( prev_tstep, genkey ) + unit_applied_val
-            : unit_applied_val;
+        return es.getUnits().from_si( val.unit, val.value );
+    };
+
+    auto& handlers = this->handlers->handlers;
+    const auto repeated = [&]( size_t i ) {
+        return is_substep && !this->handlers->substep_evaluated[i] && record.has_record();
+    };
+
+    /*
+      The handlers only read the wells, the schedule and the region
+      cache, so they are evaluated concurrently into a buffer indexed
+      by handler, and committed in node order afterwards. Every value is
+      computed by a single task, so the result is the same for any
+      number of threads.
+    */
+    auto& pending = this->handlers->pending;
+    auto& values = this->handlers->step_values;
 
-	ecl_sum_tstep_set_from_node( tstep, f.first, res );
+    pending.clear();
+    for (size_t i = 0; i < handlers.size(); ++i) {
+        if (smspec_node_is_total( handlers[i].first ) || (emit && !repeated( i )))
+            pending.push_back( i );
     }
 
-    for( const auto& value_pair : single_values ) {
-        const std::string key = value_pair.first;
-        const auto node_pair = this->handlers->single_value_nodes.find( key );
-        if (node_pair != this->handlers->single_value_nodes.end()) {
-            const auto * nodeptr = node_pair->second;
-            const auto unit = single_values_units.at( key );
-            double si_value = value_pair.second;
-            double output_value = es.getUnits().from_si(unit , si_value );
-            ecl_sum_tstep_set_from_node( tstep, nodeptr , output_value );
+    values.resize( handlers.size() );
+    this->pool->parallelFor( 0, pending.size(), handlers_per_task,
+                             [&]( size_t first, size_t last ) {
+        for (auto p = first; p < last; ++p) {
+            const auto i = pending[p];
+            const bool is_total = smspec_node_is_total( handlers[i].first );
+            values[i] = evaluate( handlers[i], is_total ? 1.0 : duration );
+        }
+    });
+
+    if (emit) {
+        for (size_t i = 0; i < handlers.size(); ++i) {
+            auto& f = handlers[i];
+            if (smspec_node_is_total( f.first ))
+                continue;
+
+            if (repeated( i ))
+                record.repeat( f.first );
+            else
+                record.set( f.first, values[i] );
+        }
+    }
+
+    /*
+      The cumulative vectors are all linear in the step length, so they
+      are evaluated for a unit step and the rates are then scaled and
+      added to the totals in one fused pass.
+    */
+    {
+        auto& total_handlers = this->handlers->total_handlers;
+        auto& rates = this->handlers->total_rates;
+        auto& totals = this->handlers->totals;
+
+        for (size_t k = 0; k < total_handlers.size(); ++k)
+            rates[k] = values[ total_handlers[k] ];
+
+        for (size_t k = 0; k < totals.size(); ++k)
+            totals[k] = std::fma( rates[k], duration, totals[k] );
+
+        if (emit) {
+            for (size_t k = 0; k < totals.size(); ++k)
+                record.set( handlers[ total_handlers[k] ].first, totals[k] );
         }
     }
 
-    for( const auto& value_pair : region_values ) {
-        const std::string key = value_pair.first;
-        for (size_t reg = 0; reg < value_pair.second.size(); ++reg) {
-            const auto node_pair = this->handlers->region_nodes.find( std::make_pair(key, reg+1) );
-            if (node_pair != this->handlers->region_nodes.end()) {
-                const auto * nodeptr = node_pair->second;
-                const auto unit = region_units.at( key );
-                assert (smspec_node_get_num( nodeptr ) - 1 == static_cast<int>(reg));
-                double si_value = value_pair.second[reg];
-                double output_value = es.getUnits().from_si(unit , si_value );
-                ecl_sum_tstep_set_from_node( tstep, nodeptr , output_value );
+    this->prev_time_elapsed = secs_elapsed;
+    if (!emit) {
+        this->handlers->staged_values.clear();
+        return false;
+    }
+
+    const auto& value_handlers = *this->handlers;
+
+    for( const auto& value_pair : single_values ) {
+        const auto node_pair = value_handlers.single_value_nodes.find( value_pair.first );
+        if (node_pair != value_handlers.single_value_nodes.end())
+            value_handlers.set( record, node_pair->second, value_pair.second );
+    }
+
+    const auto set_region_values = [&]( const std::map<std::string, std::vector<double>>& values ) {
+        for( const auto& value_pair : values ) {
+            const std::string& key = value_pair.first;
+
+            /* Region nodes for a keyword are adjacent in the map, in region order. */
+            auto node_pair = value_handlers.region_nodes.lower_bound( std::make_pair(key, std::numeric_limits<int>::min()) );
+            for (; node_pair != value_handlers.region_nodes.end() && node_pair->first.first == key; ++node_pair) {
+                const size_t reg = node_pair->first.second - 1;
+                if (reg < value_pair.second.size())
+                    value_handlers.set( record, node_pair->second, value_pair.second[reg] );
             }
         }
+    };
+
+    /* Region vectors reduced from the solution; explicit region values take precedence. */
+    if (!value_handlers.region_nodes.empty() && !cells.empty()) {
+        if (!this->region_reduction) {
+            const auto& porv_global = es.get3DProperties().getDoubleGridProperty( "PORV" ).getData();
+            this->porv.resize( this->grid.getNumActive() );
+            for (size_t active_index = 0; active_index < this->porv.size(); ++active_index)
+                this->porv[ active_index ] = porv_global[ this->grid.getGlobalIndex( active_index ) ];
+
+            this->region_reduction.reset( new RegionReduction( this->regionCache, "FIPNUM", *this->pool ) );
+        }
+        set_region_values( this->region_reduction->regionValues( cells, this->porv ) );
+    }
+
+    set_region_values( region_values );
+
+    /* One gather per solution field serves all block vectors of that field. */
+    auto& gathered = this->handlers->gather_buffer;
+    for( const auto& gather : value_handlers.block_gathers ) {
+        if (!cells.has( gather.field ))
+            continue;
+
+        const auto& field = cells.data( gather.field );
+        const auto num_nodes = gather.cells.size();
+
+        gathered.resize( num_nodes );
+        for (size_t i = 0; i < num_nodes; ++i)
+            gathered[i] = gather.cells[i] < field.size() ? field[ gather.cells[i] ] : std::nan("");
+
+        for (size_t i = 0; i < num_nodes; ++i) {
+            if (!std::isnan( gathered[i] ))
+                value_handlers.set( record, gather.handles[i], gathered[i] );
+        }
     }
 
     for( const auto& value_pair : block_values ) {
-        const std::pair<std::string, int> key = value_pair.first;
-        const auto node_pair = this->handlers->block_nodes.find( key );
-        if (node_pair != this->handlers->block_nodes.end()) {
-            const auto * nodeptr = node_pair->second;
-            const auto unit = block_units.at( key.first );
-            double si_value = value_pair.second;
-            double output_value = es.getUnits().from_si(unit , si_value );
-            ecl_sum_tstep_set_from_node( tstep, nodeptr , output_value );
+        const auto node_pair = value_handlers.block_nodes.find( value_pair.first );
+        if (node_pair != value_handlers.block_nodes.end())
+            value_handlers.set( record, node_pair->second, value_pair.second );
+    }
+
+    auto& staged = this->handlers->staged_values;
+    for (size_t handle = 0; handle < staged.size(); ++handle) {
+        if (!std::isnan( staged[handle] ))
+            value_handlers.set( record, handle, staged[handle] );
+    }
+    staged.clear();
+
+    record.commit( report_step, secs_elapsed );
+    if (this->history_buffer)
+        this->history_buffer->append( secs_elapsed, report_step, record.values().data() );
+
+    this->prev_record_elapsed = secs_elapsed;
+    this->substeps_since_record = 0;
+
+    return true;
+}
+
+namespace {
+    template< typename Map, typename Key >
+    size_t find_handle( const Map& nodes, const Key& key ) {
+        const auto node_pair = nodes.find( key );
+        return node_pair == nodes.end() ? Summary::no_handle : node_pair->second;
+    }
+}
+
+size_t Summary::single_value_handle( const std::string& keyword ) const {
+    return find_handle( this->handlers->single_value_nodes, keyword );
+}
+
+size_t Summary::region_value_handle( const std::string& keyword, int region ) const {
+    return find_handle( this->handlers->region_nodes, std::make_pair( keyword, region ) );
+}
+
+size_t Summary::block_value_handle( const std::string& keyword, int global_index ) const {
+    return find_handle( this->handlers->block_nodes, std::make_pair( keyword, global_index ) );
+}
+
+size_t Summary::num_value_handles() const {
+    return this->handlers->value_nodes.size();
+}
+
+void Summary::stage_values( const std::vector< double >& values ) {
+    if (values.size() != this->num_value_handles())
+        throw std::invalid_argument("Summary::stage_values(): expected "
+                                    + std::to_string( this->num_value_handles() )
+                                    + " values, got " + std::to_string( values.size() ));
+
+    this->handlers->staged_values = values;
+}
+
+namespace {
+    /* Node key hash, truncated to 52 bits so that it is exact as a double. */
+    double total_key( const smspec_node_type* node ) {
+        const char* key = smspec_node_get_gen_key1( node );
+
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (; *key; ++key) {
+            hash ^= static_cast< unsigned char >( *key );
+            hash *= 1099511628211ULL;
         }
+
+        return static_cast< double >( hash & ((std::uint64_t( 1 ) << 52) - 1) );
     }
+}
 
-    this->prev_tstep = tstep;
-    this->prev_time_elapsed = secs_elapsed;
+const std::string Summary::totals_key = "OPM_SUMT";
+const std::string Summary::totals_names_key = "OPM_SUMK";
+
+std::map< std::string, std::vector< double > > Summary::totals_checkpoint() const {
+    const auto& handlers = this->handlers->handlers;
+    const auto& total_handlers = this->handlers->total_handlers;
+
+    std::vector< double > keys;
+    keys.reserve( total_handlers.size() );
+    for (const auto index : total_handlers)
+        keys.push_back( total_key( handlers[ index ].first ) );
+
+    auto values = this->handlers->totals;
+    values.push_back( this->prev_time_elapsed );
+
+    return { { totals_key, std::move( values ) },
+             { totals_names_key, std::move( keys ) } };
+}
+
+void Summary::restore_totals( const std::map< std::string, std::vector< double > >& checkpoint ) {
+    const auto values = checkpoint.find( totals_key );
+    const auto keys = checkpoint.find( totals_names_key );
+
+    if (values == checkpoint.end() || keys == checkpoint.end())
+        return;
+
+    if (values->second.size() != keys->second.size() + 1)
+        throw std::invalid_argument( "Summary::restore_totals(): the totals checkpoint is inconsistent" );
+
+    std::unordered_map< double, double > saved;
+    for (size_t k = 0; k < keys->second.size(); ++k)
+        saved.emplace( keys->second[k], values->second[k] );
+
+    const auto& handlers = this->handlers->handlers;
+    const auto& total_handlers = this->handlers->total_handlers;
+    auto& totals = this->handlers->totals;
+
+    for (size_t k = 0; k < total_handlers.size(); ++k) {
+        const auto total = saved.find( total_key( handlers[ total_handlers[k] ].first ) );
+        totals[k] = (total == saved.end()) ? 0.0 : total->second;
+    }
+
+    this->prev_time_elapsed = values->second.back();
 }
 
 void Summary::write() {
-    ecl_sum_fwrite( this->ecl_sum.get() );
+    this->stream->flush();
+}
+
+bool Summary::resume() {
+    return this->stream->resume();
+}
+
+const SummaryHistory& Summary::enable_history( std::size_t capacity, const std::string& shm_name ) {
+    /* Readers hold references to the history, so it is never replaced. */
+    if (this->history_buffer)
+        throw std::logic_error( "The summary history is already enabled" );
+
+    const auto* smspec = ecl_sum_get_smspec( this->ecl_sum.get() );
+
+    std::vector< std::string > keys( ecl_smspec_get_params_size( smspec ) );
+    for (int i = 0; i < ecl_smspec_num_nodes( smspec ); ++i) {
+        const auto* node = ecl_smspec_iget_node( smspec, i );
+        const char* key = smspec_node_get_gen_key1( node );
+        if (key)
+            keys[ smspec_node_get_params_index( node ) ] = key;
+    }
+
+    if (shm_name.empty())
+        this->history_buffer.reset( new SummaryHistory( keys, capacity ) );
+    else
+        this->history_buffer.reset( new SummaryHistory( keys, capacity, shm_name ) );
+
+    return *this->history_buffer;
+}
+
+const SummaryHistory* Summary::history() const {
+    return this->history_buffer.get();
 }
 
 Summary::~Summary() {}
@@ -20,6 +20,10 @@
 #ifndef OPM_OUTPUT_SUMMARY_HPP
 #define OPM_OUTPUT_SUMMARY_HPP
 
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -29,8 +33,11 @@
 
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
 
+#include <opm/output/data/Solution.hpp>
 #include <opm/output/data/Wells.hpp>
 #include <opm/output/eclipse/RegionCache.hpp>
+#include <opm/output/eclipse/SummaryHistory.hpp>
+#include <opm/output/util/ThreadPool.hpp>
 
 namespace Opm {
 
@@ -42,34 +49,174 @@ namespace Opm {
 
 namespace out {
 
+class ScheduleSnapshot;
+class RegionReduction;
+
+/*
+  Output cadence for substeps (ministeps). Report steps are always
+  written in full; a substep is written when at least 'every' substeps
+  have passed since the last written record and at least
+  'min_interval' seconds of simulated time have elapsed since then.
+  Setting 'every' to zero suppresses all substep records.
+
+  If 'keywords' is non-empty only those vectors are re-evaluated for
+  substep records; the other vectors repeat the value of the previous
+  record. Cumulative totals are always accumulated exactly, also over
+  substeps which are not written.
+
+  The default writes every substep in full.
+*/
+struct SummaryCadence {
+    std::size_t every = 1;
+    double min_interval = 0.0;
+    std::set< std::string > keywords;
+};
+
 class Summary {
     public:
         Summary( const EclipseState&, const SummaryConfig&, const EclipseGrid&, const Schedule& );
         Summary( const EclipseState&, const SummaryConfig&, const EclipseGrid&, const Schedule&, const std::string& );
         Summary( const EclipseState&, const SummaryConfig&, const EclipseGrid&, const Schedule&, const char* basename );
 
-        void add_timestep(int report_step,
+        /*
+          Returns whether a record was added; with a substep cadence
+          other than the default some substeps are only accumulated.
+
+          The snapshot of the report step, if given, is used for the
+          well lists; otherwise the Summary builds its own.
+
+          Block vectors of PRESSURE, SWAT and SGAS (BPR, BSWAT, BSGAS and
+          their aliases) are gathered from cells, which holds SI values
+          for the active cells, unless they are given in block_values or
+          staged with stage_values(). Likewise the region vectors of
+          RegionReduction::regionValues() are reduced from cells unless
+          they are given in region_values.
+        */
+        bool add_timestep(int report_step,
                            double secs_elapsed,
                            const EclipseState& es,
                            const Schedule& schedule,
                            const data::Wells&,
                            const std::map<std::string, double>& single_values,
                            const std::map<std::string, std::vector<double>>& region_values = {},
-                           const std::map<std::pair<std::string, int>, double>& block_values = {});
-
+                           const std::map<std::pair<std::string, int>, double>& block_values = {},
+                           const data::Solution& cells = {},
+                           bool is_substep = false,
+                           const ScheduleSnapshot* snapshot = nullptr);
+
+        void set_substep_cadence( const SummaryCadence& cadence );
+
+        /*
+          The summary vectors are evaluated concurrently on this pool;
+          by default they are evaluated serially on the calling thread.
+          The output does not depend on the number of threads. The pool
+          must outlive the Summary object.
+        */
+        void set_thread_pool( ThreadPool& pool );
+
+        /*
+          Handles for the values the simulator passes in explicitly,
+          i.e. misc/field values, region values and block values. The
+          handles are stable for the lifetime of the Summary object and
+          index the array given to stage_values(). Vectors which have
+          not been requested in the SUMMARY section, or which are not
+          supported, get the handle no_handle.
+
+          Region vectors are identified by their 1-based region number,
+          and block vectors by their 1-based global cell index, i.e. the
+          same numbers as used in the region_values vectors and the
+          block_values keys of add_timestep().
+        */
+        static constexpr std::size_t no_handle = static_cast<std::size_t>(-1);
+
+        std::size_t single_value_handle( const std::string& keyword ) const;
+        std::size_t region_value_handle( const std::string& keyword, int region ) const;
+        std::size_t block_value_handle( const std::string& keyword, int global_index ) const;
+
+        /* Number of handles; the required size of the staged values. */
+        std::size_t num_value_handles() const;
+
+        /*
+          Stage SI values for the next call to add_timestep(), indexed
+          by handle. The unit conversion factors are resolved when the
+          handles are created, so no string lookups are done per step.
+          NaN entries are ignored; values staged here take precedence
+          over values passed to add_timestep() for the same vector. The
+          staged values are consumed by add_timestep().
+        */
+        void stage_values( const std::vector< double >& values );
+
+        /*
+          Running totals of the cumulative vectors, as extra restart
+          vectors: totals_key holds the totals followed by the elapsed
+          time they cover, and totals_names_key a hash of the key of
+          every vector. Writing these into the
+          restart file and passing them to restore_totals() when the run
+          is restarted continues the totals exactly. Vectors not found
+          in the checkpoint start from zero; a map without the two
+          vectors leaves the totals untouched.
+        */
+        static const std::string totals_key;
+        static const std::string totals_names_key;
+
+        std::map< std::string, std::vector< double > > totals_checkpoint() const;
+        void restore_totals( const std::map< std::string, std::vector< double > >& checkpoint );
+
+        /*
+          Records are appended to the summary files as they are added,
+          and only the latest record is kept in memory; write() flushes
+          the files.
+        */
         void write();
 
+        /*
+          Append to the UNSMRY file of an earlier run of the case,
+          instead of truncating it, e.g. after CommitLog::recover() has
+          cut it back to the last committed report step. The run should
+          continue from that step; the record numbering and the repeated
+          values continue from the last record of the file. Returns
+          false, and the file is truncated as usual, if the summary is
+          not unified or there is no such file, or after the first
+          record. Throws std::runtime_error if the records of the file
+          do not match the summary vectors.
+        */
+        bool resume();
+
+        /*
+          Keep the latest capacity records in memory as well, for
+          queries from other threads while the simulation runs; with a
+          shm_name, e.g. "/CASE-summary", the history is placed in shared
+          memory where other processes can attach() to it. The keys are
+          the ones of the SMSPEC file, with records in PARAMS order.
+          The history lives as long as the Summary object and can only
+          be enabled once; enabling it again throws std::logic_error.
+        */
+        const SummaryHistory& enable_history( std::size_t capacity, const std::string& shm_name = "" );
+
+        /* The history, or nullptr if it is not enabled. */
+        const SummaryHistory* history() const;
+
         ~Summary();
 
     private:
         class keyword_handlers;
+        class record_stream;
 
         const EclipseGrid& grid;
         out::RegionCache regionCache;
         ERT::ert_unique_ptr< ecl_sum_type, ecl_sum_free > ecl_sum;
         std::unique_ptr< keyword_handlers > handlers;
-        const ecl_sum_tstep_type* prev_tstep = nullptr;
+        std::unique_ptr< record_stream > stream;
+        std::unique_ptr< ScheduleSnapshot > snapshot;
+        ThreadPool* pool = &ThreadPool::serial();
+        std::unique_ptr< RegionReduction > region_reduction;
+        std::vector< double > porv;
+        std::unique_ptr< SummaryHistory > history_buffer;
         double prev_time_elapsed = 0;
+
+        SummaryCadence cadence;
+        std::size_t substeps_since_record = 0;
+        double prev_record_elapsed = 0;
 };
 
 }
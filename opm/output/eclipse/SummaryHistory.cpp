@@ -0,0 +1,359 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <opm/output/eclipse/SummaryHistory.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Opm {
+namespace out {
+
+namespace {
+    const char history_magic[8] = { 'O', 'P', 'M', 'S', 'M', 'H', 'S', 'T' };
+    const std::uint32_t history_version = 1;
+
+    /* Keys are stored NUL padded in fixed fields; longer keys are cut. */
+    const std::size_t key_length = 64;
+
+    /* Slots start on cache lines, so the writer and a reader of another slot do not share one. */
+    const std::size_t cache_line = 64;
+
+    std::size_t roundUp( std::size_t size ) {
+        return (size + cache_line - 1) / cache_line * cache_line;
+    }
+
+    std::runtime_error sysError( const std::string& what ) {
+        return std::runtime_error( "Summary history: " + what + ": " + std::strerror( errno ) );
+    }
+
+    std::uint64_t magicWord() {
+        std::uint64_t word;
+        std::memcpy( &word, history_magic, sizeof word );
+        return word;
+    }
+
+    /* The payload is copied through relaxed atomic words, as raw bits. */
+    template< typename Word, typename T >
+    Word toWord( T value ) {
+        static_assert( sizeof( Word ) == sizeof( T ), "word size" );
+        Word word;
+        std::memcpy( &word, &value, sizeof word );
+        return word;
+    }
+
+    template< typename T, typename Word >
+    T fromWord( Word word ) {
+        static_assert( sizeof( Word ) == sizeof( T ), "word size" );
+        T value;
+        std::memcpy( &value, &word, sizeof value );
+        return value;
+    }
+}
+
+/*
+  The shared memory layout is the header, the keys and the slots, each
+  starting on a cache line. The magic is stored last, with release
+  semantics, so a process attaching during initialisation does not
+  accept the history, and one which sees the magic sees the rest of the
+  header and the keys.
+*/
+struct SummaryHistory::Header {
+    std::atomic< std::uint64_t > magic;
+    std::uint32_t version;
+    std::uint32_t key_length;
+    std::uint64_t num_vectors;
+    std::uint64_t capacity;
+    std::atomic< std::uint64_t > count;
+};
+
+/*
+  A slot holds record n when its sequence number is 2n + 2; it is odd
+  while the writer overwrites the slot. The values follow the slot.
+
+  A reader may copy a slot while the writer overwrites it, and discards
+  the copy afterwards. The payload is therefore stored in relaxed atomic
+  words, with the bits of the double and the floats, so that the
+  concurrent copy is not a data race; on common hardware these are
+  plain loads and stores.
+*/
+struct SummaryHistory::Slot {
+    std::atomic< std::uint64_t > sequence;
+    std::atomic< std::uint64_t > secs_elapsed;
+    std::atomic< std::int32_t > report_step;
+    std::int32_t unused;
+
+    std::atomic< std::uint32_t >* values() {
+        return reinterpret_cast< std::atomic< std::uint32_t >* >( this + 1 );
+    }
+};
+
+
+SummaryHistory::SummaryHistory( const std::vector< std::string >& keys, std::size_t capacity_arg ) {
+    this->layout( keys.size(), capacity_arg );
+    this->local.reset( new std::uint64_t[ this->mapped_size / sizeof( std::uint64_t ) ] );
+    this->header = reinterpret_cast< Header* >( this->local.get() );
+    this->initialise( keys, capacity_arg );
+}
+
+
+SummaryHistory::SummaryHistory( const std::vector< std::string >& keys, std::size_t capacity_arg,
+                                const std::string& shm_name_arg ) :
+    shm_name( shm_name_arg )
+{
+    this->layout( keys.size(), capacity_arg );
+
+    /*
+      An existing object is never taken over: it may belong to another
+      simulation which is still running. One left by a crashed run has
+      to be removed, e.g. from /dev/shm, before the name can be reused.
+    */
+    const int fd = ::shm_open( this->shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644 );
+    if (fd < 0 && errno == EEXIST)
+        throw sysError( this->shm_name + " is in use by another history" );
+    if (fd < 0)
+        throw sysError( "could not create " + this->shm_name );
+
+    if (::ftruncate( fd, this->mapped_size ) != 0) {
+        const auto error = sysError( "could not size " + this->shm_name );
+        ::close( fd );
+        ::shm_unlink( this->shm_name.c_str() );
+        throw error;
+    }
+
+    void* base = ::mmap( nullptr, this->mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if (base == MAP_FAILED) {
+        const auto error = sysError( "could not map " + this->shm_name );
+        ::shm_unlink( this->shm_name.c_str() );
+        throw error;
+    }
+
+    this->header = static_cast< Header* >( base );
+    this->initialise( keys, capacity_arg );
+}
+
+
+std::unique_ptr< SummaryHistory > SummaryHistory::attach( const std::string& shm_name ) {
+    const int fd = ::shm_open( shm_name.c_str(), O_RDONLY, 0 );
+    if (fd < 0)
+        throw sysError( "could not open " + shm_name );
+
+    struct stat st;
+    if (::fstat( fd, &st ) != 0 || std::size_t( st.st_size ) < sizeof( Header )) {
+        ::close( fd );
+        throw std::runtime_error( "Summary history: " + shm_name + " is not a summary history" );
+    }
+
+    void* base = ::mmap( nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if (base == MAP_FAILED)
+        throw sysError( "could not map " + shm_name );
+
+    std::unique_ptr< SummaryHistory > history( new SummaryHistory() );
+    history->header = static_cast< Header* >( base );
+    history->mapped_size = st.st_size;
+
+    const auto* header = history->header;
+    if (header->magic.load( std::memory_order_acquire ) != magicWord()
+        || header->version != history_version
+        || header->key_length != key_length)
+        throw std::runtime_error( "Summary history: " + shm_name + " is not a summary history" );
+
+    const auto mapped_size = history->mapped_size;
+    history->layout( header->num_vectors, header->capacity );
+    if (history->mapped_size > mapped_size)
+        throw std::runtime_error( "Summary history: " + shm_name + " is truncated" );
+    history->mapped_size = mapped_size;
+
+    const char* keys = reinterpret_cast< const char* >( base ) + roundUp( sizeof( Header ) );
+    for (std::size_t i = 0; i < header->num_vectors; ++i) {
+        const char* key = keys + i * key_length;
+        history->key_list.emplace_back( key, std::find( key, key + key_length, '\0' ) );
+    }
+
+    return history;
+}
+
+
+SummaryHistory::~SummaryHistory() {
+    if (this->header && !this->local)
+        ::munmap( this->header, this->mapped_size );
+
+    if (this->owner && !this->shm_name.empty())
+        ::shm_unlink( this->shm_name.c_str() );
+}
+
+
+void SummaryHistory::layout( std::size_t num_vectors, std::size_t capacity_arg ) {
+    if (capacity_arg == 0)
+        throw std::invalid_argument( "Summary history: the capacity must be positive" );
+
+    const auto keys_size = roundUp( num_vectors * key_length );
+    this->slot_size = roundUp( sizeof( Slot ) + num_vectors * sizeof( float ) );
+    this->mapped_size = roundUp( sizeof( Header ) ) + keys_size + capacity_arg * this->slot_size;
+    if (this->header)
+        this->slots = reinterpret_cast< char* >( this->header ) + roundUp( sizeof( Header ) ) + keys_size;
+}
+
+
+void SummaryHistory::initialise( const std::vector< std::string >& keys, std::size_t capacity_arg ) {
+    auto* base = reinterpret_cast< char* >( this->header );
+    std::memset( base, 0, this->mapped_size );
+
+    new (this->header) Header();
+    this->header->version = history_version;
+    this->header->key_length = key_length;
+    this->header->num_vectors = keys.size();
+    this->header->capacity = capacity_arg;
+    this->header->count.store( 0, std::memory_order_relaxed );
+
+    char* key_fields = base + roundUp( sizeof( Header ) );
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        this->key_list.push_back( keys[i].substr( 0, key_length - 1 ) );
+        std::memcpy( key_fields + i * key_length, this->key_list.back().data(), this->key_list.back().size() );
+    }
+
+    this->layout( keys.size(), capacity_arg );
+    for (std::size_t n = 0; n < capacity_arg; ++n) {
+        auto* slot = new (this->slot( n )) Slot();
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            new (slot->values() + i) std::atomic< std::uint32_t >( 0 );
+    }
+
+    this->header->magic.store( magicWord(), std::memory_order_release );
+    this->owner = true;
+}
+
+
+SummaryHistory::Slot* SummaryHistory::slot( std::uint64_t n ) const {
+    return reinterpret_cast< Slot* >( this->slots + (n % this->header->capacity) * this->slot_size );
+}
+
+
+void SummaryHistory::append( double secs_elapsed, int report_step, const float* values ) {
+    if (!this->owner)
+        throw std::logic_error( "Summary history: attached histories are read-only" );
+
+    const auto n = this->header->count.load( std::memory_order_relaxed );
+    auto* slot = this->slot( n );
+
+    slot->sequence.store( 2 * n + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    slot->secs_elapsed.store( toWord< std::uint64_t >( secs_elapsed ), std::memory_order_relaxed );
+    slot->report_step.store( report_step, std::memory_order_relaxed );
+    auto* words = slot->values();
+    for (std::size_t i = 0; i < this->key_list.size(); ++i)
+        words[i].store( toWord< std::uint32_t >( values[i] ), std::memory_order_relaxed );
+
+    slot->sequence.store( 2 * n + 2, std::memory_order_release );
+    this->header->count.store( n + 1, std::memory_order_release );
+}
+
+
+const std::vector< std::string >& SummaryHistory::keys() const {
+    return this->key_list;
+}
+
+
+std::size_t SummaryHistory::numVectors() const {
+    return this->key_list.size();
+}
+
+
+std::size_t SummaryHistory::capacity() const {
+    return this->header->capacity;
+}
+
+
+std::size_t SummaryHistory::index( const std::string& key ) const {
+    return std::find( this->key_list.begin(), this->key_list.end(), key ) - this->key_list.begin();
+}
+
+
+std::uint64_t SummaryHistory::records() const {
+    return this->header->count.load( std::memory_order_acquire );
+}
+
+
+bool SummaryHistory::read( std::uint64_t n, double& secs_elapsed, int& report_step,
+                           std::vector< float >& values ) const {
+    if (n >= this->records())
+        return false;
+
+    auto* slot = this->slot( n );
+    const auto sequence = 2 * n + 2;
+    if (slot->sequence.load( std::memory_order_acquire ) != sequence)
+        return false;
+
+    secs_elapsed = fromWord< double >( slot->secs_elapsed.load( std::memory_order_relaxed ) );
+    report_step = slot->report_step.load( std::memory_order_relaxed );
+    const auto* words = slot->values();
+    values.resize( this->key_list.size() );
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = fromWord< float >( words[i].load( std::memory_order_relaxed ) );
+
+    std::atomic_thread_fence( std::memory_order_acquire );
+    return slot->sequence.load( std::memory_order_relaxed ) == sequence;
+}
+
+
+std::size_t SummaryHistory::series( std::size_t vector, std::size_t max,
+                                    std::vector< double >& times,
+                                    std::vector< float >& values ) const {
+    if (vector >= this->key_list.size())
+        throw std::out_of_range( "Summary history: no vector " + std::to_string( vector ) );
+
+    times.clear();
+    values.clear();
+
+    const auto count = this->records();
+    const auto num = std::min< std::uint64_t >( { count, max, this->header->capacity } );
+    for (auto n = count - num; n < count; ++n) {
+        auto* slot = this->slot( n );
+        const auto sequence = 2 * n + 2;
+        if (slot->sequence.load( std::memory_order_acquire ) != sequence)
+            continue;
+
+        const auto time = fromWord< double >( slot->secs_elapsed.load( std::memory_order_relaxed ) );
+        const auto value = fromWord< float >( slot->values()[ vector ].load( std::memory_order_relaxed ) );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if (slot->sequence.load( std::memory_order_relaxed ) != sequence)
+            continue;
+
+        times.push_back( time );
+        values.push_back( value );
+    }
+
+    return times.size();
+}
+
+}
+}
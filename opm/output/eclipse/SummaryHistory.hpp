@@ -0,0 +1,122 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_OUTPUT_SUMMARYHISTORY_HPP
+#define OPM_OUTPUT_SUMMARYHISTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Opm {
+namespace out {
+
+/*
+  The most recent summary records, in a ring buffer of a fixed number
+  of records. Every record holds the elapsed time, the report step and
+  one value of every summary vector, as written to the PARAMS keyword.
+
+  There is one writer, the Summary object, and any number of readers in
+  other threads. Readers never block the writer or each other: every
+  slot of the ring carries a sequence number which the writer makes odd
+  while it overwrites the slot, and a reader discards a record whose
+  sequence number changed while it was copied, i.e. which the writer
+  has overwritten with a newer one.
+
+  The ring can be placed in a POSIX shared memory object, which another
+  process on the same host maps read-only with attach(). The object is
+  created exclusively; if the name exists, e.g. because another
+  simulation uses it, the constructor throws std::runtime_error. The
+  shared memory object is removed when the writing SummaryHistory is
+  destroyed.
+*/
+class SummaryHistory {
+    public:
+        /* A history of capacity records of the vectors with the given keys. */
+        SummaryHistory( const std::vector< std::string >& keys, std::size_t capacity );
+
+        /* As above, in the shared memory object shm_name, e.g. "/CASE-summary". */
+        SummaryHistory( const std::vector< std::string >& keys, std::size_t capacity,
+                        const std::string& shm_name );
+
+        /* A read-only view of the history another process writes to shm_name. */
+        static std::unique_ptr< SummaryHistory > attach( const std::string& shm_name );
+
+        ~SummaryHistory();
+
+        SummaryHistory( const SummaryHistory& ) = delete;
+        SummaryHistory& operator=( const SummaryHistory& ) = delete;
+
+        /* Append a record; values holds numVectors() values. Writer only. */
+        void append( double secs_elapsed, int report_step, const float* values );
+
+        /* The keys of the vectors, like WOPR:OP_1, in PARAMS order. */
+        const std::vector< std::string >& keys() const;
+        std::size_t numVectors() const;
+        std::size_t capacity() const;
+
+        /* Index of the vector with key, or numVectors() if there is none. */
+        std::size_t index( const std::string& key ) const;
+
+        /* The number of records appended so far, including those overwritten. */
+        std::uint64_t records() const;
+
+        /*
+          Copy record number n, counted from zero in the order appended.
+          False if it has not been appended yet or has been overwritten.
+        */
+        bool read( std::uint64_t n, double& secs_elapsed, int& report_step,
+                   std::vector< float >& values ) const;
+
+        /*
+          The latest values of one vector, oldest first: at most max
+          records, fewer if some are overwritten while they are read.
+          Returns the number of records copied.
+        */
+        std::size_t series( std::size_t vector, std::size_t max,
+                            std::vector< double >& times,
+                            std::vector< float >& values ) const;
+
+    private:
+        SummaryHistory() = default;
+
+        struct Header;
+        struct Slot;
+
+        void layout( std::size_t num_vectors, std::size_t capacity );
+        void initialise( const std::vector< std::string >& keys, std::size_t capacity );
+        Slot* slot( std::uint64_t n ) const;
+
+        Header* header = nullptr;
+        char* slots = nullptr;
+        std::size_t slot_size = 0;
+        std::size_t mapped_size = 0;
+
+        std::vector< std::string > key_list;
+        std::unique_ptr< std::uint64_t[] > local;
+        std::string shm_name;
+        bool owner = false;
+};
+
+}
+}
+
+#endif // OPM_OUTPUT_SUMMARYHISTORY_HPP
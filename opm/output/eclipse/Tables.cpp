@@ -20,7 +20,6 @@
 #include <opm/output/eclipse/Tables.hpp>
 
 #include <ert/ecl/FortIO.hpp>
-#include <ert/ecl/EclKW.hpp>
 #include <ert/ecl/ecl_kw_magic.h>
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -35,22 +34,33 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableContainer.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
+#include <opm/output/eclipse/FortranIO.hpp>
 #include <opm/output/eclipse/LinearisedOutputTable.hpp>
+#include <opm/output/util/ThreadPool.hpp>
 
 #include <algorithm>
 #include <array>
 #include <cstddef>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 /// Functions to facilitate generating TAB vector entries for tabulated
 /// saturation functions.
 namespace { namespace SatFunc {
     namespace detail {
+        /// Number of tables built by each task when building a collection
+        /// of saturation function tables in parallel.
+        const std::size_t tablesPerTask = 16;
+
         /// Create linearised, padded TAB vector entries for a collection of
         /// tabulated saturation functions corresponding to a single input
         /// keyword.
         ///
+        /// The entries are appended to the TAB vector and built in place.
+        /// Individual tables are built concurrently, so \p buildDeps must
+        /// be safe to call from multiple threads for distinct table IDs.
+        ///
         /// \tparam BuildDependent Callable entity that extracts the
         ///    independent and primary dependent variates of a single
         ///    saturation function table into a linearised output table.
@@ -68,6 +78,11 @@ namespace { namespace SatFunc {
         ///    of active (used) rows within the sub-table through its return
         ///    value.
         ///
+        /// \param[in,out] tab TAB vector.  On output, the padded tables,
+        ///    including derivatives, are appended.
+        ///
+        /// \param[in] pool Pool on which the individual tables are built.
+        ///
         /// \param[in] numTab Number of tables in this table collection.
         ///
         /// \param[in] numRows Number of rows to allocate for each padded
@@ -84,43 +99,53 @@ namespace { namespace SatFunc {
         ///    protocol outlined for \code BuildDependent::operator()()
         ///    \endcode.  Typically a lambda expression.
         ///
-        /// \return Linearised, padded TAB vector entries for a collection
-        ///    of tabulated saturation functions corresponding to a single
-        ///    input keyword.  Derivatives included as additional columns.
+        /// \return Offset in \p tab of the linearised, padded TAB vector
+        ///    entries for a collection of tabulated saturation functions
+        ///    corresponding to a single input keyword.
         template <class BuildDependent>
-        std::vector<double>
-        createSatfuncTable(const std::size_t numTab,
-                           const std::size_t numRows,
-                           const std::size_t numDep,
-                           BuildDependent&&  buildDeps)
+        std::size_t
+        createSatfuncTable(std::vector<double>& tab,
+                           ::Opm::out::ThreadPool& pool,
+                           const std::size_t    numTab,
+                           const std::size_t    numRows,
+                           const std::size_t    numDep,
+                           BuildDependent&&     buildDeps)
         {
             const auto numPrim = std::size_t{1};
             const auto numCols = 1 + 2*numDep;
 
-            auto descr = ::Opm::DifferentiateOutputTable::Descriptor{};
-            descr.primID = 0 * numPrim;
+            const auto offset = tab.size();
+            tab.resize(offset + numTab*numPrim*numRows*numCols, 1.0e20);
 
             auto linTable = ::Opm::LinearisedOutputTable {
-                numTab, numPrim, numRows, numCols
+                tab, offset, numTab, numPrim, numRows, numCols
             };
 
-            for (descr.tableID = 0*numTab;
-                 descr.tableID < 1*numTab; ++descr.tableID)
+            pool.parallelFor(0, numTab, tablesPerTask,
+                [numDep, &buildDeps, &linTable](const std::size_t first,
+                                                const std::size_t last)
             {
-                descr.numActRows =
-                    buildDeps(descr.tableID, descr.primID, linTable);
-
-                // Derivatives.  Use values already stored in linTable to
-                // take advantage of any unit conversion already applied.
-                // We don't have to do anything special for the units here.
-                //
-                // Note: argument 'descr' implies argument-dependent lookup
-                //    whence we unambiguously invoke function calcSlopes()
-                //    from namespace ::Opm::DifferentiateOutputTable.
-                calcSlopes(numDep, descr, linTable);
-            }
+                auto descr = ::Opm::DifferentiateOutputTable::Descriptor{};
+                descr.primID = 0;
+
+                for (descr.tableID = first; descr.tableID < last; ++descr.tableID) {
+                    descr.numActRows =
+                        buildDeps(descr.tableID, descr.primID, linTable);
+
+                    // Derivatives.  Use values already stored in linTable
+                    // to take advantage of any unit conversion already
+                    // applied.  We don't have to do anything special for
+                    // the units here.
+                    //
+                    // Note: argument 'descr' implies argument-dependent
+                    //    lookup whence we unambiguously invoke function
+                    //    calcSlopes() from namespace
+                    //    ::Opm::DifferentiateOutputTable.
+                    calcSlopes(numDep, descr, linTable);
+                }
+            });
 
-            return linTable.getDataDestructively();
+            return offset;
         }
     } // detail
 
@@ -143,20 +168,27 @@ namespace { namespace SatFunc {
         /// \param[in] sgfn Collection of SGFN tables for all saturation
         ///    regions.
         ///
-        /// \return Linearised and padded 'TAB' vector values for output
-        ///    SGFN tables.  A unit-converted copy of the input table \p
-        ///    sgfn with added derivatives.
-        std::vector<double>
+        /// \param[in,out] tab TAB vector to which the output tables
+        ///    are appended.
+        ///
+        /// \param[in] pool Pool on which the tables are built.
+        ///
+        /// \return Offset in \p tab of linearised and padded 'TAB' vector
+        ///    values for output SGFN tables.  A unit-converted copy of the
+        ///    input table \p sgfn with added derivatives.
+        std::size_t
         fromSGFN(const std::size_t          numRows,
                  const Opm::UnitSystem&     units,
-                 const Opm::TableContainer& sgfn)
+                 const Opm::TableContainer& sgfn,
+                 std::vector<double>&       tab,
+                 ::Opm::out::ThreadPool&    pool)
         {
             using SGFN = ::Opm::SgfnTable;
 
             const auto numTab = sgfn.size();
             const auto numDep = std::size_t{2}; // Krg, Pcgo
 
-            return detail::createSatfuncTable(numTab, numRows, numDep,
+            return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                 [&units, &sgfn](const std::size_t           tableID,
                                 const std::size_t           primID,
                                 Opm::LinearisedOutputTable& linTable)
@@ -218,20 +250,28 @@ namespace { namespace SatFunc {
         /// \param[in] swof Collection of SGOF tables for all saturation
         ///    regions.
         ///
-        /// \return Linearised and padded 'TAB' vector values for output
-        ///    SGFN tables.  Corresponds to unit-converted copies of columns
-        ///    1, 2, and 4--with added derivatives--of the input SGOF tables.
-        std::vector<double>
+        /// \param[in,out] tab TAB vector to which the output tables
+        ///    are appended.
+        ///
+        /// \param[in] pool Pool on which the tables are built.
+        ///
+        /// \return Offset in \p tab of linearised and padded 'TAB' vector
+        ///    values for output SGFN tables.  Corresponds to unit-converted
+        ///    copies of columns 1, 2, and 4--with added derivatives--of the
+        ///    input SGOF tables.
+        std::size_t
         fromSGOF(const std::size_t          numRows,
                  const Opm::UnitSystem&     units,
-                 const Opm::TableContainer& sgof)
+                 const Opm::TableContainer& sgof,
+                 std::vector<double>&       tab,
+                 ::Opm::out::ThreadPool&    pool)
         {
             using SGOF = ::Opm::SgofTable;
 
             const auto numTab = sgof.size();
             const auto numDep = std::size_t{2}; // Krg, Pcgo
 
-            return detail::createSatfuncTable(numTab, numRows, numDep,
+            return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                 [&units, &sgof](const std::size_t           tableID,
                                 const std::size_t           primID,
                                 Opm::LinearisedOutputTable& linTable)
@@ -296,19 +336,27 @@ namespace { namespace SatFunc {
             /// \param[in] sof2 Collection of SOF2 tables for all saturation
             ///   regions.
             ///
-            /// \return Linearised and padded 'TAB' vector values for
-            ///   three-phase SOFN tables.  Essentially just a padded copy
-            ///   of the input SOF2 table--with added derivatives.
-            std::vector<double>
+            /// \param[in,out] tab TAB vector to which the output tables
+            ///    are appended.
+            ///
+            /// \param[in] pool Pool on which the tables are built.
+            ///
+            /// \return Offset in \p tab of linearised and padded 'TAB'
+            ///    vector values for three-phase SOFN tables.  Essentially just
+            ///    a padded copy of the input SOF2 table--with added
+            ///    derivatives.
+            std::size_t
             fromSOF2(const std::size_t          numRows,
-                     const Opm::TableContainer& sof2)
+                     const Opm::TableContainer& sof2,
+                     std::vector<double>&       tab,
+                     ::Opm::out::ThreadPool&    pool)
             {
                 using SOF2 = ::Opm::Sof2Table;
 
                 const auto numTab = sof2.size();
                 const auto numDep = std::size_t{1}; // Kro
 
-                return detail::createSatfuncTable(numTab, numRows, numDep,
+                return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                     [&sof2](const std::size_t           tableID,
                             const std::size_t           primID,
                             Opm::LinearisedOutputTable& linTable)
@@ -353,21 +401,28 @@ namespace { namespace SatFunc {
             /// \param[in] sgof Collection of SGOF tables for all saturation
             ///    regions.
             ///
-            /// \return Linearised and padded 'TAB' vector values for
-            ///    two-phase SOFN tables.  Corresponds to translated (1-Sg),
-            ///    reverse saturation column (column 1) and reverse column
-            ///    of relative permeability for oil (column 3) from the
-            ///    input SGOF table--with added derivatives.
-            std::vector<double>
+            /// \param[in,out] tab TAB vector to which the output tables
+            ///    are appended.
+            ///
+            /// \param[in] pool Pool on which the tables are built.
+            ///
+            /// \return Offset in \p tab of linearised and padded 'TAB'
+            ///    vector values for two-phase SOFN tables.  Corresponds to
+            ///    translated (1-Sg), reverse saturation column (column 1) and
+            ///    reverse column of relative permeability for oil (column 3)
+            ///    from the input SGOF table--with added derivatives.
+            std::size_t
             fromSGOF(const std::size_t          numRows,
-                     const Opm::TableContainer& sgof)
+                     const Opm::TableContainer& sgof,
+                     std::vector<double>&       tab,
+                     ::Opm::out::ThreadPool&    pool)
             {
                 using SGOF = ::Opm::SgofTable;
 
                 const auto numTab = sgof.size();
                 const auto numDep = std::size_t{1}; // Kro
 
-                return detail::createSatfuncTable(numTab, numRows, numDep,
+                return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                     [&sgof](const std::size_t           tableID,
                             const std::size_t           primID,
                             Opm::LinearisedOutputTable& linTable)
@@ -428,21 +483,28 @@ namespace { namespace SatFunc {
             /// \param[in] swof Collection of SWOF tables for all saturation
             ///    regions.
             ///
-            /// \return Linearised and padded 'TAB' vector values for
-            ///    two-phase SOFN tables.  Corresponds to translated (1-Sw),
-            ///    reverse saturation column (column 1) and reverse column
-            ///    of relative permeability for oil (column 3) from the
-            ///    input SWOF table--with added derivatives.
-            std::vector<double>
+            /// \param[in,out] tab TAB vector to which the output tables
+            ///    are appended.
+            ///
+            /// \param[in] pool Pool on which the tables are built.
+            ///
+            /// \return Offset in \p tab of linearised and padded 'TAB'
+            ///    vector values for two-phase SOFN tables.  Corresponds to
+            ///    translated (1-Sw), reverse saturation column (column 1) and
+            ///    reverse column of relative permeability for oil (column 3)
+            ///    from the input SWOF table--with added derivatives.
+            std::size_t
             fromSWOF(const std::size_t          numRows,
-                     const Opm::TableContainer& swof)
+                     const Opm::TableContainer& swof,
+                     std::vector<double>&       tab,
+                     ::Opm::out::ThreadPool&    pool)
             {
                 using SWOF = ::Opm::SwofTable;
 
                 const auto numTab = swof.size();
                 const auto numDep = std::size_t{1}; // Kro
 
-                return detail::createSatfuncTable(numTab, numRows, numDep,
+                return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                     [&swof](const std::size_t           tableID,
                             const std::size_t           primID,
                             Opm::LinearisedOutputTable& linTable)
@@ -726,16 +788,23 @@ namespace { namespace SatFunc {
             /// \param[in] swof Collection of SWOF tables for all saturation
             ///    regions.
             ///
-            /// \return Linearised and padded 'TAB' vector values for
-            ///    three-phase SOFN tables.  Corresponds to column 1 from
-            ///    both of the input SGOF and SWOF tables, as well as column
-            ///    3 from the input SWOF table and column 3 from the input
-            ///    SGOF table--expanded so as to have values for all oil
-            ///    saturation nodes.  Derivatives added in columns 4 and 5.
-            std::vector<double>
+            /// \param[in,out] tab TAB vector to which the output tables
+            ///    are appended.
+            ///
+            /// \param[in] pool Pool on which the tables are built.
+            ///
+            /// \return Offset in \p tab of linearised and padded 'TAB'
+            ///    vector values for three-phase SOFN tables.  Corresponds to
+            ///    column 1 from both of the input SGOF and SWOF tables, as
+            ///    well as column 3 from the input SWOF table and column 3 from
+            ///    the input SGOF table--expanded so as to have values for all
+            ///    oil saturation nodes.  Derivatives added in columns 4 and 5.
+            std::size_t
             fromSGOFandSWOF(const std::size_t          numRows,
                             const Opm::TableContainer& sgof,
-                            const Opm::TableContainer& swof)
+                            const Opm::TableContainer& swof,
+                            std::vector<double>&       tab,
+                            ::Opm::out::ThreadPool&    pool)
             {
                 using SGOF = ::Opm::SgofTable;
                 using SWOF = ::Opm::SwofTable;
@@ -743,7 +812,7 @@ namespace { namespace SatFunc {
                 const auto numTab = sgof.size();
                 const auto numDep = std::size_t{2}; // Krow, Krog
 
-                return detail::createSatfuncTable(numTab, numRows, numDep,
+                return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                      [&sgof, &swof](const std::size_t           tableID,
                                     const std::size_t           primID,
                                     Opm::LinearisedOutputTable& linTable)
@@ -797,19 +866,27 @@ namespace { namespace SatFunc {
             /// \param[in] sof3 Collection of SOF3 tables for all saturation
             ///    regions.
             ///
-            /// \return Linearised and padded 'TAB' vector values for output
-            ///    three-phase SOFN tables.  Essentially a padded copy of
-            ///    the input SOF3 tables, \p sof3, with added derivatives.
-            std::vector<double>
+            /// \param[in,out] tab TAB vector to which the output tables
+            ///    are appended.
+            ///
+            /// \param[in] pool Pool on which the tables are built.
+            ///
+            /// \return Offset in \p tab of linearised and padded 'TAB'
+            ///    vector values for output three-phase SOFN tables.
+            ///    Essentially a padded copy of the input SOF3 tables, \p sof3,
+            ///    with added derivatives.
+            std::size_t
             fromSOF3(const std::size_t          numRows,
-                     const Opm::TableContainer& sof3)
+                     const Opm::TableContainer& sof3,
+                     std::vector<double>&       tab,
+                     ::Opm::out::ThreadPool&    pool)
             {
                 using SOF3 = ::Opm::Sof3Table;
 
                 const auto numTab = sof3.size();
                 const auto numDep = std::size_t{2}; // Krow, Krog
 
-                return detail::createSatfuncTable(numTab, numRows, numDep,
+                return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                     [&sof3](const std::size_t           tableID,
                             const std::size_t           primID,
                             Opm::LinearisedOutputTable& linTable)
@@ -870,20 +947,27 @@ namespace { namespace SatFunc {
         /// \param[in] swfn Collection of SWFN tables for all saturation
         ///    regions.
         ///
-        /// \return Linearised and padded 'TAB' vector values for output
-        ///    SWFN tables.  A unit-converted copy of the input table \p
-        ///    swfn with added derivatives.
-        std::vector<double>
+        /// \param[in,out] tab TAB vector to which the output tables
+        ///    are appended.
+        ///
+        /// \param[in] pool Pool on which the tables are built.
+        ///
+        /// \return Offset in \p tab of linearised and padded 'TAB' vector
+        ///    values for output SWFN tables.  A unit-converted copy of the
+        ///    input table \p swfn with added derivatives.
+        std::size_t
         fromSWFN(const std::size_t          numRows,
                  const Opm::UnitSystem&     units,
-                 const Opm::TableContainer& swfn)
+                 const Opm::TableContainer& swfn,
+                 std::vector<double>&       tab,
+                 ::Opm::out::ThreadPool&    pool)
         {
             using SWFN = ::Opm::SwfnTable;
 
             const auto numTab = swfn.size();
             const auto numDep = std::size_t{2}; // Krw, Pcow
 
-            return detail::createSatfuncTable(numTab, numRows, numDep,
+            return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                 [&swfn, &units](const std::size_t           tableID,
                                 const std::size_t           primID,
                                 Opm::LinearisedOutputTable& linTable)
@@ -945,20 +1029,28 @@ namespace { namespace SatFunc {
         /// \param[in] swof Collection of SWOF tables for all saturation
         ///    regions.
         ///
-        /// \return Linearised and padded 'TAB' vector values for output
-        ///    SWFN tables.  Corresponds to unit-converted copies of columns
-        ///    1, 2, and 4--with added derivatives--of the input SWOF tables.
-        std::vector<double>
+        /// \param[in,out] tab TAB vector to which the output tables
+        ///    are appended.
+        ///
+        /// \param[in] pool Pool on which the tables are built.
+        ///
+        /// \return Offset in \p tab of linearised and padded 'TAB' vector
+        ///    values for output SWFN tables.  Corresponds to unit-converted
+        ///    copies of columns 1, 2, and 4--with added derivatives--of the
+        ///    input SWOF tables.
+        std::size_t
         fromSWOF(const std::size_t          numRows,
                  const Opm::UnitSystem&     units,
-                 const Opm::TableContainer& swof)
+                 const Opm::TableContainer& swof,
+                 std::vector<double>&       tab,
+                 ::Opm::out::ThreadPool&    pool)
         {
             using SWOF = ::Opm::SwofTable;
 
             const auto numTab = swof.size();
             const auto numDep = std::size_t{2}; // Krw, Pcow
 
-            return detail::createSatfuncTable(numTab, numRows, numDep,
+            return detail::createSatfuncTable(tab, pool, numTab, numRows, numDep,
                 [&swof, &units](const std::size_t           tableID,
                                 const std::size_t           primID,
                                 Opm::LinearisedOutputTable& linTable)
@@ -1011,6 +1103,7 @@ namespace Opm {
     Tables::Tables(const UnitSystem& units0)
         : units    (units0)
         , m_tabdims(TABDIMS_SIZE, 0)
+        , pool     (&out::ThreadPool::serial())
     {
         // Initialize subset of base pointers and dimensions to 1 to honour
         // requirements of TABDIMS protocol.  The magic constant 59 is
@@ -1018,13 +1111,36 @@ namespace Opm {
         std::fill_n(std::begin(this->m_tabdims), 59, 1);
     }
 
-    void Tables::addData(const std::size_t          offset_index,
-                         const std::vector<double>& new_data)
+    Tables::Tables(const UnitSystem&   units0,
+                   std::vector<int>    tabdims,
+                   std::vector<double> tab)
+        : units    (units0)
+        , m_tabdims(std::move(tabdims))
+        , data     (std::move(tab))
+        , pool     (&out::ThreadPool::serial())
+    {}
+
+    void Tables::setThreadPool(out::ThreadPool& pool_arg)
+    {
+        this->pool = &pool_arg;
+    }
+
+    std::size_t Tables::allocData(const std::size_t offset_index,
+                                  const std::size_t size,
+                                  const double      fill_value)
     {
-        this->m_tabdims[ offset_index ] = this->data.size() + 1;
+        const auto offset = this->data.size();
 
-        this->data.insert(this->data.end(), new_data.begin(), new_data.end());
+        this->data.resize(offset + size, fill_value);
+        this->setTableOffset(offset_index, offset);
 
+        return offset;
+    }
+
+    void Tables::setTableOffset(const std::size_t offset_index,
+                                const std::size_t offset)
+    {
+        this->m_tabdims[ offset_index ] = offset + 1;
         this->m_tabdims[ TABDIMS_TAB_SIZE_ITEM ] = this->data.size();
     }
 
@@ -1065,46 +1181,48 @@ namespace Opm {
         this->m_tabdims[ TABDIMS_NPPVTO_ITEM ] = dims.inner_size;
 
         {
-            std::vector<double> pvtoData( dims.data_size , default_value );
-            std::vector<double> rs_values( dims.num_tables * dims.outer_size  , default_value );
+            const size_t pvto_offset = this->allocData( TABDIMS_IBPVTO_OFFSET_ITEM , dims.data_size , default_value );
+            const size_t rs_offset = this->allocData( TABDIMS_JBPVTO_OFFSET_ITEM , dims.num_tables * dims.outer_size , default_value );
+            double* pvtoData = this->data.data() + pvto_offset;
+            double* rs_values = this->data.data() + rs_offset;
             size_t composition_stride = dims.inner_size;
             size_t table_stride = dims.outer_size * composition_stride;
             size_t column_stride = table_stride * pvtoTables.size();
-
-            size_t table_index = 0;
-            for (const auto& table : pvtoTables) {
-                size_t composition_index = 0;
-                for (const auto& underSatTable : table) {
-                    const auto& p  = underSatTable.getColumn("P");
-                    const auto& bo = underSatTable.getColumn("BO");
-                    const auto& mu = underSatTable.getColumn("MU");
-
-                    for (size_t row = 0; row < p.size(); row++) {
-                        size_t data_index = row + composition_stride * composition_index + table_stride * table_index;
-
-                        pvtoData[ data_index ]                  = this->units.from_si( UnitSystem::measure::pressure, p[row]);
-                        pvtoData[ data_index + column_stride ]  = 1.0 / bo[row];
-                        pvtoData[ data_index + 2*column_stride] = this->units.from_si( UnitSystem::measure::viscosity , mu[row]) / bo[row];
+            const auto& units = this->units;
+
+            this->pool->parallelFor( 0 , pvtoTables.size() , SatFunc::detail::tablesPerTask ,
+                [&](size_t first, size_t last) {
+                for (size_t table_index = first; table_index < last; table_index++) {
+                    const auto& table = pvtoTables[table_index];
+                    size_t composition_index = 0;
+                    for (const auto& underSatTable : table) {
+                        const auto& p  = underSatTable.getColumn("P");
+                        const auto& bo = underSatTable.getColumn("BO");
+                        const auto& mu = underSatTable.getColumn("MU");
+
+                        for (size_t row = 0; row < p.size(); row++) {
+                            size_t data_index = row + composition_stride * composition_index + table_stride * table_index;
+
+                            pvtoData[ data_index ]                  = units.from_si( UnitSystem::measure::pressure, p[row]);
+                            pvtoData[ data_index + column_stride ]  = 1.0 / bo[row];
+                            pvtoData[ data_index + 2*column_stride] = units.from_si( UnitSystem::measure::viscosity , mu[row]) / bo[row];
+                        }
+                        composition_index++;
                     }
-                    composition_index++;
-                }
 
-                /*
-                  The RS values which apply for one inner table each
-                  are added as a separate data vector to the TABS
-                  array.
-                */
-                {
-                    const auto& sat_table = table.getSaturatedTable();
-                    const auto& rs = sat_table.getColumn("RS");
-                    for (size_t index = 0; index < rs.size(); index++)
-                        rs_values[index + table_index * dims.outer_size ] = rs[index];
+                    /*
+                      The RS values which apply for one inner table each
+                      are added as a separate data vector to the TABS
+                      array.
+                    */
+                    {
+                        const auto& sat_table = table.getSaturatedTable();
+                        const auto& rs = sat_table.getColumn("RS");
+                        for (size_t index = 0; index < rs.size(); index++)
+                            rs_values[index + table_index * dims.outer_size ] = rs[index];
+                    }
                 }
-                table_index++;
-            }
-
-            this->addData( TABDIMS_IBPVTO_OFFSET_ITEM , pvtoData );
-            this->addData( TABDIMS_JBPVTO_OFFSET_ITEM , rs_values );
+            });
         }
     }
 
@@ -1116,44 +1234,45 @@ namespace Opm {
         this->m_tabdims[ TABDIMS_NPPVTG_ITEM ] = dims.inner_size;
 
         {
-            std::vector<double> pvtgData( dims.data_size , default_value );
-            std::vector<double> p_values( dims.num_tables * dims.outer_size  , default_value );
+            const size_t pvtg_offset = this->allocData( TABDIMS_IBPVTG_OFFSET_ITEM , dims.data_size , default_value );
+            const size_t p_offset = this->allocData( TABDIMS_JBPVTG_OFFSET_ITEM , dims.num_tables * dims.outer_size , default_value );
+            double* pvtgData = this->data.data() + pvtg_offset;
+            double* p_values = this->data.data() + p_offset;
             size_t composition_stride = dims.inner_size;
             size_t table_stride = dims.outer_size * composition_stride;
             size_t column_stride = table_stride * dims.num_tables;
-
-            size_t table_index = 0;
-            for (const auto& table : pvtgTables) {
-                size_t composition_index = 0;
-                for (const auto& underSatTable : table) {
-                    const auto& col0 = underSatTable.getColumn(0);
-                    const auto& col1 = underSatTable.getColumn(1);
-                    const auto& col2 = underSatTable.getColumn(2);
-
-                    for (size_t row = 0; row < col0.size(); row++) {
-                        size_t data_index = row + composition_stride * composition_index + table_stride * table_index;
-
-                        pvtgData[ data_index ]                  = this->units.from_si( UnitSystem::measure::gas_oil_ratio, col0[row]);
-                        pvtgData[ data_index + column_stride ]  = this->units.from_si( UnitSystem::measure::gas_oil_ratio, col1[row]);
-                        pvtgData[ data_index + 2*column_stride] = this->units.from_si( UnitSystem::measure::viscosity , col2[row]);
+            const auto& units = this->units;
+
+            this->pool->parallelFor( 0 , pvtgTables.size() , SatFunc::detail::tablesPerTask ,
+                [&](size_t first, size_t last) {
+                for (size_t table_index = first; table_index < last; table_index++) {
+                    const auto& table = pvtgTables[table_index];
+                    size_t composition_index = 0;
+                    for (const auto& underSatTable : table) {
+                        const auto& col0 = underSatTable.getColumn(0);
+                        const auto& col1 = underSatTable.getColumn(1);
+                        const auto& col2 = underSatTable.getColumn(2);
+
+                        for (size_t row = 0; row < col0.size(); row++) {
+                            size_t data_index = row + composition_stride * composition_index + table_stride * table_index;
+
+                            pvtgData[ data_index ]                  = units.from_si( UnitSystem::measure::gas_oil_ratio, col0[row]);
+                            pvtgData[ data_index + column_stride ]  = units.from_si( UnitSystem::measure::gas_oil_ratio, col1[row]);
+                            pvtgData[ data_index + 2*column_stride] = units.from_si( UnitSystem::measure::viscosity , col2[row]);
+                        }
+
+                        composition_index++;
                     }
 
-                    composition_index++;
-                }
-
-                {
-                    const auto& sat_table = table.getSaturatedTable();
-                    const auto& p = sat_table.getColumn("PG");
-                    for (size_t index = 0; index < p.size(); index++)
-                        p_values[index + table_index * dims.outer_size ] =
-                            this->units.from_si( UnitSystem::measure::pressure , p[index]);
+                    {
+                        const auto& sat_table = table.getSaturatedTable();
+                        const auto& p = sat_table.getColumn("PG");
+                        for (size_t index = 0; index < p.size(); index++)
+                            p_values[index + table_index * dims.outer_size ] =
+                                units.from_si( UnitSystem::measure::pressure , p[index]);
+                    }
                 }
-
-                table_index++;
-            }
-
-            this->addData( TABDIMS_IBPVTG_OFFSET_ITEM , pvtgData );
-            this->addData( TABDIMS_JBPVTG_OFFSET_ITEM , p_values );
+            });
         }
     }
 
@@ -1162,7 +1281,8 @@ namespace Opm {
         if (pvtwTable.size() > 0) {
             const double default_value = -2e20;
             const size_t num_columns = pvtwTable[0].size;
-            std::vector<double> pvtwData( pvtwTable.size() * num_columns , default_value);
+            const size_t offset = this->allocData( TABDIMS_IBPVTW_OFFSET_ITEM , pvtwTable.size() * num_columns , default_value );
+            double* pvtwData = this->data.data() + offset;
 
             this->m_tabdims[ TABDIMS_NTPVTW_ITEM ] = pvtwTable.size();
             for (size_t table_num = 0; table_num < pvtwTable.size(); table_num++) {
@@ -1180,7 +1300,6 @@ namespace Opm {
 
                 // pvtwData[ table_num * num_columns + 4] = record.viscosibility;
             }
-            this->addData( TABDIMS_IBPVTW_OFFSET_ITEM , pvtwData );
         }
     }
 
@@ -1189,7 +1308,8 @@ namespace Opm {
         if (density.size() > 0) {
             const double default_value = -2e20;
             const size_t num_columns = density[0].size;
-            std::vector<double> densityData( density.size() * num_columns , default_value);
+            const size_t offset = this->allocData( TABDIMS_IBDENS_OFFSET_ITEM , density.size() * num_columns , default_value );
+            double* densityData = this->data.data() + offset;
 
             this->m_tabdims[ TABDIMS_NTDENS_ITEM ] = density.size();
             for (size_t table_num = 0; table_num < density.size(); table_num++) {
@@ -1198,7 +1318,6 @@ namespace Opm {
                 densityData[ table_num * num_columns + 1] = this->units.from_si( UnitSystem::measure::density , record.water);
                 densityData[ table_num * num_columns + 2] = this->units.from_si( UnitSystem::measure::density , record.gas);
             }
-            this->addData( TABDIMS_IBDENS_OFFSET_ITEM , densityData );
         }
     }
 
@@ -1257,9 +1376,9 @@ namespace Opm {
             const auto& tables = tabMgr.getSgofTables();
 
             const auto sgfn =
-                SatFunc::Gas::fromSGOF(nssfun, this->units, tables);
+                SatFunc::Gas::fromSGOF(nssfun, this->units, tables, this->data, *this->pool);
 
-            this->addData(TABDIMS_IBSGFN_OFFSET_ITEM, sgfn);
+            this->setTableOffset(TABDIMS_IBSGFN_OFFSET_ITEM, sgfn);
             this->m_tabdims[TABDIMS_NSSGFN_ITEM] = nssfun;
             this->m_tabdims[TABDIMS_NTSGFN_ITEM] = tables.size();
         }
@@ -1269,9 +1388,9 @@ namespace Opm {
                 const auto& tables = tabMgr.getSgofTables();
 
                 const auto sofn =
-                    SatFunc::Oil::TwoPhase::fromSGOF(nssfun, tables);
+                    SatFunc::Oil::TwoPhase::fromSGOF(nssfun, tables, this->data, *this->pool);
 
-                this->addData(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
+                this->setTableOffset(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
                 this->m_tabdims[TABDIMS_NSSOFN_ITEM] = nssfun;
                 this->m_tabdims[TABDIMS_NTSOFN_ITEM] = tables.size();
             }
@@ -1279,9 +1398,9 @@ namespace Opm {
                 const auto& tables = tabMgr.getSwofTables();
 
                 const auto sofn =
-                    SatFunc::Oil::TwoPhase::fromSWOF(nssfun, tables);
+                    SatFunc::Oil::TwoPhase::fromSWOF(nssfun, tables, this->data, *this->pool);
 
-                this->addData(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
+                this->setTableOffset(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
                 this->m_tabdims[TABDIMS_NSSOFN_ITEM] = nssfun;
                 this->m_tabdims[TABDIMS_NTSOFN_ITEM] = tables.size();
             }
@@ -1294,9 +1413,9 @@ namespace Opm {
                 const auto numRows = 2 * nssfun;
 
                 const auto sofn = SatFunc::Oil::ThreePhase::
-                    fromSGOFandSWOF(numRows, sgof, swof);
+                    fromSGOFandSWOF(numRows, sgof, swof, this->data, *this->pool);
 
-                this->addData(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
+                this->setTableOffset(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
                 this->m_tabdims[TABDIMS_NSSOFN_ITEM] = numRows;
                 this->m_tabdims[TABDIMS_NTSOFN_ITEM] = sgof.size();
             }
@@ -1306,9 +1425,9 @@ namespace Opm {
             const auto& tables = tabMgr.getSwofTables();
 
             const auto swfn =
-                SatFunc::Water::fromSWOF(nssfun, this->units, tables);
+                SatFunc::Water::fromSWOF(nssfun, this->units, tables, this->data, *this->pool);
 
-            this->addData(TABDIMS_IBSWFN_OFFSET_ITEM, swfn);
+            this->setTableOffset(TABDIMS_IBSWFN_OFFSET_ITEM, swfn);
             this->m_tabdims[TABDIMS_NSSWFN_ITEM] = nssfun;
             this->m_tabdims[TABDIMS_NTSWFN_ITEM] = tables.size();
         }
@@ -1327,9 +1446,9 @@ namespace Opm {
             const auto& tables = tabMgr.getSgfnTables();
 
             const auto sgfn =
-                SatFunc::Gas::fromSGFN(nssfun, this->units, tables);
+                SatFunc::Gas::fromSGFN(nssfun, this->units, tables, this->data, *this->pool);
 
-            this->addData(TABDIMS_IBSGFN_OFFSET_ITEM, sgfn);
+            this->setTableOffset(TABDIMS_IBSGFN_OFFSET_ITEM, sgfn);
             this->m_tabdims[TABDIMS_NSSGFN_ITEM] = nssfun;
             this->m_tabdims[TABDIMS_NTSGFN_ITEM] = tables.size();
         }
@@ -1339,9 +1458,9 @@ namespace Opm {
                 const auto& tables = tabMgr.getSof2Tables();
 
                 const auto sofn =
-                    SatFunc::Oil::TwoPhase::fromSOF2(nssfun, tables);
+                    SatFunc::Oil::TwoPhase::fromSOF2(nssfun, tables, this->data, *this->pool);
 
-                this->addData(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
+                this->setTableOffset(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
                 this->m_tabdims[TABDIMS_NSSOFN_ITEM] = nssfun;
                 this->m_tabdims[TABDIMS_NTSOFN_ITEM] = tables.size();
             }
@@ -1349,9 +1468,9 @@ namespace Opm {
                 const auto& tables = tabMgr.getSof3Tables();
 
                 const auto sofn =
-                    SatFunc::Oil::ThreePhase::fromSOF3(nssfun, tables);
+                    SatFunc::Oil::ThreePhase::fromSOF3(nssfun, tables, this->data, *this->pool);
 
-                this->addData(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
+                this->setTableOffset(TABDIMS_IBSOFN_OFFSET_ITEM, sofn);
                 this->m_tabdims[TABDIMS_NSSOFN_ITEM] = nssfun;
                 this->m_tabdims[TABDIMS_NTSOFN_ITEM] = tables.size();
             }
@@ -1361,9 +1480,9 @@ namespace Opm {
             const auto& tables = tabMgr.getSwfnTables();
 
             const auto swfn =
-                SatFunc::Water::fromSWFN(nssfun, this->units, tables);
+                SatFunc::Water::fromSWFN(nssfun, this->units, tables, this->data, *this->pool);
 
-            this->addData(TABDIMS_IBSWFN_OFFSET_ITEM, swfn);
+            this->setTableOffset(TABDIMS_IBSWFN_OFFSET_ITEM, swfn);
             this->m_tabdims[TABDIMS_NSSWFN_ITEM] = nssfun;
             this->m_tabdims[TABDIMS_NTSWFN_ITEM] = tables.size();
         }
@@ -1372,14 +1491,9 @@ namespace Opm {
     void fwrite(const Tables& tables,
                 ERT::FortIO&  fortio)
     {
-        {
-            ERT::EclKW<int> tabdims("TABDIMS", tables.tabdims());
-            tabdims.fwrite(fortio);
-        }
+        out::FortranWriter writer(fortio.get());
 
-        {
-            ERT::EclKW<double> tab("TAB", tables.tab());
-            tab.fwrite(fortio);
-        }
+        writer.write("TABDIMS", tables.tabdims());
+        writer.write("TAB", tables.tab());
     }
 }
@@ -33,10 +33,20 @@ namespace Opm {
     class UnitSystem;
     class EclipseState;
 
+    namespace out {
+        class ThreadPool;
+    }
+
     class Tables {
     public:
         explicit Tables( const UnitSystem& units);
 
+        /// Wrap ready-made TABDIMS and TAB vectors, typically retrieved
+        /// from a \c TablesCache, for output through fwrite().
+        Tables(const UnitSystem&   units,
+               std::vector<int>    tabdims,
+               std::vector<double> tab);
+
         void addPVTO(const std::vector<PvtoTable>& pvtoTables);
         void addPVTG(const std::vector<PvtgTable>& pvtgTables);
         void addPVTW(const PvtwTable& pvtwTable);
@@ -49,6 +59,11 @@ namespace Opm {
         ///    information on active phases and table dimensions ("TABDIMS").
         void addSatFunc(const EclipseState& es);
 
+        /// Build the tables of a collection concurrently on \p pool
+        /// instead of serially on the calling thread.  The pool must
+        /// outlive this object.
+        void setThreadPool(out::ThreadPool& pool);
+
         /// Acquire read-only reference to internal TABDIMS vector.
         const std::vector<int>& tabdims() const;
 
@@ -65,8 +80,24 @@ namespace Opm {
         /// Linearised tabular data of PVT and saturation functions.
         std::vector<double> data;
 
-        void addData(const std::size_t          offset_index,
-                     const std::vector<double>& new_data);
+        /// Pool on which the tables of a collection are built.
+        out::ThreadPool* pool;
+
+        /// Append a block of \p size elements, all equal to \p
+        /// fill_value, to the TAB vector and record its starting position
+        /// in TABDIMS item \p offset_index.
+        ///
+        /// \return Offset of the new block in the TAB vector.  Note that
+        ///    the block must be addressed by offset, since pointers into
+        ///    the TAB vector are invalidated by later allocations.
+        std::size_t allocData(const std::size_t offset_index,
+                              const std::size_t size,
+                              const double      fill_value);
+
+        /// Record starting position \p offset of a block already appended
+        /// to the TAB vector in TABDIMS item \p offset_index.
+        void setTableOffset(const std::size_t offset_index,
+                            const std::size_t offset);
 
         /// Add saturation function tables corresponding to family I (SGOF,
         /// SWOF) to the tabular data (TABDIMS and TAB vectors).
@@ -0,0 +1,320 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opm/output/eclipse/TablesCache.hpp>
+
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Runspec.hpp>
+#include <opm/parser/eclipse/EclipseState/Tables/Tabdims.hpp>
+#include <opm/parser/eclipse/EclipseState/Tables/TableContainer.hpp>
+#include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+    /// Bump whenever the layout of the generated TABDIMS/TAB vectors
+    /// changes, to invalidate existing cache entries.
+    const std::uint64_t layout_version = 1;
+
+    const char entry_magic[8] = { 'O', 'P', 'M', 'T', 'A', 'B', 'C', '1' };
+
+    /// Incremental 64-bit FNV-1a hash.
+    class Hasher {
+    public:
+        void bytes(const void* data, const std::size_t size)
+        {
+            const auto* p = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                this->value ^= p[i];
+                this->value *= 1099511628211ULL;
+            }
+        }
+
+        template <typename T>
+        void pod(const T& x)
+        {
+            this->bytes(&x, sizeof x);
+        }
+
+        void string(const std::string& s)
+        {
+            this->pod(static_cast<std::uint64_t>(s.size()));
+            this->bytes(s.data(), s.size());
+        }
+
+        void table(const Opm::SimpleTable& t)
+        {
+            const std::uint64_t ncol = t.numColumns();
+            const std::uint64_t nrow = t.numRows();
+
+            this->pod(ncol);
+            this->pod(nrow);
+
+            for (std::size_t c = 0; c < ncol; ++c) {
+                const auto& col = t.getColumn(c);
+                for (std::size_t r = 0; r < col.size(); ++r) {
+                    this->pod(col[r]);
+                }
+            }
+        }
+
+        template <class PvtxTable>
+        void pvtx(const std::vector<PvtxTable>& tables)
+        {
+            this->pod(static_cast<std::uint64_t>(tables.size()));
+
+            for (const auto& table : tables) {
+                this->pod(static_cast<std::uint64_t>(table.size()));
+
+                for (const auto& underSatTable : table) {
+                    this->table(underSatTable);
+                }
+
+                this->table(table.getSaturatedTable());
+            }
+        }
+
+        void container(const Opm::TableManager& tabMgr,
+                       const std::string&       name)
+        {
+            this->string(name);
+
+            const bool present = tabMgr.hasTables(name);
+            this->pod(present);
+
+            if (present) {
+                const auto& tables = tabMgr.getTables(name);
+
+                this->pod(static_cast<std::uint64_t>(tables.size()));
+                for (std::size_t i = 0; i < tables.size(); ++i) {
+                    this->table(tables.getTable(i));
+                }
+            }
+        }
+
+        std::uint64_t value = 14695981039346656037ULL;
+    };
+
+    template <typename T>
+    bool readVector(std::istream& is, std::vector<T>& v, Hasher& h)
+    {
+        std::uint64_t n = 0;
+        if (! is.read(reinterpret_cast<char*>(&n), sizeof n)) {
+            return false;
+        }
+
+        // Guard against absurd sizes from damaged files.
+        if (n > (std::uint64_t(1) << 40) / sizeof(T)) {
+            return false;
+        }
+
+        v.resize(n);
+        if (! is.read(reinterpret_cast<char*>(v.data()), n * sizeof(T))) {
+            return false;
+        }
+
+        h.pod(n);
+        h.bytes(v.data(), n * sizeof(T));
+
+        return true;
+    }
+
+    template <typename T>
+    void writeVector(std::ostream& os, const std::vector<T>& v, Hasher& h)
+    {
+        const std::uint64_t n = v.size();
+
+        os.write(reinterpret_cast<const char*>(&n), sizeof n);
+        os.write(reinterpret_cast<const char*>(v.data()), n * sizeof(T));
+
+        h.pod(n);
+        h.bytes(v.data(), n * sizeof(T));
+    }
+
+    /// Name of a temporary file that no other writer, in this or any
+    /// other process, will use.
+    std::string temporaryName(const std::string& filename)
+    {
+        static std::atomic<unsigned long> counter{ 0 };
+
+        std::ostringstream name;
+        name << filename << '.' << ::getpid()
+             << '.' << std::hash<std::thread::id>()(std::this_thread::get_id())
+             << '.' << counter++ << ".tmp";
+
+        return name.str();
+    }
+}
+
+namespace Opm {
+
+    TablesCache::TablesCache(const std::string& directory0)
+        : directory(directory0)
+    {}
+
+    std::string TablesCache::key(const EclipseState& es)
+    {
+        const auto& tabMgr = es.getTableManager();
+        const auto& phases = es.runspec().phases();
+
+        Hasher h;
+
+        h.pod(layout_version);
+        h.string(es.getUnits().getName());
+
+        for (const auto phase : { Phase::OIL, Phase::GAS, Phase::WATER }) {
+            h.pod(phases.active(phase));
+        }
+
+        h.pod(static_cast<std::uint64_t>(es.runspec().tabdims().getNumSatNodes()));
+
+        h.pvtx(tabMgr.getPvtoTables());
+        h.pvtx(tabMgr.getPvtgTables());
+
+        {
+            const auto& pvtw = tabMgr.getPvtwTable();
+
+            h.pod(static_cast<std::uint64_t>(pvtw.size()));
+            for (std::size_t i = 0; i < pvtw.size(); ++i) {
+                const auto& record = pvtw[i];
+
+                h.pod(record.reference_pressure);
+                h.pod(record.volume_factor);
+                h.pod(record.compressibility);
+                h.pod(record.viscosity);
+                h.pod(record.viscosibility);
+            }
+        }
+
+        {
+            const auto& density = tabMgr.getDensityTable();
+
+            h.pod(static_cast<std::uint64_t>(density.size()));
+            for (std::size_t i = 0; i < density.size(); ++i) {
+                const auto& record = density[i];
+
+                h.pod(record.oil);
+                h.pod(record.water);
+                h.pod(record.gas);
+            }
+        }
+
+        for (const auto* name : { "SGOF", "SWOF", "SGFN", "SOF2", "SOF3", "SWFN" }) {
+            h.container(tabMgr, name);
+        }
+
+        std::ostringstream hex;
+        hex << std::hex << std::setw(16) << std::setfill('0') << h.value;
+
+        return hex.str();
+    }
+
+    std::string TablesCache::filename(const std::string& key) const
+    {
+        return this->directory + "/" + key + ".tabc";
+    }
+
+    bool TablesCache::load(const std::string&   key,
+                           std::vector<int>&    tabdims,
+                           std::vector<double>& tab) const
+    {
+        std::ifstream is(this->filename(key), std::ios::binary);
+        if (! is) {
+            return false;
+        }
+
+        char magic[sizeof entry_magic];
+        if (! is.read(magic, sizeof magic) ||
+            (std::memcmp(magic, entry_magic, sizeof magic) != 0))
+        {
+            return false;
+        }
+
+        Hasher h;
+        std::vector<int>    new_tabdims;
+        std::vector<double> new_tab;
+
+        if (! readVector(is, new_tabdims, h) ||
+            ! readVector(is, new_tab, h))
+        {
+            return false;
+        }
+
+        std::uint64_t checksum = 0;
+        if (! is.read(reinterpret_cast<char*>(&checksum), sizeof checksum) ||
+            (checksum != h.value))
+        {
+            return false;
+        }
+
+        tabdims.swap(new_tabdims);
+        tab.swap(new_tab);
+
+        return true;
+    }
+
+    bool TablesCache::store(const std::string&         key,
+                            const std::vector<int>&    tabdims,
+                            const std::vector<double>& tab) const
+    {
+        const auto target = this->filename(key);
+        const auto tmp    = temporaryName(target);
+
+        {
+            std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+            if (! os) {
+                return false;
+            }
+
+            Hasher h;
+
+            os.write(entry_magic, sizeof entry_magic);
+            writeVector(os, tabdims, h);
+            writeVector(os, tab, h);
+            os.write(reinterpret_cast<const char*>(&h.value), sizeof h.value);
+
+            os.close();
+            if (! os) {
+                std::remove(tmp.c_str());
+                return false;
+            }
+        }
+
+        // rename() atomically replaces any existing entry.  Concurrent
+        // writers of the same key produce identical contents, so it does
+        // not matter which of them wins.
+        if (std::rename(tmp.c_str(), target.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,81 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OUTPUT_TABLES_CACHE_HPP
+#define OUTPUT_TABLES_CACHE_HPP
+
+#include <string>
+#include <vector>
+
+namespace Opm {
+    class EclipseState;
+
+    /// On-disk cache of linearised TABDIMS/TAB vectors.
+    ///
+    /// Runs of an ensemble typically share their PVT and saturation
+    /// function tables.  Entries are keyed on a content hash of the input
+    /// tables, the active phases, the table dimensions and the unit
+    /// system, so that a run whose tables match an earlier run can emit
+    /// the INIT file's TABDIMS and TAB vectors without rebuilding them.
+    ///
+    /// Each entry lives in its own file.  Writers create a private
+    /// temporary file and atomically rename it into place, so concurrent
+    /// processes storing the same entry are safe and readers never see a
+    /// partially written entry.  Damaged or foreign files are treated as
+    /// cache misses.
+    class TablesCache {
+    public:
+        /// Cache backed by files in existing directory \p directory.
+        explicit TablesCache(const std::string& directory);
+
+        /// Cache key for the tables of a particular run.
+        ///
+        /// \param[in] es Valid \c EclipseState object with accurate
+        ///    RUNSPEC information and an initialised \c TableManager.
+        ///
+        /// \return Hexadecimal content hash.
+        static std::string key(const EclipseState& es);
+
+        /// Retrieve cached TABDIMS and TAB vectors.
+        ///
+        /// \return Whether or not a valid entry for \p key exists.  The
+        ///    output vectors are only modified on success.
+        bool load(const std::string&   key,
+                  std::vector<int>&    tabdims,
+                  std::vector<double>& tab) const;
+
+        /// Store TABDIMS and TAB vectors under \p key.
+        ///
+        /// Failure to write the cache entry is not an error for the run
+        /// itself and is reported through the return value only.
+        ///
+        /// \return Whether or not the entry was written.
+        bool store(const std::string&         key,
+                   const std::vector<int>&    tabdims,
+                   const std::vector<double>& tab) const;
+
+        /// Name of the file holding the entry for \p key.
+        std::string filename(const std::string& key) const;
+
+    private:
+        std::string directory;
+    };
+}
+
+#endif  // OUTPUT_TABLES_CACHE_HPP
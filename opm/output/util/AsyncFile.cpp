@@ -0,0 +1,495 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <opm/output/util/AsyncFile.hpp>
+#include <opm/output/util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <list>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define OPM_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace Opm {
+namespace out {
+
+namespace {
+
+// Writes queued before a batch is submitted.
+const std::size_t batch_size = 32;
+
+std::runtime_error ioError(const std::string& what, int error)
+{
+    return std::runtime_error("AsyncFile: " + what + ": " + std::strerror(error));
+}
+
+// One queued or submitted write.  The iovec is used by io_uring and
+// must stay in place until the write has completed.
+struct Request
+{
+    std::vector<char> data;
+    std::uint64_t offset;
+    std::size_t done = 0;
+    struct iovec iov;
+};
+
+void pwriteAll(int fd, Request& request)
+{
+    while (request.done < request.data.size()) {
+        const auto n = ::pwrite(fd, request.data.data() + request.done,
+                                request.data.size() - request.done,
+                                request.offset + request.done);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw ioError("pwrite failed", errno);
+        }
+        request.done += n;
+    }
+}
+
+#ifdef OPM_HAVE_IO_URING
+
+// A minimal io_uring: the submission and completion rings mapped from
+// the kernel, used through raw system calls so that no library is
+// needed.
+class Ring
+{
+public:
+    explicit Ring(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof params);
+
+        this->fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (this->fd < 0)
+            return;
+
+        this->sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        this->cq_len = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+            this->sq_len = this->cq_len = std::max(this->sq_len, this->cq_len);
+
+        this->sq_ptr = ::mmap(nullptr, this->sq_len, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQ_RING);
+        this->cq_ptr = single_mmap
+            ? this->sq_ptr
+            : ::mmap(nullptr, this->cq_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_CQ_RING);
+
+        this->sqes_len = params.sq_entries * sizeof(io_uring_sqe);
+        this->sqes_ptr = ::mmap(nullptr, this->sqes_len, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQES);
+
+        if (this->sq_ptr == MAP_FAILED || this->cq_ptr == MAP_FAILED || this->sqes_ptr == MAP_FAILED) {
+            this->release();
+            return;
+        }
+
+        char* sq = static_cast<char*>(this->sq_ptr);
+        this->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        this->sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        this->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        this->sqes = static_cast<io_uring_sqe*>(this->sqes_ptr);
+
+        char* cq = static_cast<char*>(this->cq_ptr);
+        this->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        this->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        this->cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        this->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        this->capacity = params.sq_entries;
+    }
+
+    ~Ring()
+    {
+        this->release();
+    }
+
+    bool valid() const
+    {
+        return this->fd >= 0;
+    }
+
+    // Submissions the ring can take before completions are reaped.
+    unsigned entries() const
+    {
+        return this->capacity;
+    }
+
+    void prepareWrite(int file, Request& request)
+    {
+        request.iov.iov_base = request.data.data() + request.done;
+        request.iov.iov_len = request.data.size() - request.done;
+
+        const unsigned tail = *this->sq_tail;
+        const unsigned index = tail & this->sq_mask;
+
+        io_uring_sqe* sqe = &this->sqes[index];
+        std::memset(sqe, 0, sizeof *sqe);
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = file;
+        sqe->addr = reinterpret_cast<std::uint64_t>(&request.iov);
+        sqe->len = 1;
+        sqe->off = request.offset + request.done;
+        sqe->user_data = reinterpret_cast<std::uint64_t>(&request);
+
+        this->sq_array[index] = index;
+        __atomic_store_n(this->sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ++this->prepared;
+    }
+
+    // Submit the prepared writes, and wait for at least min_complete
+    // completions.
+    void enter(unsigned min_complete)
+    {
+        while (this->prepared > 0 || min_complete > 0) {
+            const auto flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0u;
+            const auto n = ::syscall(__NR_io_uring_enter, this->fd, this->prepared,
+                                     min_complete, flags, nullptr, 0);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw ioError("io_uring_enter failed", errno);
+            }
+            this->prepared -= unsigned(n);
+            min_complete = 0;
+        }
+    }
+
+    // Call fn(request, result) for every completion.
+    template <typename Function>
+    void reap(Function fn)
+    {
+        unsigned head = *this->cq_head;
+        const unsigned tail = __atomic_load_n(this->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = this->cqes[head & this->cq_mask];
+            fn(*reinterpret_cast<Request*>(cqe.user_data), cqe.res);
+            ++head;
+        }
+        __atomic_store_n(this->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    void release()
+    {
+        if (this->sqes_ptr && this->sqes_ptr != MAP_FAILED)
+            ::munmap(this->sqes_ptr, this->sqes_len);
+        if (this->cq_ptr && this->cq_ptr != MAP_FAILED && this->cq_ptr != this->sq_ptr)
+            ::munmap(this->cq_ptr, this->cq_len);
+        if (this->sq_ptr && this->sq_ptr != MAP_FAILED)
+            ::munmap(this->sq_ptr, this->sq_len);
+        if (this->fd >= 0)
+            ::close(this->fd);
+
+        this->sq_ptr = this->cq_ptr = this->sqes_ptr = nullptr;
+        this->fd = -1;
+    }
+
+    int fd = -1;
+    unsigned capacity = 0;
+    unsigned prepared = 0;
+
+    void* sq_ptr = nullptr;
+    void* cq_ptr = nullptr;
+    void* sqes_ptr = nullptr;
+    std::size_t sq_len = 0;
+    std::size_t cq_len = 0;
+    std::size_t sqes_len = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* sq_array = nullptr;
+    io_uring_sqe* sqes = nullptr;
+
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+};
+
+#endif // OPM_HAVE_IO_URING
+
+} // Anonymous
+
+class AsyncFile::Impl
+{
+public:
+    Impl(const std::string& filename, Backend backend, Mode mode)
+        : fd(::open(filename.c_str(),
+                    O_WRONLY | O_CREAT | (mode == Mode::Truncate ? O_TRUNC : 0),
+                    0644))
+    {
+        if (this->fd < 0)
+            throw ioError("could not open " + filename, errno);
+
+        if (mode == Mode::Append) {
+            const auto size = ::lseek(this->fd, 0, SEEK_END);
+            if (size < 0) {
+                const int error = errno;
+                ::close(this->fd);
+                throw ioError("could not seek " + filename, error);
+            }
+            this->end = size;
+        }
+
+#ifdef OPM_HAVE_IO_URING
+        if (backend != Backend::PWrite) {
+            this->ring.reset(new Ring(2 * batch_size));
+            if (!this->ring->valid())
+                this->ring.reset();
+        }
+#else
+        static_cast<void>(backend);
+#endif
+
+        if (!this->usesRing())
+            this->worker.reset(new ThreadPool(1));
+    }
+
+    ~Impl()
+    {
+        try {
+            this->flush();
+        } catch (...) {
+        }
+
+#ifdef OPM_HAVE_IO_URING
+        if (this->ring)
+            this->drain();
+#endif
+
+        this->worker.reset();
+        ::close(this->fd);
+    }
+
+    bool usesRing() const
+    {
+#ifdef OPM_HAVE_IO_URING
+        return static_cast<bool>(this->ring);
+#else
+        return false;
+#endif
+    }
+
+    void append(std::vector<char>&& data)
+    {
+        if (data.empty())
+            return;
+
+        Request request;
+        request.offset = this->end;
+        request.data = std::move(data);
+        this->end += request.data.size();
+        this->queued.push_back(std::move(request));
+
+        if (this->queued.size() >= batch_size)
+            this->submit();
+    }
+
+    // Hand the queued writes to the backend without waiting.
+    void submit()
+    {
+        if (this->queued.empty())
+            return;
+
+#ifdef OPM_HAVE_IO_URING
+        if (this->ring) {
+            while (!this->queued.empty()) {
+                if (this->in_flight.size() >= this->ring->entries())
+                    this->complete(1);
+
+                this->in_flight.splice(this->in_flight.end(), this->queued, this->queued.begin());
+                this->ring->prepareWrite(this->fd, this->in_flight.back());
+            }
+            this->ring->enter(0);
+            this->complete(0);
+            return;
+        }
+#endif
+
+        auto batch = std::make_shared<std::list<Request>>(std::move(this->queued));
+        this->queued.clear();
+
+        const int file = this->fd;
+        this->pending.push_back(this->worker->submit([batch, file]() {
+            for (auto& request : *batch)
+                pwriteAll(file, request);
+        }));
+
+        // Report errors of finished batches early.
+        while (!this->pending.empty() &&
+               this->pending.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            auto done = std::move(this->pending.front());
+            this->pending.pop_front();
+            done.get();
+        }
+    }
+
+    void flush()
+    {
+        this->submit();
+
+#ifdef OPM_HAVE_IO_URING
+        if (this->ring) {
+            while (!this->in_flight.empty())
+                this->complete(1);
+            return;
+        }
+#endif
+
+        while (!this->pending.empty()) {
+            auto done = std::move(this->pending.front());
+            this->pending.pop_front();
+            done.get();
+        }
+    }
+
+    std::uint64_t size() const
+    {
+        return this->end;
+    }
+
+private:
+#ifdef OPM_HAVE_IO_URING
+    // Wait for at least min_complete completions, and resubmit the
+    // rest of short writes.
+    void complete(unsigned min_complete)
+    {
+        this->ring->enter(min_complete);
+
+        int error = 0;
+        this->ring->reap([this, &error](Request& request, int result) {
+            if (result == -EINTR || result == -EAGAIN) {
+                this->ring->prepareWrite(this->fd, request);
+                return;
+            }
+            if (result < 0) {
+                error = -result;
+                this->finish(request);
+                return;
+            }
+
+            request.done += std::size_t(result);
+            if (request.done < request.data.size())
+                this->ring->prepareWrite(this->fd, request);
+            else
+                this->finish(request);
+        });
+
+        if (error != 0)
+            throw ioError("write failed", error);
+    }
+
+    // Wait for every write the kernel still holds, since the kernel
+    // reads from their buffers until it completes them.  If the ring
+    // itself fails the buffers are leaked rather than freed under it.
+    void drain()
+    {
+        while (!this->in_flight.empty()) {
+            const auto before = this->in_flight.size();
+            try {
+                this->complete(1);
+            } catch (const std::runtime_error&) {
+                // A failed write is reaped and removed; no progress
+                // means io_uring_enter() failed.
+                if (this->in_flight.size() == before) {
+                    new std::list<Request>(std::move(this->in_flight));
+                    this->in_flight.clear();
+                }
+            }
+        }
+    }
+
+    void finish(Request& request)
+    {
+        for (auto it = this->in_flight.begin(); it != this->in_flight.end(); ++it) {
+            if (&*it == &request) {
+                this->in_flight.erase(it);
+                return;
+            }
+        }
+    }
+
+    std::unique_ptr<Ring> ring;
+    std::list<Request> in_flight;
+#endif
+
+    int fd;
+    std::uint64_t end = 0;
+    std::list<Request> queued;
+
+    std::unique_ptr<ThreadPool> worker;
+    std::list<std::future<void>> pending;
+};
+
+AsyncFile::AsyncFile(const std::string& filename, Backend backend, Mode mode)
+    : impl(new Impl(filename, backend, mode))
+{
+}
+
+AsyncFile::~AsyncFile() = default;
+
+void AsyncFile::append(std::vector<char> data)
+{
+    this->impl->append(std::move(data));
+}
+
+void AsyncFile::append(const char* data, std::size_t size)
+{
+    this->impl->append(std::vector<char>(data, data + size));
+}
+
+void AsyncFile::flush()
+{
+    this->impl->flush();
+}
+
+AsyncFile::Backend AsyncFile::backend() const
+{
+    return this->impl->usesRing() ? Backend::IoUring : Backend::PWrite;
+}
+
+std::uint64_t AsyncFile::size() const
+{
+    return this->impl->size();
+}
+
+} // namespace out
+} // namespace Opm
@@ -0,0 +1,95 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_OUTPUT_ASYNCFILE_HPP
+#define OPM_OUTPUT_ASYNCFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Opm {
+namespace out {
+
+    /// Output file with asynchronous, batched writes.
+    ///
+    /// Data appended to the file is queued and submitted in batches,
+    /// without waiting for the writes to complete; flush() is the
+    /// barrier which waits for all of them.  On Linux the writes go
+    /// through an io_uring; where the kernel does not provide one they
+    /// are done with pwrite() on a background thread.
+    ///
+    /// Write errors are reported as std::runtime_error by the next
+    /// append() or flush().  An AsyncFile is used by one thread at a
+    /// time.
+    ///
+    /// The summary record stream is the only user.  Restart and RFT
+    /// files are written by libecl (ecl_rst_file, ecl_rft_node_fwrite)
+    /// through its own stdio streams, see RFT::writeTimeStep().
+    class AsyncFile
+    {
+    public:
+        enum class Backend { Automatic, IoUring, PWrite };
+        enum class Mode { Truncate, Append };
+
+        /// Create or open a file.
+        ///
+        /// \param[in] filename Name of the file.
+        /// \param[in] backend Backend to use.  Automatic and IoUring use
+        ///    io_uring when available and fall back to PWrite.
+        /// \param[in] mode Truncate an existing file, or Append to it.
+        explicit AsyncFile(const std::string& filename,
+                           Backend backend = Backend::Automatic,
+                           Mode mode = Mode::Truncate);
+
+        /// Wait for all writes and close the file, ignoring errors.
+        ~AsyncFile();
+
+        AsyncFile(const AsyncFile&) = delete;
+        AsyncFile& operator=(const AsyncFile&) = delete;
+
+        /// Queue data for writing at the end of the file.
+        void append(std::vector<char> data);
+
+        /// Queue a copy of size bytes for writing at the end of the
+        /// file.
+        void append(const char* data, std::size_t size);
+
+        /// Submit all queued data and wait until it has been written.
+        void flush();
+
+        /// The backend in use, IoUring or PWrite.
+        Backend backend() const;
+
+        /// Size of the file with all data appended so far, written or
+        /// not.
+        std::uint64_t size() const;
+
+        class Impl;
+
+    private:
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace out
+} // namespace Opm
+
+#endif // OPM_OUTPUT_ASYNCFILE_HPP
@@ -0,0 +1,211 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <opm/output/util/ByteSwap.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OPM_BYTESWAP_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Opm {
+namespace out {
+
+namespace {
+
+    void scalarSwap(const char* src, char* dst, std::size_t count, std::size_t elementSize)
+    {
+        switch (elementSize) {
+        case 4:
+            for (std::size_t i = 0; i < count; ++i) {
+                std::uint32_t x;
+                std::memcpy(&x, src + 4*i, 4);
+                x = ((x & 0x000000FFu) << 24) | ((x & 0x0000FF00u) << 8)
+                  | ((x & 0x00FF0000u) >>  8) | ((x & 0xFF000000u) >> 24);
+                std::memcpy(dst + 4*i, &x, 4);
+            }
+            return;
+
+        case 8:
+            for (std::size_t i = 0; i < count; ++i) {
+                std::uint64_t x;
+                std::memcpy(&x, src + 8*i, 8);
+                x = ((x & 0x00000000FFFFFFFFull) << 32) | ((x & 0xFFFFFFFF00000000ull) >> 32);
+                x = ((x & 0x0000FFFF0000FFFFull) << 16) | ((x & 0xFFFF0000FFFF0000ull) >> 16);
+                x = ((x & 0x00FF00FF00FF00FFull) <<  8) | ((x & 0xFF00FF00FF00FF00ull) >>  8);
+                std::memcpy(dst + 8*i, &x, 8);
+            }
+            return;
+
+        default:
+            for (std::size_t i = 0; i < count; ++i) {
+                char* out = dst + i*elementSize;
+                const char* in = src + i*elementSize;
+                for (std::size_t lo = 0, hi = elementSize - 1; lo < hi; ++lo, --hi) {
+                    const char tmp = in[lo];
+                    out[lo] = in[hi];
+                    out[hi] = tmp;
+                }
+                if (elementSize % 2 == 1 && out != in) {
+                    out[elementSize / 2] = in[elementSize / 2];
+                }
+            }
+            return;
+        }
+    }
+
+#ifdef OPM_BYTESWAP_X86
+
+    __attribute__((target("ssse3")))
+    void ssse3Swap(const char* src, char* dst, std::size_t count, std::size_t elementSize)
+    {
+        const __m128i mask = (elementSize == 4)
+            ? _mm_set_epi8(12, 13, 14, 15,  8,  9, 10, 11,  4,  5,  6,  7, 0, 1, 2, 3)
+            : _mm_set_epi8( 8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3, 4, 5, 6, 7);
+
+        const std::size_t bytes = count * elementSize;
+        std::size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),      _mm_shuffle_epi8(a, mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), _mm_shuffle_epi8(b, mask));
+        }
+        for (; i + 16 <= bytes; i += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(a, mask));
+        }
+
+        scalarSwap(src + i, dst + i, (bytes - i) / elementSize, elementSize);
+    }
+
+    __attribute__((target("avx2")))
+    void avx2Swap(const char* src, char* dst, std::size_t count, std::size_t elementSize)
+    {
+        // _mm256_shuffle_epi8 shuffles within each 128-bit lane, so the
+        // lane mask is simply repeated.
+        const __m256i mask = (elementSize == 4)
+            ? _mm256_set_epi8(12, 13, 14, 15,  8,  9, 10, 11,  4,  5,  6,  7, 0, 1, 2, 3,
+                              12, 13, 14, 15,  8,  9, 10, 11,  4,  5,  6,  7, 0, 1, 2, 3)
+            : _mm256_set_epi8( 8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3, 4, 5, 6, 7,
+                               8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3, 4, 5, 6, 7);
+
+        const std::size_t bytes = count * elementSize;
+        std::size_t i = 0;
+        for (; i + 64 <= bytes; i += 64) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),      _mm256_shuffle_epi8(a, mask));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_shuffle_epi8(b, mask));
+        }
+        for (; i + 32 <= bytes; i += 32) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(a, mask));
+        }
+
+        scalarSwap(src + i, dst + i, (bytes - i) / elementSize, elementSize);
+    }
+
+#endif // OPM_BYTESWAP_X86
+
+    using Kernel = void (*)(const char*, char*, std::size_t, std::size_t);
+
+    struct Dispatch
+    {
+        Kernel kernel;
+        const char* name;
+    };
+
+    /// Kernel of the given name if the CPU supports it, else nullptr.
+    Kernel supportedKernel(const std::string& name)
+    {
+#ifdef OPM_BYTESWAP_X86
+        __builtin_cpu_init();
+        if (name == "avx2") {
+            return __builtin_cpu_supports("avx2") ? avx2Swap : nullptr;
+        }
+        if (name == "ssse3") {
+            return __builtin_cpu_supports("ssse3") ? ssse3Swap : nullptr;
+        }
+#endif
+        return (name == "scalar") ? scalarSwap : nullptr;
+    }
+
+    Dispatch selectKernel()
+    {
+        for (const char* name : { "avx2", "ssse3" }) {
+            if (const auto kernel = supportedKernel(name)) {
+                return { kernel, name };
+            }
+        }
+        return { scalarSwap, "scalar" };
+    }
+
+    void swapWith(Kernel kernel, const char* in, char* out,
+                  std::size_t count, std::size_t elementSize)
+    {
+        if (elementSize == 4 || elementSize == 8) {
+            kernel(in, out, count, elementSize);
+        }
+        else if (elementSize > 1) {
+            scalarSwap(in, out, count, elementSize);
+        }
+        else if (in != out) {
+            std::memcpy(out, in, count);
+        }
+    }
+
+    const Dispatch& dispatch()
+    {
+        static const Dispatch selected = selectKernel();
+        return selected;
+    }
+
+} // Anonymous
+
+void byteSwap(const void* src, void* dst, std::size_t count, std::size_t elementSize)
+{
+    swapWith(dispatch().kernel, static_cast<const char*>(src),
+             static_cast<char*>(dst), count, elementSize);
+}
+
+const char* byteSwapKernel()
+{
+    return dispatch().name;
+}
+
+bool byteSwapWith(const char* kernel, const void* src, void* dst,
+                  std::size_t count, std::size_t elementSize)
+{
+    const auto selected = supportedKernel(kernel);
+    if (selected == nullptr) {
+        return false;
+    }
+
+    swapWith(selected, static_cast<const char*>(src),
+             static_cast<char*>(dst), count, elementSize);
+    return true;
+}
+
+} // namespace out
+} // namespace Opm
@@ -0,0 +1,57 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_OUTPUT_BYTESWAP_HPP
+#define OPM_OUTPUT_BYTESWAP_HPP
+
+#include <cstddef>
+
+namespace Opm {
+namespace out {
+
+    /// Reverse the byte order of count elements of elementSize bytes.
+    ///
+    /// Four and eight byte elements use SSSE3 or AVX2 byte shuffles
+    /// when the CPU supports them, chosen once at run time; other sizes
+    /// and other CPUs use a scalar loop.  Source and destination may be
+    /// the same array, but must not otherwise overlap.  No alignment is
+    /// required.
+    ///
+    /// \param[in] src Input elements.
+    /// \param[out] dst Output elements.
+    /// \param[in] count Number of elements.
+    /// \param[in] elementSize Bytes per element.
+    void byteSwap(const void* src, void* dst, std::size_t count, std::size_t elementSize);
+
+    /// Name of the kernel used by byteSwap(): "avx2", "ssse3" or
+    /// "scalar".
+    const char* byteSwapKernel();
+
+    /// Run byteSwap() with the named kernel instead of the one chosen
+    /// for the CPU, e.g. to test or time every kernel.
+    ///
+    /// \return False, without touching \p dst, if the kernel is unknown
+    ///    or not supported by the CPU.
+    bool byteSwapWith(const char* kernel, const void* src, void* dst,
+                      std::size_t count, std::size_t elementSize);
+
+} // namespace out
+} // namespace Opm
+
+#endif // OPM_OUTPUT_BYTESWAP_HPP
@@ -0,0 +1,241 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <opm/output/util/LossyCodec.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Opm {
+namespace out {
+
+namespace {
+
+    const std::size_t block_size = 256;
+    const std::int64_t max_steps = std::int64_t(1) << 31;
+
+    /* Rice quotients from escape up are written as escape one bits and
+       the value in 32 raw bits. */
+    const unsigned escape = 24;
+    const unsigned parameter_bits = 5;
+
+    std::uint64_t mask(unsigned bits)
+    {
+        return (std::uint64_t(1) << bits) - 1;
+    }
+
+    /* The same rounding on every platform, for the error bound check. */
+    double reconstruct(const QuantisedField& field, std::int64_t index)
+    {
+        return std::fma(double(index), field.step, field.minimum);
+    }
+
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<std::int32_t>& words_arg)
+            : words(words_arg)
+        {}
+
+        /* At most 32 bits. */
+        void put(std::uint64_t bits, unsigned count)
+        {
+            this->acc = (this->acc << count) | (bits & mask(count));
+            this->used += count;
+            if (this->used >= 32) {
+                this->used -= 32;
+                this->words.push_back(static_cast<std::int32_t>(std::uint32_t(this->acc >> this->used)));
+            }
+        }
+
+        void finish()
+        {
+            if (this->used > 0)
+                this->words.push_back(static_cast<std::int32_t>(std::uint32_t(this->acc << (32 - this->used))));
+            this->used = 0;
+        }
+
+    private:
+        std::vector<std::int32_t>& words;
+        std::uint64_t acc = 0;
+        unsigned used = 0;
+    };
+
+    class BitReader {
+    public:
+        explicit BitReader(const std::vector<std::int32_t>& words_arg)
+            : words(words_arg)
+        {}
+
+        /* At most 32 bits. */
+        std::uint64_t get(unsigned count)
+        {
+            if (this->used < count) {
+                if (this->next == this->words.size())
+                    throw std::runtime_error("Lossy codec: truncated data");
+                this->acc = (this->acc << 32) | std::uint32_t(this->words[this->next++]);
+                this->used += 32;
+            }
+            this->used -= count;
+            return (this->acc >> this->used) & mask(count);
+        }
+
+    private:
+        const std::vector<std::int32_t>& words;
+        std::size_t next = 0;
+        std::uint64_t acc = 0;
+        unsigned used = 0;
+    };
+
+    /* Bits of a block of zigzag coded differences with Rice parameter k. */
+    std::uint64_t riceBits(const std::uint64_t* u, std::size_t count, unsigned k)
+    {
+        std::uint64_t bits = parameter_bits;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto quotient = u[i] >> k;
+            bits += quotient < escape ? quotient + 1 + k : escape + 32;
+        }
+        return bits;
+    }
+
+} // Anonymous
+
+double ErrorBound::absolute(const double* data, std::size_t size) const
+{
+    if (!(this->value > 0.0))
+        return 0.0;
+
+    if (this->type == Type::Absolute)
+        return this->value;
+
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -lo;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (std::isfinite(data[i])) {
+            lo = std::min(lo, data[i]);
+            hi = std::max(hi, data[i]);
+        }
+    }
+
+    return hi > lo ? this->value * (hi - lo) : 0.0;
+}
+
+bool quantise(const double* data, std::size_t size, double bound, QuantisedField& field)
+{
+    if (!(bound > 0.0) || !std::isfinite(bound))
+        return false;
+
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -lo;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (!std::isfinite(data[i]))
+            return false;
+        lo = std::min(lo, data[i]);
+        hi = std::max(hi, data[i]);
+    }
+
+    field.minimum = size > 0 ? lo : 0.0;
+    field.step = 2 * bound;
+    field.size = size;
+    field.words.clear();
+    if (size > 0 && !((hi - lo) / field.step < double(max_steps - 1)))
+        return false;
+
+    std::vector<std::uint64_t> u(size);
+    std::int64_t previous = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto index = static_cast<std::int64_t>(std::round((data[i] - lo) / field.step));
+        if (std::fabs(reconstruct(field, index) - data[i]) > bound)
+            return false;
+
+        const auto diff = index - previous;
+        u[i] = (std::uint64_t(diff) << 1) ^ std::uint64_t(diff >> 63);
+        previous = index;
+    }
+
+    BitWriter writer(field.words);
+    for (std::size_t begin = 0; begin < size; begin += block_size) {
+        const auto count = std::min(block_size, size - begin);
+        const auto* block = &u[begin];
+
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+            sum += block[i];
+
+        /* The best parameter is close to log2 of the mean. */
+        unsigned k = 0;
+        while (k < 31 && (std::uint64_t(1) << (k + 1)) * count <= sum)
+            ++k;
+
+        unsigned best = k;
+        for (unsigned candidate : { k - 1, k + 1 })
+            if (candidate < 32 && riceBits(block, count, candidate) < riceBits(block, count, best))
+                best = candidate;
+
+        writer.put(best, parameter_bits);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto quotient = block[i] >> best;
+            if (quotient < escape) {
+                writer.put(mask(unsigned(quotient)), unsigned(quotient));
+                writer.put(0, 1);
+                writer.put(block[i], best);
+            } else {
+                writer.put(mask(escape), escape);
+                writer.put(block[i], 32);
+            }
+        }
+    }
+    writer.finish();
+
+    return true;
+}
+
+std::vector<double> dequantise(const QuantisedField& field)
+{
+    std::vector<double> values;
+    values.reserve(field.size);
+
+    BitReader reader(field.words);
+    std::int64_t previous = 0;
+    for (std::size_t begin = 0; begin < field.size; begin += block_size) {
+        const auto count = std::min(block_size, field.size - begin);
+        const auto k = unsigned(reader.get(parameter_bits));
+
+        for (std::size_t i = 0; i < count; ++i) {
+            unsigned quotient = 0;
+            while (quotient < escape && reader.get(1))
+                ++quotient;
+
+            const std::uint64_t u = quotient < escape ? (std::uint64_t(quotient) << k) | reader.get(k)
+                                                      : reader.get(32);
+            const auto index = previous + (std::int64_t(u >> 1) ^ -std::int64_t(u & 1));
+            if (index < 0 || index >= max_steps)
+                throw std::runtime_error("Lossy codec: damaged data");
+
+            values.push_back(reconstruct(field, index));
+            previous = index;
+        }
+    }
+
+    return values;
+}
+
+} // namespace out
+} // namespace Opm
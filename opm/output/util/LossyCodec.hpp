@@ -0,0 +1,72 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_OUTPUT_LOSSYCODEC_HPP
+#define OPM_OUTPUT_LOSSYCODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Opm {
+namespace out {
+
+    /// Largest error allowed when a field is encoded lossily.
+    struct ErrorBound {
+        enum class Type { Absolute, Relative };
+
+        /// Absolute bounds are in the units of the data; relative
+        /// bounds are a fraction of the range, max - min, of the data.
+        Type type = Type::Absolute;
+
+        /// Zero or less: the field is not encoded lossily.
+        double value = 0.0;
+
+        /// The absolute error bound for the data.
+        double absolute(const double* data, std::size_t size) const;
+    };
+
+    /// A field quantised to the grid minimum + i * step and entropy
+    /// coded.
+    ///
+    /// The quantisation indices are coded as the differences between
+    /// neighbouring cells, with one Rice code parameter per block of
+    /// 256 values.  The coded bits are packed big-endian into 32 bit
+    /// words, so the words can be stored as an INTE keyword.
+    struct QuantisedField {
+        double minimum = 0.0;
+        double step = 0.0;
+        std::size_t size = 0;
+        std::vector<std::int32_t> words;
+    };
+
+    /// Quantise and code size values with an absolute error of at most
+    /// bound.  False, leaving field undefined, when the values cannot
+    /// be encoded within the bound: for a bound of zero or less,
+    /// non-finite values, or more than 2^31 quantisation steps.
+    bool quantise(const double* data, std::size_t size, double bound, QuantisedField& field);
+
+    /// The values of a quantised field.  Throws std::runtime_error for
+    /// damaged data.
+    std::vector<double> dequantise(const QuantisedField& field);
+
+} // namespace out
+} // namespace Opm
+
+#endif // OPM_OUTPUT_LOSSYCODEC_HPP
@@ -0,0 +1,233 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <opm/output/util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+
+namespace Opm {
+namespace out {
+
+namespace {
+
+    /// Pool and deque index of the worker running on this thread.
+    thread_local const ThreadPool* current_pool = nullptr;
+    thread_local std::size_t current_index = 0;
+
+    struct ForState {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t grain;
+        std::size_t num_chunks;
+        std::function<void(std::size_t, std::size_t)> body;
+
+        std::atomic<std::size_t> next_chunk{ 0 };
+        std::size_t done_chunks = 0;
+
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+
+        /// Process chunks until none are left.
+        void run()
+        {
+            for (auto chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++) {
+                const auto first = begin + chunk * grain;
+                const auto last  = std::min(end, first + grain);
+
+                try {
+                    body(first, last);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++done_chunks == num_chunks)
+                    finished.notify_all();
+            }
+        }
+    };
+
+} // Anonymous
+
+struct ThreadPool::Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+};
+
+ThreadPool::ThreadPool(std::size_t numThreads)
+{
+    this->queues.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        this->queues.emplace_back(new Queue);
+
+    this->workers.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        this->workers.emplace_back([this, i]() { this->workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->wait_mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+
+    for (auto& worker : this->workers)
+        worker.join();
+}
+
+std::size_t ThreadPool::size() const
+{
+    return this->workers.size();
+}
+
+std::size_t ThreadPool::defaultSize()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+ThreadPool& ThreadPool::serial()
+{
+    static ThreadPool pool(0);
+    return pool;
+}
+
+void ThreadPool::push(std::function<void()> task)
+{
+    if (this->workers.empty()) {
+        task();
+        return;
+    }
+
+    // Count the task before it is queued: a worker may pop and
+    // uncount it as soon as it is on the queue.
+    std::size_t index;
+    {
+        std::lock_guard<std::mutex> lock(this->wait_mutex);
+        index = (current_pool == this)
+            ? current_index
+            : this->next_queue++ % this->queues.size();
+        ++this->pending;
+    }
+
+    {
+        auto& queue = *this->queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    this->wake.notify_one();
+}
+
+bool ThreadPool::tryPop(std::size_t index, std::function<void()>& task)
+{
+    const auto n = this->queues.size();
+
+    for (std::size_t k = 0; k < n; ++k) {
+        auto& queue = *this->queues[(index + k) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+
+        if (k == 0) {
+            // Own queue: newest first for cache locality.
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            // Steal the oldest task, which tends to be the largest.
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(std::size_t index)
+{
+    current_pool  = this;
+    current_index = index;
+
+    for (;;) {
+        std::function<void()> task;
+        if (this->tryPop(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(this->wait_mutex);
+                --this->pending;
+            }
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->wait_mutex);
+        this->wake.wait(lock, [this]() { return this->stopping || (this->pending > 0); });
+
+        if (this->stopping && (this->pending == 0))
+            return;
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                             const std::function<void(std::size_t, std::size_t)>& body)
+{
+    if (begin >= end)
+        return;
+
+    grain = std::max(grain, std::size_t(1));
+    const auto num_chunks = (end - begin + grain - 1) / grain;
+
+    if (this->workers.empty() || (num_chunks == 1)) {
+        for (auto first = begin; first < end; first += grain)
+            body(first, std::min(end, first + grain));
+        return;
+    }
+
+    auto state = std::make_shared<ForState>();
+    state->begin      = begin;
+    state->end        = end;
+    state->grain      = grain;
+    state->num_chunks = num_chunks;
+    state->body       = body;
+
+    // Helpers that start after all chunks are taken return at once, so
+    // the caller never waits for a task that has not started running.
+    const auto num_helpers = std::min(this->workers.size(), num_chunks - 1);
+    for (std::size_t i = 0; i < num_helpers; ++i)
+        this->push([state]() { state->run(); });
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state]() { return state->done_chunks == state->num_chunks; });
+
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
+}} // namespace Opm::out
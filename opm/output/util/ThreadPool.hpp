@@ -0,0 +1,124 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_OUTPUT_THREADPOOL_HPP
+#define OPM_OUTPUT_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+namespace out {
+
+    /// Fixed-size pool of worker threads with work stealing.
+    ///
+    /// Every worker owns a task deque.  Tasks submitted from outside
+    /// the pool are distributed round-robin over the deques; tasks
+    /// submitted from a worker go to that worker's own deque.  A
+    /// worker runs its own tasks newest first and steals the oldest
+    /// task from the other deques when it runs dry.
+    ///
+    /// A pool with zero workers runs every task immediately on the
+    /// submitting thread, which makes the serial case trivial.
+    class ThreadPool
+    {
+    public:
+        /// Start pool.
+        ///
+        /// \param[in] numThreads Number of worker threads.
+        explicit ThreadPool(std::size_t numThreads = defaultSize());
+
+        /// Run all remaining tasks, then stop and join the workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Number of worker threads.
+        std::size_t size() const;
+
+        /// Schedule a task for execution.
+        ///
+        /// \param[in] task Callable without arguments.
+        ///
+        /// \return Future holding the task's result, or the exception
+        ///    thrown by the task.
+        template <typename Task>
+        auto submit(Task&& task) -> std::future<decltype(task())>
+        {
+            using Result = decltype(task());
+
+            auto packaged = std::make_shared<std::packaged_task<Result()>>
+                (std::forward<Task>(task));
+
+            auto result = packaged->get_future();
+            this->push([packaged]() { (*packaged)(); });
+
+            return result;
+        }
+
+        /// Run body(first, last) over consecutive sub-ranges of
+        /// [begin, end) with at most \p grain elements each.
+        ///
+        /// The calling thread takes part in the work, so it is safe to
+        /// call this from inside a task running on the same pool.  The
+        /// function returns when the whole range is processed.  If any
+        /// invocation throws, the first exception is rethrown here.
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                         const std::function<void(std::size_t, std::size_t)>& body);
+
+        /// Number of hardware threads, at least one.
+        static std::size_t defaultSize();
+
+        /// Pool without workers, on which all work runs serially on the
+        /// calling thread.
+        ///
+        /// This is the default pool of the output layer, which does not
+        /// start threads of its own: a simulator managing its own threads,
+        /// e.g. one MPI rank per core, passes a pool explicitly to run the
+        /// output in parallel.
+        static ThreadPool& serial();
+
+    private:
+        struct Queue;
+
+        void push(std::function<void()> task);
+        bool tryPop(std::size_t index, std::function<void()>& task);
+        void workerLoop(std::size_t index);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> workers;
+
+        std::mutex wait_mutex;
+        std::condition_variable wake;
+        std::size_t pending = 0;
+        std::size_t next_queue = 0;
+        bool stopping = false;
+    };
+
+}} // namespace Opm::out
+
+#endif // OPM_OUTPUT_THREADPOOL_HPP
@@ -0,0 +1,344 @@
+/*
+   Copyright 2017 Statoil ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <opm/test_util/EclFileDigest.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+
+
+namespace {
+    const char* digest_magic = "ECLDIGEST";
+    // Version 2 adds the optional grid digest.
+    const int digest_version = 2;
+
+    std::vector<double> numericValues(const ecl_kw_type* ecl_kw) {
+        const ecl_type_enum kw_type = ecl_type_get_type(ecl_kw_get_data_type(ecl_kw));
+        std::vector<double> values(ecl_kw_get_size(ecl_kw));
+        if (kw_type == ECL_INT_TYPE) {
+            for (size_t i = 0; i < values.size(); ++i)
+                values[i] = ecl_kw_iget_int(ecl_kw, i);
+        }
+        else {
+            ecl_kw_get_data_as_double(ecl_kw, values.data());
+        }
+        return values;
+    }
+
+    // Non-finite statistics can neither be written nor used as bounds; such
+    // entries are only matched by hash.
+    void dropNonFiniteChunks(ECLFileDigest::Entry& entry) {
+        for (const auto& chunk : entry.chunks) {
+            if (!std::isfinite(chunk.min) || !std::isfinite(chunk.max) || !std::isfinite(chunk.sum)) {
+                entry.chunks.clear();
+                break;
+            }
+        }
+    }
+
+    // Everything of an entry after the keyword name and occurrence.
+    void writeEntry(std::ostream& stream, const ECLFileDigest::Entry& entry) {
+        stream << entry.type << ' ' << entry.size << ' '
+               << std::hex << entry.hash << std::dec << ' '
+               << entry.chunks.size() << '\n';
+        for (const auto& chunk : entry.chunks)
+            stream << chunk.min << ' ' << chunk.max << ' ' << chunk.sum << '\n';
+    }
+
+    void readEntry(std::istream& stream, ECLFileDigest::Entry& entry) {
+        std::size_t numChunks = 0;
+        stream >> entry.type >> entry.size >> std::hex >> entry.hash >> std::dec >> numChunks;
+        if (!stream)
+            return;
+        entry.chunks.resize(numChunks);
+        for (auto& chunk : entry.chunks)
+            stream >> chunk.min >> chunk.max >> chunk.sum;
+    }
+
+    std::string readQuoted(std::istream& stream) {
+        std::string value;
+        stream >> std::ws;
+        if (stream.get() != '\'' || !std::getline(stream, value, '\''))
+            OPM_THROW(std::runtime_error, "Malformed keyword name in digest.");
+        return value;
+    }
+}
+
+
+
+ECLFileDigest::ECLFileDigest(int file_type_arg, std::size_t chunkSize) :
+    file_type(file_type_arg), chunk_size(chunkSize) {}
+
+
+
+ECLFileDigest::Entry ECLFileDigest::digestKeyword(const ecl_kw_type* ecl_kw, std::size_t chunkSize) {
+    Entry entry;
+    const ecl_type_enum kw_type = ecl_type_get_type(ecl_kw_get_data_type(ecl_kw));
+    entry.type = ecl_type_get_name(ecl_kw_get_data_type(ecl_kw));
+    entry.size = ecl_kw_get_size(ecl_kw);
+    entry.hash = hash(ecl_kw_get_ptr(ecl_kw), entry.size * ecl_kw_get_sizeof_ctype(ecl_kw));
+
+    if (chunkSize > 0 && (kw_type == ECL_DOUBLE_TYPE || kw_type == ECL_FLOAT_TYPE || kw_type == ECL_INT_TYPE))
+        entry.chunks = chunkStatistics(numericValues(ecl_kw), chunkSize);
+
+    dropNonFiniteChunks(entry);
+    return entry;
+}
+
+
+
+ECLFileDigest ECLFileDigest::fromFile(ecl_file_type* ecl_file, int file_type, std::size_t chunkSize) {
+    ECLFileDigest digest(file_type, chunkSize);
+    const int numKeywords = ecl_file_get_num_distinct_kw(ecl_file);
+    for (int i = 0; i < numKeywords; ++i) {
+        const char* keyword = ecl_file_iget_distinct_kw(ecl_file, i);
+        const int occurrences = ecl_file_get_num_named_kw(ecl_file, keyword);
+        for (int occurrence = 0; occurrence < occurrences; ++occurrence) {
+            const ecl_kw_type* ecl_kw = ecl_file_iget_named_kw(ecl_file, keyword, occurrence);
+            digest.add(keyword, occurrence, digestKeyword(ecl_kw, chunkSize));
+        }
+    }
+    return digest;
+}
+
+
+
+ECLFileDigest ECLFileDigest::load(const std::string& filename) {
+    std::ifstream stream(filename);
+    if (!stream) {
+        OPM_THROW(std::invalid_argument, "Error opening digest file: " << filename);
+    }
+    return read(stream);
+}
+
+
+
+void ECLFileDigest::save(const std::string& filename) const {
+    std::ofstream stream(filename);
+    if (!stream) {
+        OPM_THROW(std::runtime_error, "Error opening digest file for writing: " << filename);
+    }
+    write(stream);
+    if (!stream) {
+        OPM_THROW(std::runtime_error, "Error writing digest file: " << filename);
+    }
+}
+
+
+
+ECLFileDigest ECLFileDigest::read(std::istream& stream) {
+    std::string magic;
+    int version = 0, file_type = 0;
+    std::size_t chunkSize = 0, numEntries = 0;
+    bool hasGrid = false;
+    stream >> magic >> version >> file_type >> chunkSize >> numEntries;
+    if (!stream || magic != digest_magic) {
+        OPM_THROW(std::runtime_error, "Input is not an ECLIPSE file digest.");
+    }
+    if (version != 1 && version != digest_version) {
+        OPM_THROW(std::runtime_error, "Unsupported digest version " << version << ".");
+    }
+    if (version > 1)
+        stream >> hasGrid;
+
+    ECLFileDigest digest(file_type, chunkSize);
+    for (std::size_t n = 0; n < numEntries; ++n) {
+        Entry entry;
+        const std::string keyword = readQuoted(stream);
+        int occurrence = 0;
+        stream >> occurrence;
+        readEntry(stream, entry);
+
+        if (!stream) {
+            OPM_THROW(std::runtime_error, "Malformed digest entry for keyword " << keyword << ".");
+        }
+        digest.add(keyword, occurrence, entry);
+    }
+
+    if (hasGrid) {
+        stream >> digest.grid.activeCells;
+        readEntry(stream, digest.grid.volumes);
+        if (!stream) {
+            OPM_THROW(std::runtime_error, "Malformed grid digest.");
+        }
+        digest.has_grid = true;
+    }
+    return digest;
+}
+
+
+
+void ECLFileDigest::write(std::ostream& stream) const {
+    stream << digest_magic << ' ' << digest_version << ' ' << file_type << ' '
+           << chunk_size << ' ' << entries.size() << ' ' << has_grid << '\n';
+    stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& it : entries) {
+        stream << '\'' << it.first.first << "' " << it.first.second << ' ';
+        writeEntry(stream, it.second);
+    }
+    if (has_grid) {
+        stream << grid.activeCells << ' ';
+        writeEntry(stream, grid.volumes);
+    }
+}
+
+
+
+void ECLFileDigest::add(const std::string& keyword, int occurrence, const Entry& entry) {
+    entries[std::make_pair(keyword, occurrence)] = entry;
+}
+
+
+
+const ECLFileDigest::Entry* ECLFileDigest::find(const std::string& keyword, int occurrence) const {
+    const auto it = entries.find(std::make_pair(keyword, occurrence));
+    if (it == entries.end())
+        return nullptr;
+    return &it->second;
+}
+
+
+
+std::vector<std::string> ECLFileDigest::keywords() const {
+    std::vector<std::string> result;
+    for (const auto& it : entries) {
+        if (result.empty() || result.back() != it.first.first)
+            result.push_back(it.first.first);
+    }
+    return result;
+}
+
+
+
+int ECLFileDigest::numOccurrences(const std::string& keyword) const {
+    const auto begin = entries.lower_bound(std::make_pair(keyword, std::numeric_limits<int>::min()));
+    const auto end = entries.upper_bound(std::make_pair(keyword, std::numeric_limits<int>::max()));
+    return std::distance(begin, end);
+}
+
+
+
+void ECLFileDigest::setGrid(const ecl_grid_type* ecl_grid) {
+    const std::vector<double> volumes = cellVolumes(ecl_grid);
+    grid.activeCells = ecl_grid_get_active_size(ecl_grid);
+    grid.volumes.type = "DOUB";
+    grid.volumes.size = volumes.size();
+    grid.volumes.hash = hash(volumes.data(), volumes.size() * sizeof(double));
+    grid.volumes.chunks = chunkStatistics(volumes, chunk_size);
+    dropNonFiniteChunks(grid.volumes);
+    has_grid = true;
+}
+
+
+
+std::vector<double> ECLFileDigest::cellVolumes(const ecl_grid_type* ecl_grid) {
+    std::vector<double> volumes(ecl_grid_get_global_size(ecl_grid));
+    for (std::size_t cell = 0; cell < volumes.size(); ++cell)
+        volumes[cell] = ecl_grid_get_cell_volume1(ecl_grid, cell);
+    return volumes;
+}
+
+
+
+std::uint64_t ECLFileDigest::hash(const void* data, std::size_t bytes) {
+    const unsigned char* ptr = static_cast<const unsigned char*>(data);
+    std::uint64_t value = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value ^= ptr[i];
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+
+
+std::vector<ECLFileDigest::Chunk> ECLFileDigest::chunkStatistics(const std::vector<double>& values, std::size_t chunkSize) {
+    std::vector<Chunk> chunks;
+    if (chunkSize == 0)
+        return chunks;
+
+    chunks.reserve((values.size() + chunkSize - 1) / chunkSize);
+    for (std::size_t begin = 0; begin < values.size(); begin += chunkSize) {
+        const std::size_t end = std::min(begin + chunkSize, values.size());
+        Chunk chunk;
+        chunk.min = chunk.max = values[begin];
+        for (std::size_t i = begin; i < end; ++i) {
+            chunk.min = std::min(chunk.min, values[i]);
+            chunk.max = std::max(chunk.max, values[i]);
+            chunk.sum += values[i];
+        }
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+
+
+bool ECLFileDigest::withinTolerance(const std::vector<double>& values, const std::vector<Chunk>& chunks,
+                                    std::size_t chunkSize, double absTolerance, bool clampNegatives) {
+    if (chunkSize == 0 || chunks.size() != (values.size() + chunkSize - 1) / chunkSize)
+        return false;
+
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+        const std::size_t begin = c * chunkSize;
+        const std::size_t end = std::min(begin + chunkSize, values.size());
+        double min = chunks[c].min;
+        double max = chunks[c].max;
+
+        if (clampNegatives) {
+            if (!(min >= -absTolerance))
+                return false;
+            min = std::max(min, 0.0);
+            max = std::max(max, 0.0);
+        }
+        else {
+            // Cheap rejection: if the sums differ by more than the tolerance
+            // times the number of values, some value is out of tolerance.
+            double sum = 0;
+            for (std::size_t i = begin; i < end; ++i)
+                sum += values[i];
+            if (!(std::abs(sum - chunks[c].sum) <= absTolerance * (end - begin)))
+                return false;
+        }
+
+        for (std::size_t i = begin; i < end; ++i) {
+            double value = values[i];
+            if (clampNegatives) {
+                if (value < -absTolerance)
+                    return false;
+                value = std::max(value, 0.0);
+            }
+            // Written so that NaN values are never cleared.
+            if (!(std::abs(value - min) <= absTolerance && std::abs(value - max) <= absTolerance))
+                return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,137 @@
+/*
+   Copyright 2017 Statoil ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef ECLFILEDIGEST_HPP
+#define ECLFILEDIGEST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ecl_file_struct; //!< Prototype for eclipse file struct, from ERT library.
+typedef struct ecl_file_struct ecl_file_type;
+struct ecl_kw_struct; //!< Prototype for eclipse keyword struct, from ERT library.
+typedef struct ecl_kw_struct ecl_kw_type;
+struct ecl_grid_struct; //!< Prototype for eclipse grid struct, from ERT library.
+typedef struct ecl_grid_struct ecl_grid_type;
+
+
+/*! \brief Compact digest of an ECLIPSE result file.
+    \details An ECLFileDigest stores, for every keyword occurrence of a file,
+             the data type, the number of elements and a hash of the raw
+             payload. For numeric keywords it additionally stores min, max
+             and sum for each chunk of chunkSize() consecutive elements.
+             A digest of a reference case can be written to disk once and
+             then used by RegressionTest in place of the reference payload:
+             occurrences with an identical hash, or with values provably
+             within the absolute tolerance of the chunk bounds, are cleared
+             without loading the reference data. The digest can also hold
+             the cell volumes of the grid of the case, for gridCompare(). */
+class ECLFileDigest {
+    public:
+        //! \brief Statistics for one chunk of consecutive values.
+        struct Chunk {
+            double min = 0;
+            double max = 0;
+            double sum = 0;
+        };
+
+        //! \brief Digest of a single keyword occurrence.
+        struct Entry {
+            std::string type;          //!< ECLIPSE type name, e.g. REAL or INTE.
+            std::size_t size = 0;      //!< Number of elements.
+            std::uint64_t hash = 0;    //!< Hash of the raw payload, see hash().
+            std::vector<Chunk> chunks; //!< Chunk statistics, empty for non-numeric keywords.
+        };
+
+        //! \brief Digest of the grid of a case.
+        struct Grid {
+            std::size_t activeCells = 0; //!< Number of active cells.
+            Entry volumes;               //!< Digest of the cell volumes, indexed by global index.
+        };
+
+        //! \brief Create an empty digest.
+        //! \param[in] file_type ECLIPSE file type the digest describes.
+        //! \param[in] chunkSize Number of values per chunk, zero disables chunk statistics.
+        ECLFileDigest(int file_type, std::size_t chunkSize);
+
+        //! \brief Build a digest of every keyword occurrence in an open ECLIPSE file.
+        static ECLFileDigest fromFile(ecl_file_type* ecl_file, int file_type, std::size_t chunkSize);
+        //! \brief Build the digest of a single keyword.
+        static Entry digestKeyword(const ecl_kw_type* ecl_kw, std::size_t chunkSize);
+
+        //! \brief Read a digest from file, throws if the file is missing or malformed.
+        static ECLFileDigest load(const std::string& filename);
+        //! \brief Write the digest to file.
+        void save(const std::string& filename) const;
+
+        //! \brief Read a digest from a stream.
+        static ECLFileDigest read(std::istream& stream);
+        //! \brief Write the digest to a stream.
+        void write(std::ostream& stream) const;
+
+        //! \brief Add or replace the entry for a keyword occurrence.
+        void add(const std::string& keyword, int occurrence, const Entry& entry);
+        //! \brief Returns the entry for a keyword occurrence, or nullptr if it is not in the digest.
+        const Entry* find(const std::string& keyword, int occurrence) const;
+        //! \brief Returns the number of keyword occurrences in the digest.
+        std::size_t size() const { return entries.size(); }
+        //! \brief Returns the distinct keywords in the digest, in alphabetical order.
+        std::vector<std::string> keywords() const;
+        //! \brief Returns the number of occurrences of a keyword in the digest.
+        int numOccurrences(const std::string& keyword) const;
+
+        //! \brief Add a digest of the grid of the case.
+        void setGrid(const ecl_grid_type* ecl_grid);
+        //! \brief Returns the digest of the grid, or nullptr if the digest has none.
+        const Grid* getGrid() const { return has_grid ? &grid : nullptr; }
+
+        int getFileType() const { return file_type; }
+        std::size_t chunkSize() const { return chunk_size; }
+
+        //! \brief 64 bit FNV-1a hash of a byte sequence.
+        static std::uint64_t hash(const void* data, std::size_t bytes);
+        //! \brief Calculate min, max and sum for each chunk of chunkSize consecutive values.
+        static std::vector<Chunk> chunkStatistics(const std::vector<double>& values, std::size_t chunkSize);
+        //! \brief Cell volumes of a grid, indexed by global index.
+        static std::vector<double> cellVolumes(const ecl_grid_type* ecl_grid);
+        //! \brief Check whether all values are within the absolute tolerance of every value the reference chunks admit.
+        //! \param[in] values Candidate values.
+        //! \param[in] chunks Chunk statistics of the reference values.
+        //! \param[in] chunkSize Number of values per chunk.
+        //! \param[in] absTolerance Tolerance for absolute deviation.
+        //! \param[in] clampNegatives Treat negative values as zero, and reject values below -absTolerance, as done by RegressionTest for SGAS, SWAT and PRESSURE.
+        //! \details For a reference value r in [min, max] and a candidate value c, |c - r| is bounded by max(|c - min|, |c - max|).
+        //!          The function returns true only if this bound is within absTolerance for every value, i.e. if the regression test can not fail.
+        static bool withinTolerance(const std::vector<double>& values, const std::vector<Chunk>& chunks,
+                                    std::size_t chunkSize, double absTolerance, bool clampNegatives);
+
+    private:
+        int file_type;
+        std::size_t chunk_size;
+        std::map<std::pair<std::string, int>, Entry> entries;
+        bool has_grid = false;
+        Grid grid;
+};
+
+#endif
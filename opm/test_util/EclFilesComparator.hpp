@@ -20,6 +20,8 @@
 #ifndef ECLFILESCOMPARATOR_HPP
 #define ECLFILESCOMPARATOR_HPP
 
+#include <iostream>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -31,6 +33,7 @@ typedef struct ecl_grid_struct ecl_grid_type;
 struct ecl_kw_struct; //!< Prototype for eclipse keyword struct, from ERT library.
 typedef struct ecl_kw_struct ecl_kw_type;
 
+class ECLFileDigest;
 
 /*! \brief Deviation struct.
     \details The member variables are default initialized to -1,
@@ -54,19 +57,36 @@ class ECLFilesComparator {
         int file_type;
         double absTolerance      = 0;
         double relTolerance      = 0;
+
+        // The second case is opened, and its grid loaded, on first use; see secondFile() and secondGrid().
+        std::string basename2, file2;
+        mutable ecl_file_type* ecl_file2 = nullptr;
+        mutable std::shared_ptr<ecl_grid_type> grid2;
+        mutable std::vector<std::string> keywords2;
     protected:
         ecl_file_type* ecl_file1 = nullptr;
         ecl_grid_type* ecl_grid1 = nullptr;
-        ecl_file_type* ecl_file2 = nullptr;
-        ecl_grid_type* ecl_grid2 = nullptr;
-        std::vector<std::string> keywords1, keywords2;
+        std::shared_ptr<ecl_grid_type> grid1; //!< Owner of ecl_grid1, possibly shared with other comparators.
+        std::vector<std::string> keywords1;
         bool throwOnError = true; //!< Throw on first error
         mutable size_t num_errors = 0;
+        std::ostream* output = &std::cout;      //!< Progress and deviation messages.
+        std::ostream* errorOutput = &std::cerr; //!< Error messages.
+
+        //! \brief Returns the file of the second case, which is opened on the first call.
+        //! \details Throws an exception if the file can not be opened.
+        ecl_file_type* secondFile() const;
+        //! \brief Returns the grid of the second case, which is loaded on the first call unless it was given to the constructor.
+        ecl_grid_type* secondGrid() const;
+        //! \brief Returns the keywords of the second case, see secondFile().
+        const std::vector<std::string>& secondKeywords() const;
 
         //! \brief Checks if the keyword exists in both cases.
         //! \param[in] keyword Keyword to check.
         //! \details If the keyword does not exist in one of the cases, the function throws an exception.
         void keywordValidForComparing(const std::string& keyword) const;
+        //! \brief Same as above, with the keywords of the second case given.
+        void keywordValidForComparing(const std::string& keyword, const std::vector<std::string>& secondKeywords) const;
         //! \brief Stores keyword data for a given occurrence
         //! \param[out] ecl_kw1 Pointer to a ecl_kw_type, which stores keyword data for first case given the occurrence.
         //! \param[out] ecl_kw2 Pointer to a ecl_kw_type, which stores keyword data for second case given the occurrence.
@@ -91,13 +111,22 @@ class ECLFilesComparator {
         //! \param[in] basename2 Full path without file extension to the second case.
         //! \param[in] absTolerance Tolerance for absolute deviation.
         //! \param[in] relTolerance Tolerance for relative deviation.
-        //! \details The content of the ECLIPSE files specified in the input is stored in the ecl_file_type and ecl_grid_type member variables. In addition the keywords and absolute and relative tolerances (member variables) are set. If the constructor is unable to open one of the ECLIPSE files, an exception will be thrown.
+        //! \details The first case is opened and its grid loaded by the constructor, and the keywords and absolute and relative tolerances (member variables) are set. If the constructor is unable to open one of the ECLIPSE files of the first case, an exception will be thrown. The second case is only opened when its data is needed, see secondFile() and secondGrid().
         ECLFilesComparator(int file_type, const std::string& basename1, const std::string& basename2, double absTolerance, double relTolerance);
+        //! \brief Open ECLIPSE files using grids which are already loaded.
+        //! \param[in] grid1 Grid of the first case, see loadGrid().
+        //! \param[in] grid2 Grid of the second case, see loadGrid(), or nullptr to load it on first use.
+        //! \details Same as the constructor above, except that the grids are not loaded from disk. The grids are only read, so the same grid can be shared by several comparators, also in different threads.
+        ECLFilesComparator(int file_type, const std::string& basename1, const std::string& basename2,
+                           std::shared_ptr<ecl_grid_type> grid1, std::shared_ptr<ecl_grid_type> grid2,
+                           double absTolerance, double relTolerance);
         //! \brief Closing the ECLIPSE files.
         ~ECLFilesComparator();
 
         //! \brief Set whether to throw on errors or not.
         void throwOnErrors(bool dothrow) { throwOnError = dothrow; }
+        //! \brief Write the messages of the comparisons to out, and the error messages to err.
+        void setOutput(std::ostream& out, std::ostream& err) { output = &out; errorOutput = &err; }
 
         //! \brief Returns the number of errors encountered in the performed comparisons.
         size_t getNoErrors() const { return num_errors; }
@@ -114,6 +143,11 @@ class ECLFilesComparator {
         //! \brief Print common and uncommon keywords for the two input cases.
         void printKeywordsDifference() const;
 
+        //! \brief Load the grid (.EGRID or .GRID) of a case.
+        //! \param[in] basename Full path without file extension to the case.
+        //! \details Throws an exception if no grid can be loaded.
+        static std::shared_ptr<ecl_grid_type> loadGrid(const std::string& basename);
+
         //! \brief Calculate deviations for two values.
         //! \details Using absolute values of the input arguments: If one of the values are non-zero, the Deviation::abs returned is the difference between the two input values. In addition, if both values are non-zero, the Deviation::rel returned is the absolute deviation divided by the largest value.
         static Deviation calculateDeviations(double val1, double val2);
@@ -145,6 +179,17 @@ class RegressionTest: public ECLFilesComparator {
         // Only compare last occurrence
         bool onlyLastOccurrence = false;
 
+        // Digest of the second case, used to clear occurrences without reading the reference data.
+        std::shared_ptr<const ECLFileDigest> referenceDigest;
+        mutable size_t num_cleared = 0;
+
+        // Returns true if the occurrence in the first file is identical to, or provably within the absolute tolerance of,
+        // the reference occurrence described by referenceDigest. Only the first file is read.
+        bool clearedByDigest(const std::string& keyword, int occurrence1, int occurrence2, bool allowNegativeValues = true) const;
+        // Keywords and occurrences of the second case, from referenceDigest if it is set so that the second case is not opened.
+        std::vector<std::string> referenceKeywords() const;
+        unsigned int referenceOccurrences(const std::string& keyword) const;
+
         // Prints results stored in absDeviation and relDeviation.
         void printResultsForKeyword(const std::string& keyword) const;
 
@@ -170,10 +215,27 @@ class RegressionTest: public ECLFilesComparator {
         //! \details This constructor only calls the constructor of the superclass, see the docs for ECLFilesComparator for more information.
         RegressionTest(int file_type, const std::string& basename1, const std::string& basename2, double absTolerance, double relTolerance):
             ECLFilesComparator(file_type, basename1, basename2, absTolerance, relTolerance) {}
+        //! \brief Sets up the regression test with grids which are already loaded.
+        //! \details See the corresponding constructor of ECLFilesComparator.
+        RegressionTest(int file_type, const std::string& basename1, const std::string& basename2,
+                       std::shared_ptr<ecl_grid_type> grid1Arg, std::shared_ptr<ecl_grid_type> grid2Arg,
+                       double absTolerance, double relTolerance):
+            ECLFilesComparator(file_type, basename1, basename2, grid1Arg, grid2Arg, absTolerance, relTolerance) {}
 
         //! \brief Option to only compare last occurrence
         void setOnlyLastOccurrence(bool onlyLastOccurrenceArg) {this->onlyLastOccurrence = onlyLastOccurrenceArg;}
 
+        //! \brief Use a digest of the second case to skip comparisons.
+        //! \param[in] digest Digest created from the second case, see ECLFileDigest.
+        //! \details Keyword occurrences whose payload hash matches the digest, or whose values are within the absolute tolerance of
+        //!          the chunk bounds in the digest, are cleared without loading the data from the second case. Cleared occurrences
+        //!          do not contribute to the printed deviation statistics. The keywords and number of occurrences of the second case
+        //!          are taken from the digest, and if the digest has a grid, gridCompare() uses it in the same way; the second case is
+        //!          only opened if some comparison is not cleared. An exception is thrown if the digest describes another file type.
+        void setReferenceDigest(std::shared_ptr<const ECLFileDigest> digest);
+        //! \brief Returns the number of keyword occurrences cleared by the reference digest.
+        size_t getNoClearedByDigest() const { return num_cleared; }
+
         //! \brief Compares grid properties of the two cases.
         // gridCompare() checks if both the number of active and global cells in the two cases are the same. If they are, all cells are looped over to calculate the cell volume deviation for the two cases. If the both the relative and absolute deviation exceeds the tolerances, an exception is thrown.
         void gridCompare() const;
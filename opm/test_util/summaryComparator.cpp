@@ -160,7 +160,7 @@ void SummaryComparator::printUnits(){
     setTimeVecs(timeVec1, timeVec2);  // Sets the time vectors, they are equal for all keywords (WPOR:PROD01 etc)
     setDataSets(timeVec1, timeVec2);
     for (int jvar = 0; jvar < stringlist_get_size(keysLong); jvar++){
-        std::cout << stringlist_iget(keysLong, jvar) << " unit: " << ecl_sum_get_unit(ecl_sum_fileShort, stringlist_iget(keysLong, jvar)) << std::endl;
+        *output << stringlist_iget(keysLong, jvar) << " unit: " << ecl_sum_get_unit(ecl_sum_fileShort, stringlist_iget(keysLong, jvar)) << std::endl;
     }
 }
 
@@ -174,11 +174,11 @@ const char* SummaryComparator::getUnit(const char* keyword){
 void SummaryComparator::printKeywords(){
     int ivar = 0;
     std::vector<std::string> noMatchString;
-    std::cout << "Keywords that are common for the files:" << std::endl;
+    *output << "Keywords that are common for the files:" << std::endl;
     while(ivar < stringlist_get_size(keysLong)){
         const char* keyword = stringlist_iget(keysLong, ivar);
         if (stringlist_contains(keysLong, keyword) && stringlist_contains(keysShort, keyword)){
-            std::cout << keyword << std::endl;
+            *output << keyword << std::endl;
             ivar++;
         }
         else{
@@ -187,13 +187,13 @@ void SummaryComparator::printKeywords(){
         }
     }
     if(noMatchString.size() == 0){
-        std::cout << "No keywords were different" << std::endl;
+        *output << "No keywords were different" << std::endl;
         return;
     }
-    std::cout << "Keywords that are different: " << std::endl;
-    for (const auto& it : noMatchString) std::cout << it << std::endl;
+    *output << "Keywords that are different: " << std::endl;
+    for (const auto& it : noMatchString) *output << it << std::endl;
 
-    std::cout << "\nOf the " << stringlist_get_size(keysLong) << " keywords " << stringlist_get_size(keysLong)-noMatchString.size() << " were equal and " << noMatchString.size() << " were different" << std::endl;
+    *output << "\nOf the " << stringlist_get_size(keysLong) << " keywords " << stringlist_get_size(keysLong)-noMatchString.size() << " were equal and " << noMatchString.size() << " were different" << std::endl;
 }
 
 
@@ -208,30 +208,30 @@ void SummaryComparator::printDataOfSpecificKeyword(const std::vector<double>& ti
     size_t jvar = 0;
     const char separator = ' ';
     const int numWidth = 14;
-    std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << "Time";
-    std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << "Ref data";
-    std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << "Check data" << std::endl;
+    *output << std::left << std::setw(numWidth) << std::setfill(separator) << "Time";
+    *output << std::left << std::setw(numWidth) << std::setfill(separator) << "Ref data";
+    *output << std::left << std::setw(numWidth) << std::setfill(separator) << "Check data" << std::endl;
 
     while(ivar < referenceVec->size()){
         if(ivar == referenceVec->size() || jvar == checkVec->size() ){
             break;
         }
         if((*referenceVec)[ivar] == (*checkVec)[jvar]){
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceVec)[ivar];
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceDataVec)[ivar];
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << (*checkDataVec)[jvar] << std::endl;
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceVec)[ivar];
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceDataVec)[ivar];
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << (*checkDataVec)[jvar] << std::endl;
             ivar++;
             jvar++;
         }else if((*referenceVec)[ivar] < (*checkVec)[jvar]){
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceVec)[ivar];
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceDataVec)[ivar];
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << "" << std::endl;
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceVec)[ivar];
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << (*referenceDataVec)[ivar];
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << "" << std::endl;
             ivar++;
         }
         else{
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << (*checkVec)[jvar];
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << "";
-            std::cout << std::left << std::setw(numWidth) << std::setfill(separator) << (*checkDataVec)[jvar] << std::endl;
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << (*checkVec)[jvar];
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << "";
+            *output << std::left << std::setw(numWidth) << std::setfill(separator) << (*checkDataVec)[jvar] << std::endl;
             jvar++;
         }
     }
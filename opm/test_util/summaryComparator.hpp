@@ -33,7 +33,7 @@
     if (throwOnError) \
       OPM_THROW(type, message); \
     else \
-      std::cerr << message << std::endl; \
+      *errorOutput << message << std::endl; \
   }
 
 
@@ -73,6 +73,8 @@ class SummaryComparator {
         bool printKeyword = false; //!< Boolean value for choosing whether to print the keywords or not
         bool printSpecificKeyword = false; //!< Boolean value for choosing whether to print the vectors of a keyword or not
         bool throwOnError = true; //!< Throw on first error
+        std::ostream* output = &std::cout;      //!< Progress and deviation messages.
+        std::ostream* errorOutput = &std::cerr; //!< Error messages.
 
         //! \brief Calculate deviation between two data values and stores it in a Deviation struct.
         //! \param[in] refIndex Index in reference data
@@ -175,6 +177,9 @@ class SummaryComparator {
 
         //! \brief Set whether to throw on errors or not.
         void throwOnErrors(bool dothrow) { throwOnError = dothrow; }
+
+        //! \brief Write the messages of the comparisons to out, and the error messages to err.
+        void setOutput(std::ostream& out, std::ostream& err) { output = &out; errorOutput = &err; }
 };
 
 #endif
@@ -78,13 +78,13 @@ void IntegrationTest::getIntegrationTest(){
         ivar++;
     }
     if(findVectorWithGreatestErrorRatio){
-        std::cout << "The keyword " << keywordWithGreatestErrorRatio << " had the greatest error ratio, which was " << greatestRatio << std::endl;
+        *output << "The keyword " << keywordWithGreatestErrorRatio << " had the greatest error ratio, which was " << greatestRatio << std::endl;
     }
     if((findVolumeError || oneOfTheMainVariables) && !findVectorWithGreatestErrorRatio){
         evaluateWellProductionVolume();
     }
     if(allowSpikes){
-        std::cout << "checkWithSpikes succeeded." << std::endl;
+        *output << "checkWithSpikes succeeded." << std::endl;
     }
 }
 
@@ -101,11 +101,11 @@ void IntegrationTest::getIntegrationTest(const char* keyword){
         if(findVolumeError){
             WellProductionVolume volume = getSpecificWellVolume(timeVec1, timeVec2, keyword);
             if(volume.error == 0){
-                std::cout << "For keyword " << keyword << " the total production volume is 0" << std::endl;
+                *output << "For keyword " << keyword << " the total production volume is 0" << std::endl;
             }
             else{
-                std::cout << "For keyword " << keyword << " the total production volume is "<< volume.total;
-                std::cout << ", the error volume is " << volume.error << " the error ratio is " << volume.error/volume.total << std::endl;
+                *output << "For keyword " << keyword << " the total production volume is "<< volume.total;
+                *output << ", the error volume is " << volume.error << " the error ratio is " << volume.error/volume.total << std::endl;
             }
         }
         checkForKeyword(timeVec1, timeVec2, keyword);
@@ -246,22 +246,22 @@ void IntegrationTest::evaluateWellProductionVolume(){
         ratioWWP = WWP.error/WWP.total;
         ratioWGP = WGP.error/WGP.total;
         ratioWBHP = WBHP.error/WBHP.total;
-        std::cout << "\n The total oil volume is " << WOP.total << ". The error volume is "<< WOP.error <<  ". The error ratio is " << ratioWOP << std::endl;
-        std::cout << "\n The total water volume is " << WWP.total << ". The error volume is "<< WWP.error <<  ". The error ratio is " << ratioWWP << std::endl;
-        std::cout << "\n The total gas volume is " << WGP.total <<". The error volume is "<< WGP.error <<  ". The error ratio is " << ratioWGP << std::endl;
-        std::cout << "\n The total area under the WBHP curve is " << WBHP.total << ". The area under the error curve is "<< WBHP.error <<  ". The error ratio is " << ratioWBHP << std::endl << std::endl;
+        *output << "\n The total oil volume is " << WOP.total << ". The error volume is "<< WOP.error <<  ". The error ratio is " << ratioWOP << std::endl;
+        *output << "\n The total water volume is " << WWP.total << ". The error volume is "<< WWP.error <<  ". The error ratio is " << ratioWWP << std::endl;
+        *output << "\n The total gas volume is " << WGP.total <<". The error volume is "<< WGP.error <<  ". The error ratio is " << ratioWGP << std::endl;
+        *output << "\n The total area under the WBHP curve is " << WBHP.total << ". The area under the error curve is "<< WBHP.error <<  ". The error ratio is " << ratioWBHP << std::endl << std::endl;
     }
     if(mainVariable == "WOPR"){
-        std::cout << "\nThe total oil volume is " << WOP.total << ". The error volume is "<< WOP.error <<  ". The error ratio is " << WOP.error/WOP.total << std::endl<< std::endl;
+        *output << "\nThe total oil volume is " << WOP.total << ". The error volume is "<< WOP.error <<  ". The error ratio is " << WOP.error/WOP.total << std::endl<< std::endl;
     }
     if(mainVariable == "WWPR"){
-        std::cout << "\nThe total water volume is " << WWP.total << ". The error volume is "<< WWP.error <<  ". The error ratio is " << WWP.error/WWP.total << std::endl<< std::endl;
+        *output << "\nThe total water volume is " << WWP.total << ". The error volume is "<< WWP.error <<  ". The error ratio is " << WWP.error/WWP.total << std::endl<< std::endl;
     }
     if(mainVariable == "WGPR"){
-        std::cout << "\nThe total gas volume is " << WGP.total <<". The error volume is "<< WGP.error <<  ". The error ratio is " << WGP.error/WGP.total << std::endl<< std::endl;
+        *output << "\nThe total gas volume is " << WGP.total <<". The error volume is "<< WGP.error <<  ". The error ratio is " << WGP.error/WGP.total << std::endl<< std::endl;
     }
     if(mainVariable == "WBHP"){
-        std::cout << "\nThe total area under the WBHP curve " << WBHP.total << ". The area under the error curve is "<< WBHP.error <<  ". The error ratio is " << WBHP.error/WBHP.total << std::endl << std::endl;
+        *output << "\nThe total area under the WBHP curve " << WBHP.total << ". The area under the error curve is "<< WBHP.error <<  ". The error ratio is " << WBHP.error/WBHP.total << std::endl << std::endl;
     }
 }
 
@@ -283,11 +283,11 @@ void IntegrationTest::checkWithSpikes(const char* keyword){
             spikeCurrent = false;
         }
         if(spikePrev&&spikeCurrent){
-            std::cout << "For keyword " << keyword << " at time step " << (*referenceVec)[ivar] <<std::endl;
+            *output << "For keyword " << keyword << " at time step " << (*referenceVec)[ivar] <<std::endl;
             OPM_THROW(std::invalid_argument, "For keyword " << keyword << " at time step " << (*referenceVec)[ivar] << ", wwo deviations in a row exceed the limit. Not a spike value. Integration test fails." );
         }
         if(errorOccurrences > this->spikeLimit){
-            std::cout << "For keyword " << keyword << std::endl;
+            *output << "For keyword " << keyword << std::endl;
             OPM_THROW(std::invalid_argument, "For keyword " << keyword << " too many spikes in the vector. Integration test fails.");
         }
     }
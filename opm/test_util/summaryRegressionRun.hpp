@@ -0,0 +1,40 @@
+/*
+   Copyright 2017 Statoil ASA.
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SUMMARYREGRESSIONRUN_HPP
+#define SUMMARYREGRESSIONRUN_HPP
+
+#include <iosfwd>
+#include <string>
+
+//! \brief Runs the summary regression test of compareSummary for all keywords of two cases.
+//! \param[in] basename1 Path to the first case without extension.
+//! \param[in] basename2 Path to the second case without extension.
+//! \param[in] absoluteTolerance The absolute tolerance which is to be used in the test.
+//! \param[in] relativeTolerance The relative tolerance which is to be used in the test.
+//! \param[in] isRestartFile Whether the first case is a restarted simulation.
+//! \param[in] out Stream for the messages of the comparison.
+//! \param[in] err Stream for the error messages of the comparison.
+//! \details The summary RegressionTest class shares its name with the RegressionTest class for ECLIPSE files,
+//!          so programs using both, such as compareECLBatch, call this function instead. Throws an exception on the first
+//!          deviation exceeding the tolerances.
+void runSummaryRegressionTest(const std::string& basename1, const std::string& basename2,
+                              double absoluteTolerance, double relativeTolerance,
+                              bool isRestartFile, std::ostream& out, std::ostream& err);
+
+#endif
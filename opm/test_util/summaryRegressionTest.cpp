@@ -17,6 +17,7 @@
    */
 
 #include <opm/test_util/summaryRegressionTest.hpp>
+#include <opm/test_util/summaryRegressionRun.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <ert/ecl/ecl_sum.h>
 #include <ert/util/stringlist.h>
@@ -26,23 +27,23 @@ void RegressionTest::getRegressionTest(){
     std::vector<double> timeVec1, timeVec2;
     setTimeVecs(timeVec1, timeVec2);  // Sets the time vectors, they are equal for all keywords (WPOR:PROD01 etc)
     setDataSets(timeVec1, timeVec2); //Figures which dataset that contains more/less values pr keyword vector.
-    std::cout << "Comparing " << timeVec1.size() << " steps." << std::endl;
+    *output << "Comparing " << timeVec1.size() << " steps." << std::endl;
     int ivar = 0;
     if(stringlist_get_size(keysShort) != stringlist_get_size(keysLong)){
         int missing_count = 0;
-        std::cout << "Keywords missing from one case: " << std::endl;
+        *output << "Keywords missing from one case: " << std::endl;
 
         for (int i=0; i < stringlist_get_size( keysLong); i++) {
             const char * key = stringlist_iget( keysLong , i );
             if (!stringlist_contains( keysShort , key)) {
-                std::cout << key << " ";
+                *output << key << " ";
 
                 missing_count++;
                 if ((missing_count % 8) == 0)
-                    std::cout << std::endl;
+                    *output << std::endl;
             }
         }
-        std::cout << std::endl;
+        *output << std::endl;
 
         HANDLE_ERROR(std::runtime_error, "Different amount of keywords in the two summary files.");
     }
@@ -66,7 +67,7 @@ void RegressionTest::getRegressionTest(){
             }
             //will only enter here if no keyword match
             if(jvar == stringlist_get_size(keysLong)-1){
-                std::cout << "Could not find keyword: " << stringlist_iget(keysShort, ivar) << std::endl;
+                *output << "Could not find keyword: " << stringlist_iget(keysShort, ivar) << std::endl;
                 OPM_THROW(std::runtime_error, "No match on keyword");
             }
         }
@@ -75,7 +76,7 @@ void RegressionTest::getRegressionTest(){
     if (throwAtEnd)
       OPM_THROW(std::runtime_error, "Regression test failed.");
     else
-      std::cout << "Regression test succeeded." << std::endl;
+      *output << "Regression test succeeded." << std::endl;
 }
 
 
@@ -90,13 +91,13 @@ void RegressionTest::getRegressionTest(const char* keyword){
             return;
         }
         if (checkForKeyword(timeVec1, timeVec2, keyword))
-          std::cout << "Regression test succeeded." << std::endl;
+          *output << "Regression test succeeded." << std::endl;
         else
           OPM_THROW(std::runtime_error, "Regression test failed");
 
         return;
     }
-    std::cout << "The keyword suggested, " << keyword << ", is not supported by one or both of the summary files. Please use a different keyword." << std::endl;
+    *output << "The keyword suggested, " << keyword << ", is not supported by one or both of the summary files. Please use a different keyword." << std::endl;
     OPM_THROW(std::runtime_error, "Input keyword from user does not exist in/is not common for the two summary files.");
 }
 
@@ -107,12 +108,12 @@ bool RegressionTest::checkDeviation(Deviation deviation, const char* keyword, in
     double relTol = getRelTolerance();
 
     if (deviation.rel > relTol && deviation.abs > absTol){
-        std::cout << "For keyword " << keyword  << std::endl;
-        std::cout << "(days, reference value) and (days, check value) = (" << (*referenceVec)[refIndex] << ", " << (*referenceDataVec)[refIndex]
+        *output << "For keyword " << keyword  << std::endl;
+        *output << "(days, reference value) and (days, check value) = (" << (*referenceVec)[refIndex] << ", " << (*referenceDataVec)[refIndex]
             << ") and (" << (*checkVec)[checkIndex-1] << ", " << (*checkDataVec)[checkIndex-1] << ")\n";
         // -1 in [checkIndex -1] because checkIndex is updated after leaving getDeviation function
-        std::cout << "The absolute deviation is " << deviation.abs << ". The tolerance limit is " << absTol << std::endl;
-        std::cout << "The relative deviation is " << deviation.rel << ". The tolerance limit is " << relTol << std::endl;
+        *output << "The absolute deviation is " << deviation.abs << ". The tolerance limit is " << absTol << std::endl;
+        *output << "The relative deviation is " << deviation.rel << ". The tolerance limit is " << relTol << std::endl;
         HANDLE_ERROR(std::runtime_error, "Deviation exceed the limit.");
         return false;
     }
@@ -141,3 +142,14 @@ bool RegressionTest::startTest(const char* keyword){
 
     return result;
 }
+
+
+
+void runSummaryRegressionTest(const std::string& basename1, const std::string& basename2,
+                              double absoluteTolerance, double relativeTolerance,
+                              bool isRestartFile, std::ostream& out, std::ostream& err) {
+    RegressionTest compare(basename1.c_str(), basename2.c_str(), absoluteTolerance, relativeTolerance);
+    compare.setOutput(out, err);
+    compare.setIsRestartFile(isRestartFile);
+    compare.getRegressionTest();
+}
@@ -17,6 +17,7 @@
    */
 
 #include <opm/test_util/EclFilesComparator.hpp>
+#include <opm/test_util/EclFileDigest.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
 #include <ert/util/util.h>
@@ -25,6 +26,7 @@
 #include <ert/ecl/ecl_file.h>
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <getopt.h>
 
@@ -36,6 +38,12 @@ static void printHelp() {
         << "3. Absolute tolerance\n"
         << "4. Relative tolerance (between 0 and 1)\n\n"
         << "In addition, the program takes these options (which must be given before the arguments):\n\n"
+        << "-d Use the digest file given as argument for the second case, see -D. Keyword occurrences which are identical to the second case,\n"
+        << "   or which are within the absolute tolerance of the value ranges stored in the digest, are cleared without reading the second case.\n"
+        << "   Can not be used in combination with -i or -I.\n"
+        << "-D Write a digest of the second case to the file given as argument and exit. The digest stores a hash, the size and min/max/sum\n"
+        << "   of each block of 1000 values for every keyword occurrence and for the cell volumes of the grid, and can be reused with -d for\n"
+        << "   later comparisons against the same case.\n"
         << "-h Print help and exit.\n"
         << "-i Execute integration test (regression test is default).\n"
         << "   The integration test compares SGAS, SWAT and PRESSURE in unified restart files, so this option can not be used in combination with -t.\n"
@@ -57,7 +65,9 @@ static void printHelp() {
         << "Example usage of the program: \n\n"
         << "compareECL -k PRESSURE <path to first casefile> <path to second casefile> 1e-3 1e-5\n"
         << "compareECL -t INIT -k PORO <path to first casefile> <path to second casefile> 1e-3 1e-5\n"
-        << "compareECL -i <path to first casefile> <path to second casefile> 0.01 1e-6\n\n"
+        << "compareECL -i <path to first casefile> <path to second casefile> 0.01 1e-6\n"
+        << "compareECL -D reference.digest <path to first casefile> <path to second casefile> 1e-3 1e-5\n"
+        << "compareECL -d reference.digest <path to first casefile> <path to second casefile> 1e-3 1e-5\n\n"
         << "Exceptions are thrown (and hence program exits) when deviations are larger than the specified "
         << "tolerances, or when the number of cells does not match -- either in the grid file or for a "
         << "specific keyword. Information about the keyword, keyword occurrence (zero based) and cell "
@@ -116,10 +126,18 @@ int main(int argc, char** argv) {
     bool throwOnError            = true;
     char* keyword                = nullptr;
     char* fileTypeCstr           = nullptr;
+    char* readDigestFile         = nullptr;
+    char* writeDigestFile        = nullptr;
     int c                        = 0;
 
-    while ((c = getopt(argc, argv, "hiIk:lnpPt:")) != -1) {
+    while ((c = getopt(argc, argv, "d:D:hiIk:lnpPt:")) != -1) {
         switch (c) {
+            case 'd':
+                readDigestFile = optarg;
+                break;
+            case 'D':
+                writeDigestFile = optarg;
+                break;
             case 'h':
                 printHelp();
                 return 0;
@@ -155,6 +173,10 @@ int main(int argc, char** argv) {
                     std::cerr << "Option k requires a keyword as argument, see manual (-h) for more information." << std::endl;
                     return EXIT_FAILURE;
                 }
+                else if (optopt == 'd' || optopt == 'D') {
+                    std::cerr << "Option " << static_cast<char>(optopt) << " requires a digest filename as argument, see manual (-h) for more information." << std::endl;
+                    return EXIT_FAILURE;
+                }
                 else if (optopt == 't') {
                     std::cerr << "Option t requires an ECLIPSE filetype as argument, see manual (-h) for more information." << std::endl;
                     return EXIT_FAILURE;
@@ -170,7 +192,9 @@ int main(int argc, char** argv) {
     int argOffset = optind;
     if ((printKeywords && printKeywordsDifference) ||
         (integrationTest && specificFileType)      ||
-        (integrationTest && onlyLastOccurrence)) {
+        (integrationTest && onlyLastOccurrence)    ||
+        (integrationTest && readDigestFile)        ||
+        (readDigestFile && writeDigestFile)) {
         std::cerr << "Error: Options given which can not be combined. "
             << "Please see the manual (-h) for more information." << std::endl;
         return EXIT_FAILURE;
@@ -211,6 +235,32 @@ int main(int argc, char** argv) {
             return EXIT_FAILURE;
         }
     }
+    if (writeDigestFile) {
+        const std::size_t chunkSize = 1000;
+        char* filename = ecl_util_alloc_filename(nullptr, basename2.c_str(), file_type, false, -1);
+        ecl_file_type* ecl_file = ecl_file_open(filename, 0);
+        if (ecl_file == nullptr) {
+            std::cerr << "Error opening file: " << filename << std::endl;
+            free(filename);
+            return EXIT_FAILURE;
+        }
+        try {
+            ECLFileDigest digest = ECLFileDigest::fromFile(ecl_file, file_type, chunkSize);
+            digest.setGrid(ECLFilesComparator::loadGrid(basename2).get());
+            digest.save(writeDigestFile);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Program threw an exception: " << e.what() << std::endl;
+            ecl_file_close(ecl_file);
+            free(filename);
+            return EXIT_FAILURE;
+        }
+        std::cout << "Wrote digest of '" << filename << "' to '" << writeDigestFile << "'." << std::endl;
+        ecl_file_close(ecl_file);
+        free(filename);
+        return 0;
+    }
+
     std::cout << "Comparing '" << basename1 << "' to '" << basename2 << "'." << std::endl;
     try {
         if (integrationTest) {
@@ -253,6 +303,9 @@ int main(int argc, char** argv) {
             if (onlyLastOccurrence) {
                 comparator.setOnlyLastOccurrence(true);
             }
+            if (readDigestFile) {
+                comparator.setReferenceDigest(std::make_shared<ECLFileDigest>(ECLFileDigest::load(readDigestFile)));
+            }
             if (specificKeyword) {
                 comparator.gridCompare();
                 comparator.resultsForKeyword(keyword);
@@ -261,6 +314,9 @@ int main(int argc, char** argv) {
                 comparator.gridCompare();
                 comparator.results();
             }
+            if (readDigestFile) {
+                std::cout << comparator.getNoClearedByDigest() << " keyword occurrences cleared by the digest." << std::endl;
+            }
             if (comparator.getNoErrors() > 0)
               OPM_THROW(std::runtime_error, comparator.getNoErrors() << " errors encountered in comparisons.");
         }
@@ -0,0 +1,363 @@
+/*
+   Copyright 2017 Statoil ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <opm/test_util/EclFilesComparator.hpp>
+#include <opm/test_util/EclFileDigest.hpp>
+#include <opm/test_util/summaryRegressionRun.hpp>
+#include <opm/output/util/ThreadPool.hpp>
+
+#include <ert/ecl/ecl_util.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+static void printHelp() {
+    std::cout << "\ncompareECLBatch runs the compareECL and compareSummary regression tests for many pairs of cases in one process.\n"
+        << "The program takes one argument, a manifest file with one comparison per line:\n\n"
+        << "   <filetype> <path to first case> <path to second case> <absolute tolerance> <relative tolerance> [digest file]\n\n"
+        << "where filetype is UNRST, INIT, RFT or SUMMARY, the cases are given as full paths without extension, and the optional\n"
+        << "digest file is a digest of the second case written with compareECL -D. Summary comparisons take no digest file.\n"
+        << "Empty lines and lines starting with # are ignored.\n"
+        << "Grids of the second cases are loaded once and shared between all comparisons using that case, and the comparisons\n"
+        << "are run concurrently. The output of each comparison is collected separately and only included in the report\n"
+        << "if the comparison fails; the report holds the status of every comparison.\n\n"
+        << "In addition, the program takes these options (which must be given before the argument):\n\n"
+        << "-f Report format, json (default) or csv.\n"
+        << "-h Print help and exit.\n"
+        << "-j Number of comparisons to run concurrently (default is the number of hardware threads).\n"
+        << "-l Only do comparison for the last occurrence (not used for summary comparisons).\n"
+        << "-o Write the report to the file given as argument instead of to standard output.\n\n"
+        << "Example usage of the program: \n\n"
+        << "compareECLBatch -j 8 -f csv -o report.csv manifest.txt\n\n"
+        << "The program exits with a non-zero status if any comparison fails.\n\n";
+}
+
+
+
+namespace {
+
+    struct Comparison {
+        std::string fileTypeName;
+        ecl_file_enum fileType;
+        std::string basename1;
+        std::string basename2;
+        double absTolerance;
+        double relTolerance;
+        std::string digestFile;
+    };
+
+    struct Result {
+        bool passed = false;
+        std::string message;
+        std::string output;
+        size_t cleared = 0;
+        double seconds = 0;
+    };
+
+    /*
+      Loads every grid and digest at most once, also when several
+      comparisons ask for the same case concurrently.
+    */
+    template <typename T>
+    class SharedCache {
+        public:
+            template <typename Loader>
+            std::shared_ptr<T> get(const std::string& key, Loader loader) {
+                std::shared_future<std::shared_ptr<T>> future;
+                std::promise<std::shared_ptr<T>> promise;
+                bool load = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto it = entries.find(key);
+                    if (it == entries.end()) {
+                        future = promise.get_future().share();
+                        entries.emplace(key, future);
+                        load = true;
+                    }
+                    else {
+                        future = it->second;
+                    }
+                }
+                if (load) {
+                    try {
+                        promise.set_value(loader(key));
+                    }
+                    catch (...) {
+                        promise.set_exception(std::current_exception());
+                    }
+                }
+                return future.get();
+            }
+
+        private:
+            std::mutex mutex;
+            std::map<std::string, std::shared_future<std::shared_ptr<T>>> entries;
+    };
+
+
+
+    std::vector<Comparison> readManifest(const std::string& filename) {
+        std::ifstream stream(filename);
+        if (!stream) {
+            throw std::invalid_argument("Error opening manifest file: " + filename);
+        }
+        std::vector<Comparison> comparisons;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(stream, line)) {
+            ++lineNumber;
+            std::istringstream fields(line);
+            Comparison comparison;
+            if (!(fields >> comparison.fileTypeName) || comparison.fileTypeName[0] == '#')
+                continue;
+            for (auto& ch: comparison.fileTypeName) ch = toupper(ch);
+            if (comparison.fileTypeName == "UNRST")
+                comparison.fileType = ECL_UNIFIED_RESTART_FILE;
+            else if (comparison.fileTypeName == "INIT")
+                comparison.fileType = ECL_INIT_FILE;
+            else if (comparison.fileTypeName == "RFT")
+                comparison.fileType = ECL_RFT_FILE;
+            else if (comparison.fileTypeName == "SUMMARY")
+                comparison.fileType = ECL_SUMMARY_FILE;
+            else
+                throw std::invalid_argument("Unknown ECLIPSE filetype on line " + std::to_string(lineNumber) + " of " + filename);
+
+            if (!(fields >> comparison.basename1 >> comparison.basename2 >> comparison.absTolerance >> comparison.relTolerance))
+                throw std::invalid_argument("Malformed comparison on line " + std::to_string(lineNumber) + " of " + filename);
+            fields >> comparison.digestFile;
+            if (comparison.fileType == ECL_SUMMARY_FILE && !comparison.digestFile.empty())
+                throw std::invalid_argument("Summary comparisons take no digest file, line " + std::to_string(lineNumber) + " of " + filename);
+            comparisons.push_back(comparison);
+        }
+        return comparisons;
+    }
+
+
+
+    std::string jsonEscape(const std::string& value) {
+        std::ostringstream out;
+        for (const char ch : value) {
+            switch (ch) {
+                case '"':  out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n";  break;
+                case '\t': out << "\\t";  break;
+                default:
+                    if (static_cast<unsigned char>(ch) < 0x20)
+                        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(ch) << std::dec;
+                    else
+                        out << ch;
+            }
+        }
+        return out.str();
+    }
+
+
+
+    std::string csvEscape(const std::string& value) {
+        std::string escaped = "\"";
+        for (const char ch : value) {
+            if (ch == '"')
+                escaped += '"';
+            escaped += ch;
+        }
+        return escaped + "\"";
+    }
+
+
+
+    void writeReport(std::ostream& out, const std::string& format,
+                     const std::vector<Comparison>& comparisons, const std::vector<Result>& results) {
+        size_t failed = 0;
+        for (const auto& result : results)
+            failed += !result.passed;
+
+        if (format == "csv") {
+            out << "filetype,case1,case2,status,seconds,cleared,message,output\n";
+            for (size_t i = 0; i < comparisons.size(); ++i) {
+                out << comparisons[i].fileTypeName << ','
+                    << csvEscape(comparisons[i].basename1) << ','
+                    << csvEscape(comparisons[i].basename2) << ','
+                    << (results[i].passed ? "pass" : "fail") << ','
+                    << results[i].seconds << ','
+                    << results[i].cleared << ','
+                    << csvEscape(results[i].message) << ','
+                    << csvEscape(results[i].output) << '\n';
+            }
+            return;
+        }
+
+        out << "{\n  \"total\": " << comparisons.size()
+            << ",\n  \"passed\": " << comparisons.size() - failed
+            << ",\n  \"failed\": " << failed
+            << ",\n  \"comparisons\": [";
+        for (size_t i = 0; i < comparisons.size(); ++i) {
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\"filetype\": \"" << comparisons[i].fileTypeName
+                << "\", \"case1\": \"" << jsonEscape(comparisons[i].basename1)
+                << "\", \"case2\": \"" << jsonEscape(comparisons[i].basename2)
+                << "\", \"status\": \"" << (results[i].passed ? "pass" : "fail")
+                << "\", \"seconds\": " << results[i].seconds
+                << ", \"cleared\": " << results[i].cleared
+                << ", \"message\": \"" << jsonEscape(results[i].message)
+                << "\", \"output\": \"" << jsonEscape(results[i].output) << "\"}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+}
+
+//------------------------------------------------//
+
+int main(int argc, char** argv) {
+    std::string format           = "json";
+    std::string reportFile;
+    bool onlyLastOccurrence      = false;
+    size_t numThreads            = Opm::out::ThreadPool::defaultSize();
+    int c                        = 0;
+
+    while ((c = getopt(argc, argv, "f:hj:lo:")) != -1) {
+        switch (c) {
+            case 'f':
+                format = optarg;
+                break;
+            case 'h':
+                printHelp();
+                return 0;
+            case 'j':
+                numThreads = std::max(1L, strtol(optarg, nullptr, 10));
+                break;
+            case 'l':
+                onlyLastOccurrence = true;
+                break;
+            case 'o':
+                reportFile = optarg;
+                break;
+            case '?':
+                std::cerr << "Unknown option or missing option argument, see manual (-h) for more information." << std::endl;
+                return EXIT_FAILURE;
+            default:
+                return EXIT_FAILURE;
+        }
+    }
+    if (format != "json" && format != "csv") {
+        std::cerr << "Unknown report format " << format << ", use json or csv." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (argc != optind + 1) {
+        std::cerr << "Error: The number of options and arguments given is not correct. "
+            << "Please run compareECLBatch -h to see manual." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Comparison> comparisons;
+    try {
+        comparisons = readManifest(argv[optind]);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Program threw an exception: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Result> results(comparisons.size());
+    SharedCache<ecl_grid_type> grids;
+    SharedCache<const ECLFileDigest> digests;
+
+    {
+        // The main thread only waits, so one worker per concurrent comparison.
+        Opm::out::ThreadPool pool(numThreads);
+        std::vector<std::future<void>> pending;
+        pending.reserve(comparisons.size());
+        for (size_t i = 0; i < comparisons.size(); ++i) {
+            pending.push_back(pool.submit([&, i]() {
+                const Comparison& comparison = comparisons[i];
+                Result& result = results[i];
+                const auto start = std::chrono::steady_clock::now();
+                // Each comparison reports progress and deviations to its own stream.
+                std::ostringstream output;
+                try {
+                    if (comparison.fileType == ECL_SUMMARY_FILE) {
+                        runSummaryRegressionTest(comparison.basename1, comparison.basename2,
+                                                 comparison.absTolerance, comparison.relTolerance,
+                                                 false, output, output);
+                    }
+                    else {
+                        // Only the reference grids are shared; candidate cases are normally unique.
+                        // With a digest the reference grid is only loaded if the digest can not clear the cell volumes.
+                        auto loadGrid = [](const std::string& basename) { return ECLFilesComparator::loadGrid(basename); };
+                        std::shared_ptr<ecl_grid_type> referenceGrid;
+                        if (comparison.digestFile.empty())
+                            referenceGrid = grids.get(comparison.basename2, loadGrid);
+                        RegressionTest comparator(comparison.fileType, comparison.basename1, comparison.basename2,
+                                                  ECLFilesComparator::loadGrid(comparison.basename1),
+                                                  referenceGrid,
+                                                  comparison.absTolerance, comparison.relTolerance);
+                        comparator.setOutput(output, output);
+                        comparator.setOnlyLastOccurrence(onlyLastOccurrence);
+                        if (!comparison.digestFile.empty()) {
+                            comparator.setReferenceDigest(digests.get(comparison.digestFile, [](const std::string& filename) {
+                                return std::make_shared<const ECLFileDigest>(ECLFileDigest::load(filename));
+                            }));
+                        }
+                        comparator.gridCompare();
+                        comparator.results();
+                        result.cleared = comparator.getNoClearedByDigest();
+                    }
+                    result.passed = true;
+                }
+                catch (const std::exception& e) {
+                    result.message = e.what();
+                    result.output = output.str();
+                }
+                result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }));
+        }
+        for (auto& future : pending)
+            future.get();
+    }
+
+    if (reportFile.empty()) {
+        writeReport(std::cout, format, comparisons, results);
+    }
+    else {
+        std::ofstream report(reportFile);
+        writeReport(report, format, comparisons, results);
+        if (!report) {
+            std::cerr << "Error writing report file: " << reportFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (const auto& result : results) {
+        if (!result.passed)
+            return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE AsyncFile
+#include <boost/test/unit_test.hpp>
+
+#include <opm/output/util/AsyncFile.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ert/util/TestArea.hpp>
+
+using Opm::out::AsyncFile;
+
+namespace {
+
+std::string slurp(const std::string& filename)
+{
+    std::ifstream stream(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+// Records of varying size, many of them small.
+std::vector<std::string> records()
+{
+    std::vector<std::string> result;
+    for (int i = 0; i < 5000; ++i)
+        result.emplace_back(1 + (i * 37) % 3000, char('a' + i % 26));
+    return result;
+}
+
+} // Anonymous
+
+BOOST_AUTO_TEST_CASE(WritesInOrder) {
+    ERT::TestArea ta("test_AsyncFile");
+    const auto data = records();
+
+    for (auto backend : { AsyncFile::Backend::Automatic, AsyncFile::Backend::PWrite }) {
+        std::string expected;
+        {
+            AsyncFile file("ASYNC", backend);
+            if (backend == AsyncFile::Backend::PWrite)
+                BOOST_CHECK(file.backend() == AsyncFile::Backend::PWrite);
+
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                file.append(data[i].data(), data[i].size());
+                expected += data[i];
+
+                if (i % 1000 == 999) {
+                    file.flush();
+                    BOOST_CHECK(slurp("ASYNC") == expected);
+                }
+            }
+
+            file.append(std::vector<char>());
+            BOOST_CHECK_EQUAL(file.size(), expected.size());
+        }
+
+        BOOST_CHECK(slurp("ASYNC") == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AppendsToExistingFile) {
+    ERT::TestArea ta("test_AsyncFile");
+
+    for (auto backend : { AsyncFile::Backend::Automatic, AsyncFile::Backend::PWrite }) {
+        {
+            AsyncFile file("ASYNC", backend);
+            file.append("first", 5);
+        }
+        {
+            AsyncFile file("ASYNC", backend, AsyncFile::Mode::Append);
+            BOOST_CHECK_EQUAL(file.size(), 5U);
+            file.append("second", 6);
+            BOOST_CHECK_EQUAL(file.size(), 11U);
+        }
+        BOOST_CHECK(slurp("ASYNC") == "firstsecond");
+
+        {
+            AsyncFile file("ASYNC", backend);
+        }
+        BOOST_CHECK(slurp("ASYNC").empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(OpenFails) {
+    BOOST_CHECK_THROW(AsyncFile("no/such/directory/FILE"), std::runtime_error);
+}
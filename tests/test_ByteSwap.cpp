@@ -0,0 +1,133 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE ByteSwap
+#include <boost/test/unit_test.hpp>
+
+#include <opm/output/util/ByteSwap.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using Opm::out::byteSwap;
+using Opm::out::byteSwapWith;
+
+namespace {
+
+// Every kernel; the ones the CPU does not support are skipped.
+const char* const kernels[] = { "scalar", "ssse3", "avx2" };
+
+std::vector<char> reference(const std::vector<char>& in, std::size_t elementSize)
+{
+    auto out = in;
+    for (std::size_t i = 0; i + elementSize <= out.size(); i += elementSize)
+        std::reverse(out.begin() + i, out.begin() + i + elementSize);
+    return out;
+}
+
+std::vector<char> pattern(std::size_t bytes)
+{
+    std::vector<char> data(bytes);
+    for (std::size_t i = 0; i < bytes; ++i)
+        data[i] = static_cast<char>(i * 31 + 7);
+    return data;
+}
+
+} // Anonymous
+
+BOOST_AUTO_TEST_CASE(MatchesReference) {
+    BOOST_TEST_MESSAGE("Byte swap kernel: " << Opm::out::byteSwapKernel());
+
+    for (std::size_t elementSize : { 2, 4, 8 }) {
+        // Counts around the 16, 32 and 64 byte vector widths, so the
+        // scalar tail of every kernel is exercised.
+        for (std::size_t count : { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 1000, 1001 }) {
+            // Unaligned source and destination.
+            for (std::size_t offset : { 0, 1, 3 }) {
+                const auto in = pattern(count * elementSize + offset);
+                const auto expected = reference(std::vector<char>(in.begin() + offset, in.end()), elementSize);
+
+                std::vector<char> out(in.size(), 0);
+                byteSwap(in.data() + offset, out.data() + offset, count, elementSize);
+                BOOST_CHECK(std::equal(expected.begin(), expected.end(), out.begin() + offset));
+
+                for (const char* kernel : kernels) {
+                    std::vector<char> kernelOut(in.size(), 0);
+                    if (!byteSwapWith(kernel, in.data() + offset, kernelOut.data() + offset, count, elementSize))
+                        continue;
+
+                    BOOST_CHECK_MESSAGE(std::equal(expected.begin(), expected.end(), kernelOut.begin() + offset),
+                                        kernel << " kernel, element size " << elementSize << ", count " << count);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InPlace) {
+    for (const char* kernel : kernels) {
+        for (std::size_t elementSize : { 4, 8 }) {
+            const auto in = pattern(12345 * elementSize);
+            auto data = in;
+
+            if (!byteSwapWith(kernel, data.data(), data.data(), 12345, elementSize)) {
+                BOOST_TEST_MESSAGE(kernel << " kernel not supported by this CPU");
+                continue;
+            }
+            BOOST_CHECK(data == reference(in, elementSize));
+
+            byteSwapWith(kernel, data.data(), data.data(), 12345, elementSize);
+            BOOST_CHECK(data == in);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(KernelSelection) {
+    const std::vector<char> in = pattern(8);
+    std::vector<char> out(8, 0);
+
+    BOOST_CHECK(byteSwapWith("scalar", in.data(), out.data(), 2, 4));
+    BOOST_CHECK(byteSwapWith(Opm::out::byteSwapKernel(), in.data(), out.data(), 2, 4));
+
+    out.assign(8, 0);
+    BOOST_CHECK(!byteSwapWith("neon", in.data(), out.data(), 2, 4));
+    BOOST_CHECK(out == std::vector<char>(8, 0));
+}
+
+BOOST_AUTO_TEST_CASE(Values) {
+    const std::vector<std::int32_t> ints = { 0x01020304, -1, 0 };
+    std::vector<std::int32_t> swapped(ints.size());
+    byteSwap(ints.data(), swapped.data(), ints.size(), sizeof(std::int32_t));
+
+    BOOST_CHECK_EQUAL(swapped[0], 0x04030201);
+    BOOST_CHECK_EQUAL(swapped[1], -1);
+    BOOST_CHECK_EQUAL(swapped[2], 0);
+
+    const double value = 1.0;
+    std::uint64_t bits;
+    byteSwap(&value, &bits, 1, sizeof(double));
+    std::uint64_t expected = 0x3FF0000000000000ull;
+    byteSwap(&expected, &expected, 1, sizeof(expected));
+    BOOST_CHECK_EQUAL(bits, expected);
+}
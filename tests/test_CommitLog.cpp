@@ -0,0 +1,119 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE CommitLog
+#include <boost/test/unit_test.hpp>
+
+#include <opm/output/eclipse/CommitLog.hpp>
+
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <ert/util/TestArea.hpp>
+
+using namespace Opm;
+
+namespace {
+
+    void append( const std::string& filename, const std::string& text ) {
+        std::ofstream stream( filename, std::ios::binary | std::ios::app );
+        stream << text;
+    }
+
+    std::string slurp( const std::string& filename ) {
+        std::ifstream stream( filename, std::ios::binary );
+        return std::string( std::istreambuf_iterator< char >( stream ), std::istreambuf_iterator< char >() );
+    }
+
+    const std::time_t start = 1483228800;      // 2017-01-01
+}
+
+
+BOOST_AUTO_TEST_CASE(recover_truncates_to_last_commit) {
+    ERT::TestArea ta( "test_CommitLog" );
+    out::CommitLog log( "CASE.OPM_COMMIT", "CASE", start );
+
+    BOOST_CHECK_EQUAL( log.lastCommitted(), -1 );
+    BOOST_CHECK_EQUAL( log.recover(), -1 );
+
+    append( "CASE.UNRST", "step1" );
+    append( "CASE.UNSMRY", "records1" );
+    log.commit( 1, { "CASE.UNRST", "CASE.UNSMRY", "CASE.RFT" } );
+
+    append( "CASE.UNRST", "step2" );
+    append( "CASE.UNSMRY", "records2" );
+    log.commit( 2, { "CASE.UNRST", "CASE.UNSMRY", "CASE.RFT" } );
+
+    BOOST_CHECK_EQUAL( log.lastCommitted(), 2 );
+    const auto sizes = log.committedSizes();
+    BOOST_REQUIRE_EQUAL( sizes.size(), 2U );            // CASE.RFT does not exist.
+    BOOST_CHECK_EQUAL( sizes[0].first, "CASE.UNRST" );
+    BOOST_CHECK_EQUAL( sizes[0].second, 10U );
+
+    /* A crash in the middle of step 3. */
+    append( "CASE.UNRST", "torn" );
+    append( "CASE.UNSMRY", "records3" );
+
+    BOOST_CHECK_EQUAL( out::CommitLog( "CASE.OPM_COMMIT", "CASE", start ).recover(), 2 );
+    BOOST_CHECK_EQUAL( slurp( "CASE.UNRST" ), "step1step2" );
+    BOOST_CHECK_EQUAL( slurp( "CASE.UNSMRY" ), "records1records2" );
+
+    /* Nothing to do the second time. */
+    BOOST_CHECK_EQUAL( log.recover(), 2 );
+    BOOST_CHECK_EQUAL( slurp( "CASE.UNRST" ), "step1step2" );
+}
+
+
+BOOST_AUTO_TEST_CASE(incomplete_marker_is_ignored) {
+    ERT::TestArea ta( "test_CommitLog" );
+
+    append( "CASE.UNRST", "step1" );
+    append( "CASE.OPM_COMMIT", "OPM_COMMIT 1\nCASE CASE\nSTART 1483228800\nSTEP 1\nFILE 2 CASE.UNRST\n" );
+
+    out::CommitLog log( "CASE.OPM_COMMIT", "CASE", start );
+    BOOST_CHECK_EQUAL( log.lastCommitted(), -1 );
+    BOOST_CHECK_EQUAL( log.recover(), -1 );
+    BOOST_CHECK_EQUAL( slurp( "CASE.UNRST" ), "step1" );
+}
+
+
+BOOST_AUTO_TEST_CASE(stale_marker_is_ignored) {
+    ERT::TestArea ta( "test_CommitLog" );
+
+    append( "CASE.UNRST", "step1" );
+    out::CommitLog( "CASE.OPM_COMMIT", "CASE", start ).commit( 1, { "CASE.UNRST" } );
+    append( "CASE.UNRST", "step2" );
+
+    /* Another run writing to the same directory. */
+    BOOST_CHECK_EQUAL( out::CommitLog( "CASE.OPM_COMMIT", "CASE", start + 86400 ).recover(), -1 );
+    BOOST_CHECK_EQUAL( out::CommitLog( "CASE.OPM_COMMIT", "OTHER", start ).recover(), -1 );
+    BOOST_CHECK_EQUAL( slurp( "CASE.UNRST" ), "step1step2" );
+
+    /* A marker without the case and start time is stale as well. */
+    append( "OLD.OPM_COMMIT", "OPM_COMMIT 1\nSTEP 1\nFILE 2 CASE.UNRST\nEND\n" );
+    BOOST_CHECK_EQUAL( out::CommitLog( "OLD.OPM_COMMIT", "CASE", start ).recover(), -1 );
+    BOOST_CHECK_EQUAL( slurp( "CASE.UNRST" ), "step1step2" );
+
+    BOOST_CHECK_EQUAL( out::CommitLog( "CASE.OPM_COMMIT", "CASE", start ).recover(), 1 );
+    BOOST_CHECK_EQUAL( slurp( "CASE.UNRST" ), "step1" );
+}
@@ -22,6 +22,15 @@
 
 #include <boost/test/unit_test.hpp>
 #include <opm/test_util/EclFilesComparator.hpp>
+#include <opm/test_util/EclFileDigest.hpp>
+
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ert/ecl/ecl_grid.h>
 
 BOOST_AUTO_TEST_CASE(deviation) {
     double a = 1;
@@ -66,3 +75,144 @@ BOOST_AUTO_TEST_CASE(average) {
 
     BOOST_CHECK_CLOSE(avg, 13.0/4, tol);
 }
+
+
+
+BOOST_AUTO_TEST_CASE(digestHash) {
+    const std::vector<int> data1 = {1,2,3,4};
+    std::vector<int> data2 = data1;
+
+    BOOST_CHECK_EQUAL(ECLFileDigest::hash(nullptr, 0), 14695981039346656037ULL);
+    BOOST_CHECK_EQUAL(ECLFileDigest::hash(data1.data(), 4*sizeof(int)),
+                      ECLFileDigest::hash(data2.data(), 4*sizeof(int)));
+
+    data2[3] = 5;
+    BOOST_CHECK(ECLFileDigest::hash(data1.data(), 4*sizeof(int)) !=
+                ECLFileDigest::hash(data2.data(), 4*sizeof(int)));
+}
+
+
+
+BOOST_AUTO_TEST_CASE(digestChunkStatistics) {
+    const std::vector<double> values = {3, -1, 2, 7, 5};
+
+    const auto chunks = ECLFileDigest::chunkStatistics(values, 2);
+
+    BOOST_CHECK_EQUAL(chunks.size(), 3U);
+    BOOST_CHECK_EQUAL(chunks[0].min, -1);
+    BOOST_CHECK_EQUAL(chunks[0].max, 3);
+    BOOST_CHECK_EQUAL(chunks[0].sum, 2);
+    BOOST_CHECK_EQUAL(chunks[1].min, 2);
+    BOOST_CHECK_EQUAL(chunks[1].max, 7);
+    BOOST_CHECK_EQUAL(chunks[2].min, 5);
+    BOOST_CHECK_EQUAL(chunks[2].sum, 5);
+
+    BOOST_CHECK(ECLFileDigest::chunkStatistics(values, 0).empty());
+}
+
+
+
+BOOST_AUTO_TEST_CASE(digestWithinTolerance) {
+    const std::vector<double> reference = {1.00, 1.01, 2.00, 2.02};
+    const auto chunks = ECLFileDigest::chunkStatistics(reference, 2);
+
+    std::vector<double> candidate = {1.005, 1.005, 2.01, 2.01};
+    BOOST_CHECK(ECLFileDigest::withinTolerance(candidate, chunks, 2, 0.02, false));
+    // The bound is conservative: the chunk range alone exceeds the tolerance.
+    BOOST_CHECK(!ECLFileDigest::withinTolerance(candidate, chunks, 2, 0.01, false));
+
+    candidate[3] = 3.0;
+    BOOST_CHECK(!ECLFileDigest::withinTolerance(candidate, chunks, 2, 0.02, false));
+
+    // Wrong number of chunks
+    BOOST_CHECK(!ECLFileDigest::withinTolerance({1.0}, chunks, 2, 0.02, false));
+
+    candidate = {1.0, std::nan(""), 2.0, 2.0};
+    BOOST_CHECK(!ECLFileDigest::withinTolerance(candidate, chunks, 2, 0.02, false));
+
+    const std::vector<double> saturation = {-1.0e-4, 0.0, 0.5, 0.5};
+    const auto satChunks = ECLFileDigest::chunkStatistics(saturation, 2);
+    BOOST_CHECK(ECLFileDigest::withinTolerance({0.0, 0.0, 0.5, 0.5}, satChunks, 2, 1.0e-3, true));
+    BOOST_CHECK(!ECLFileDigest::withinTolerance({-0.1, 0.0, 0.5, 0.5}, satChunks, 2, 1.0e-3, true));
+    BOOST_CHECK(!ECLFileDigest::withinTolerance({0.0, 0.0, 0.5, 0.5}, satChunks, 2, 1.0e-5, true));
+}
+
+
+
+BOOST_AUTO_TEST_CASE(digestReadWrite) {
+    ECLFileDigest digest(7, 2);
+    ECLFileDigest::Entry entry;
+    entry.type = "REAL";
+    entry.size = 3;
+    entry.hash = 0xfedcba9876543210ULL;
+    entry.chunks = ECLFileDigest::chunkStatistics({0.1, 1.0/3, 2.0e-20}, 2);
+    digest.add("PRESSURE", 1, entry);
+
+    ECLFileDigest::Entry charEntry;
+    charEntry.type = "CHAR";
+    charEntry.size = 2;
+    charEntry.hash = 42;
+    digest.add("ZWEL", 0, charEntry);
+
+    std::stringstream stream;
+    digest.write(stream);
+    const ECLFileDigest copy = ECLFileDigest::read(stream);
+
+    BOOST_CHECK_EQUAL(copy.getFileType(), 7);
+    BOOST_CHECK_EQUAL(copy.chunkSize(), 2U);
+    BOOST_CHECK_EQUAL(copy.size(), 2U);
+    BOOST_CHECK(copy.find("PRESSURE", 0) == nullptr);
+
+    const auto* pressure = copy.find("PRESSURE", 1);
+    BOOST_REQUIRE(pressure != nullptr);
+    BOOST_CHECK_EQUAL(pressure->type, "REAL");
+    BOOST_CHECK_EQUAL(pressure->size, 3U);
+    BOOST_CHECK_EQUAL(pressure->hash, entry.hash);
+    BOOST_REQUIRE_EQUAL(pressure->chunks.size(), 2U);
+    for (size_t i = 0; i < 2; ++i) {
+        BOOST_CHECK_EQUAL(pressure->chunks[i].min, entry.chunks[i].min);
+        BOOST_CHECK_EQUAL(pressure->chunks[i].max, entry.chunks[i].max);
+        BOOST_CHECK_EQUAL(pressure->chunks[i].sum, entry.chunks[i].sum);
+    }
+
+    const auto* zwel = copy.find("ZWEL", 0);
+    BOOST_REQUIRE(zwel != nullptr);
+    BOOST_CHECK_EQUAL(zwel->hash, 42U);
+    BOOST_CHECK(zwel->chunks.empty());
+
+    BOOST_CHECK(copy.getGrid() == nullptr);
+    BOOST_CHECK((copy.keywords() == std::vector<std::string>{"PRESSURE", "ZWEL"}));
+    BOOST_CHECK_EQUAL(copy.numOccurrences("PRESSURE"), 1);
+    BOOST_CHECK_EQUAL(copy.numOccurrences("SWAT"), 0);
+
+    std::stringstream garbage("NOTADIGEST 1 2 3 4");
+    BOOST_CHECK_THROW(ECLFileDigest::read(garbage), std::runtime_error);
+
+    // Version 1 digests have no grid field in the header.
+    std::stringstream version1("ECLDIGEST 1 7 2 1\n'ZWEL' 0 CHAR 2 2a 0\n");
+    const ECLFileDigest old = ECLFileDigest::read(version1);
+    BOOST_CHECK_EQUAL(old.size(), 1U);
+    BOOST_CHECK(old.getGrid() == nullptr);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(digestGrid) {
+    std::shared_ptr<ecl_grid_type> grid(ecl_grid_alloc_rectangular(3, 2, 1, 1.0, 2.0, 0.5, nullptr), ecl_grid_free);
+    ECLFileDigest digest(7, 4);
+    digest.setGrid(grid.get());
+
+    std::stringstream stream;
+    digest.write(stream);
+    const ECLFileDigest copy = ECLFileDigest::read(stream);
+
+    const ECLFileDigest::Grid* digestGrid = copy.getGrid();
+    BOOST_REQUIRE(digestGrid != nullptr);
+    BOOST_CHECK_EQUAL(digestGrid->activeCells, 6U);
+    BOOST_CHECK_EQUAL(digestGrid->volumes.size, 6U);
+    BOOST_CHECK_EQUAL(digestGrid->volumes.chunks.size(), 2U);
+
+    const std::vector<double> volumes = ECLFileDigest::cellVolumes(grid.get());
+    BOOST_CHECK_EQUAL(digestGrid->volumes.hash, ECLFileDigest::hash(volumes.data(), volumes.size() * sizeof(double)));
+    BOOST_CHECK(ECLFileDigest::withinTolerance(volumes, digestGrid->volumes.chunks, 4, 1.0e-12, false));
+}
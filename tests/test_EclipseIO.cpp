@@ -49,6 +49,7 @@
 
 #include <ert/ecl_well/well_info.h>
 
+#include <fstream>
 #include <memory>
 #include <map>
 
@@ -398,5 +399,80 @@ BOOST_AUTO_TEST_CASE(EclipseIOIntegration) {
     BOOST_CHECK_EQUAL( file_size, write_and_check( 3, 5 ) );
 }
 
+BOOST_AUTO_TEST_CASE(CrashConsistentOutputKeepsSummary) {
+    const char *deckString =
+        "RUNSPEC\n"
+        "UNIFOUT\n"
+        "OIL\n"
+        "GAS\n"
+        "WATER\n"
+        "METRIC\n"
+        "DIMENS\n"
+        "3 3 3/\n"
+        "GRID\n"
+        "DXV\n"
+        "1.0 2.0 3.0 /\n"
+        "DYV\n"
+        "4.0 5.0 6.0 /\n"
+        "DZV\n"
+        "7.0 8.0 9.0 /\n"
+        "TOPS\n"
+        "9*100 /\n"
+        "PROPS\n"
+        "PORO\n"
+        "27*0.3 /\n"
+        "PERMX\n"
+        "27*1 /\n"
+        "SUMMARY\n"
+        "FOPT\n"
+        "SCHEDULE\n"
+        "TSTEP\n"
+        "1.0 2.0 3.0 4.0 /\n";
+
+    ERT::TestArea ta("test_ecl_writer");
+
+    ParseContext parse_context;
+    auto deck = Parser().parseString( deckString, parse_context );
+    auto es = Parser::parse( deck );
+    auto& eclGrid = es.getInputGrid();
+    Schedule schedule(deck, eclGrid, es.get3DProperties(), es.runspec().phases(), parse_context);
+    SummaryConfig summary_config( deck, schedule, es.getTableManager( ), parse_context);
+    es.getIOConfig().setBaseName( "FOO" );
+
+    auto write_steps = [&]( int first, int last ) {
+        EclipseIO eclWriter( es, eclGrid , schedule, summary_config);
+        eclWriter.setCrashConsistentOutput( true );
+
+        for( int i = first; i < last; ++i )
+            eclWriter.writeTimeStep( i, false, i * 86400.0,
+                                     createBlackoilState( i, 3 * 3 * 3 ),
+                                     data::Wells(), {}, {}, {} );
+    };
+
+    /*
+     * Commit steps 1 to 3 and crash while the next step is written,
+     * leaving a torn record at the end of the summary file.
+     */
+    write_steps( 1, 4 );
+    {
+        std::ofstream file( "FOO.UNSMRY", std::ios::binary | std::ios::app );
+        file << "torn record";
+    }
+
+    /* Recover and continue with step 4. */
+    write_steps( 4, 5 );
+
+    ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > ecl_file( ecl_file_open( "FOO.UNSMRY", 0 ) );
+    BOOST_REQUIRE( ecl_file );
+    BOOST_CHECK_EQUAL( 4, ecl_file_get_num_named_kw( ecl_file.get(), "SEQHDR" ) );
+    BOOST_CHECK_EQUAL( 4, ecl_file_get_num_named_kw( ecl_file.get(), "PARAMS" ) );
+    BOOST_REQUIRE_EQUAL( 4, ecl_file_get_num_named_kw( ecl_file.get(), "MINISTEP" ) );
+
+    for( int i = 0; i < 4; ++i ) {
+        const auto* ministep = ecl_file_iget_named_kw( ecl_file.get(), "MINISTEP", i );
+        BOOST_CHECK_EQUAL( i, ecl_kw_iget_int( ministep, 0 ) );
+    }
+}
+
 BOOST_AUTO_TEST_CASE(OPM_XWEL) {
 }
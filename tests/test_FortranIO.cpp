@@ -0,0 +1,336 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE FortranIO
+#include <boost/test/unit_test.hpp>
+
+#include <opm/output/eclipse/FortranIO.hpp>
+#include <opm/output/util/ThreadPool.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
+#include <ert/util/TestArea.hpp>
+
+using namespace Opm;
+
+namespace {
+
+    const std::vector< int > ints = [] {
+        std::vector< int > v( 2345 );
+        for (size_t i = 0; i < v.size(); i++)
+            v[i] = int( i * 7919 ) - 1000;
+        return v;
+    }();
+
+    const std::vector< float > floats = { 0.0f, 1.0f, -1.0f, 10.0f, 0.1f, 3.25e-7f, -123456.7f, 5.0e20f, 1.0e-30f };
+
+    const std::vector< double > doubles = [] {
+        std::vector< double > v( 1001 );
+        for (size_t i = 0; i < v.size(); i++)
+            v[i] = (double( i ) - 500.0) * 1.0e-3 / 7.0;
+        return v;
+    }();
+
+    const std::vector< std::string > strings = [] {
+        std::vector< std::string > v = { "A", "OP_1", "ABCDEFGH", "TOOLONGNAME" };
+        for (int i = 0; i < 120; i++)
+            v.push_back( "W" + std::to_string( i ) );
+        return v;
+    }();
+
+    std::string slurp( const std::string& filename ) {
+        std::ifstream stream( filename, std::ios::binary );
+        return std::string( std::istreambuf_iterator< char >( stream ), std::istreambuf_iterator< char >() );
+    }
+
+    template< typename T >
+    void libeclWrite( fortio_type* fortio, const char* name, const std::vector< T >& data, ecl_data_type type ) {
+        ecl_kw_type* kw = ecl_kw_alloc_new( name, int( data.size() ), type, data.data() );
+        ecl_kw_fwrite( kw, fortio );
+        ecl_kw_free( kw );
+    }
+
+    void libeclWrite( fortio_type* fortio, const char* name, const std::vector< std::string >& data ) {
+        ecl_kw_type* kw = ecl_kw_alloc( name, int( data.size() ), ECL_CHAR );
+        for (size_t i = 0; i < data.size(); i++)
+            ecl_kw_iset_string8( kw, int( i ), data[i].c_str() );
+        ecl_kw_fwrite( kw, fortio );
+        ecl_kw_free( kw );
+    }
+
+    void writeLibecl( const std::string& filename, bool formatted ) {
+        fortio_type* fortio = fortio_open_writer( filename.c_str(), formatted, ECL_ENDIAN_FLIP );
+        libeclWrite( fortio, "INTS", ints, ECL_INT );
+        libeclWrite( fortio, "FLOATS", floats, ECL_FLOAT );
+        libeclWrite( fortio, "DOUBLES", doubles, ECL_DOUBLE );
+        libeclWrite( fortio, "NAMES", strings );
+        libeclWrite( fortio, "EMPTY", std::vector< int >(), ECL_INT );
+        fortio_fclose( fortio );
+    }
+
+    void writeNative( const std::string& filename, bool formatted ) {
+        out::FortranWriter writer( filename, formatted );
+        writer.write( "INTS", ints );
+        writer.write( "FLOATS", floats );
+        writer.write( "DOUBLES", doubles );
+        writer.write( "NAMES", strings );
+        writer.write( "EMPTY", std::vector< int >() );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(binary_matches_libecl) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    writeLibecl( "LIBECL.INIT", false );
+    writeNative( "NATIVE.INIT", false );
+
+    const auto expected = slurp( "LIBECL.INIT" );
+    BOOST_CHECK( !expected.empty() );
+    BOOST_CHECK( expected == slurp( "NATIVE.INIT" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE(formatted_matches_libecl) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    writeLibecl( "LIBECL.FINIT", true );
+    writeNative( "NATIVE.FINIT", true );
+
+    const auto expected = slurp( "LIBECL.FINIT" );
+    BOOST_CHECK( !expected.empty() );
+    BOOST_CHECK_EQUAL( expected, slurp( "NATIVE.FINIT" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE(formatted_parallel) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    std::vector< double > field( 123457 );
+    for (size_t i = 0; i < field.size(); i++)
+        field[i] = std::sin( double( i ) ) * std::pow( 10.0, int( i % 41 ) - 20 );
+    field[17] = 0.0;
+    field[18] = -1.0;
+
+    {
+        fortio_type* fortio = fortio_open_writer( "LIBECL.FINIT", true, ECL_ENDIAN_FLIP );
+        libeclWrite( fortio, "FIELD", field, ECL_DOUBLE );
+        libeclWrite( fortio, "FFIELD", std::vector< float >( field.begin(), field.end() ), ECL_FLOAT );
+        fortio_fclose( fortio );
+    }
+
+    for (std::size_t threads : { 0, 4 }) {
+        out::ThreadPool pool( threads );
+        {
+            out::FortranWriter writer( "NATIVE.FINIT", true );
+            writer.setThreadPool( pool );
+            writer.write( "FIELD", field );
+            writer.writeAsFloat( "FFIELD", field.data(), field.size() );
+        }
+        BOOST_CHECK( slurp( "LIBECL.FINIT" ) == slurp( "NATIVE.FINIT" ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(read_logi_and_mess) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    /* The layout of a restart file: LOGIHEAD, and the solution between STARTSOL and ENDSOL. */
+    {
+        fortio_type* fortio = fortio_open_writer( "LOGI_MESS", false, ECL_ENDIAN_FLIP );
+        ecl_kw_type* logihead = ecl_kw_alloc( "LOGIHEAD", 1200, ECL_BOOL );
+        for (int i = 0; i < 1200; i++)
+            ecl_kw_iset_bool( logihead, i, i % 3 == 0 );
+        ecl_kw_fwrite( logihead, fortio );
+        ecl_kw_free( logihead );
+
+        ecl_kw_type* startsol = ecl_kw_alloc( "STARTSOL", 0, ECL_MESS );
+        ecl_kw_fwrite( startsol, fortio );
+        ecl_kw_free( startsol );
+
+        libeclWrite( fortio, "DOUBLES", doubles, ECL_DOUBLE );
+
+        ecl_kw_type* endsol = ecl_kw_alloc( "ENDSOL", 0, ECL_MESS );
+        ecl_kw_fwrite( endsol, fortio );
+        ecl_kw_free( endsol );
+        fortio_fclose( fortio );
+    }
+
+    {
+        out::FortranReader reader( "LOGI_MESS" );
+        out::EclHeader header;
+        for (const char* name : { "LOGIHEAD", "STARTSOL" }) {
+            BOOST_REQUIRE( reader.nextHeader( header ) );
+            BOOST_CHECK_EQUAL( header.name, name );
+            BOOST_CHECK_THROW( reader.readRanges( { { 0, 1 } } ), std::invalid_argument );
+        }
+
+        BOOST_REQUIRE( reader.nextHeader( header ) );
+        BOOST_CHECK_EQUAL( header.name, "DOUBLES" );
+        BOOST_CHECK( reader.readRanges( { { 1000, 1001 } } ) == std::vector< double >( { doubles[1000] } ) );
+
+        BOOST_REQUIRE( reader.nextHeader( header ) );
+        BOOST_CHECK( header.type == out::EclType::MESS );
+        BOOST_CHECK( !reader.nextHeader( header ) );
+    }
+
+    out::FortranReader reader( "LOGI_MESS" );
+    out::EclKeyword kw;
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK( kw.type == out::EclType::LOGI );
+    BOOST_REQUIRE_EQUAL( kw.size(), 1200U );
+    BOOST_CHECK( kw.ints[0] != 0 && kw.ints[1] == 0 && kw.ints[1199] == 0 && kw.ints[1197] != 0 );
+
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK( kw.type == out::EclType::MESS );
+    BOOST_CHECK_EQUAL( kw.size(), 0U );
+
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK( kw.doubles == doubles );
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK_EQUAL( kw.name, "ENDSOL" );
+    BOOST_CHECK( !reader.next( kw ) );
+}
+
+
+BOOST_AUTO_TEST_CASE(drop_from_page_cache) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    writeNative( "PLAIN", false );
+    const auto before = slurp( "PLAIN" );
+    {
+        out::FortranWriter writer( "CLOSED", false );
+        writer.close();
+        BOOST_CHECK_THROW( writer.write( "INTS", ints ), std::logic_error );
+    }
+
+    out::dropFromPageCache( "PLAIN" );
+    out::dropFromPageCache( "NO_SUCH_FILE" );
+    BOOST_CHECK( slurp( "PLAIN" ) == before );
+}
+
+
+BOOST_AUTO_TEST_CASE(mixed_with_fortio) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    writeLibecl( "LIBECL.INIT", false );
+    {
+        fortio_type* fortio = fortio_open_writer( "MIXED.INIT", false, ECL_ENDIAN_FLIP );
+        libeclWrite( fortio, "INTS", ints, ECL_INT );
+        {
+            out::FortranWriter writer( fortio );
+            writer.write( "FLOATS", floats );
+            writer.write( "DOUBLES", doubles );
+        }
+        libeclWrite( fortio, "NAMES", strings );
+        out::FortranWriter( fortio ).write( "EMPTY", std::vector< int >() );
+        fortio_fclose( fortio );
+    }
+
+    BOOST_CHECK( slurp( "LIBECL.INIT" ) == slurp( "MIXED.INIT" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE(read_back) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    writeLibecl( "LIBECL.INIT", false );
+    out::FortranReader reader( "LIBECL.INIT" );
+    out::EclKeyword kw;
+
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK_EQUAL( kw.name, "INTS" );
+    BOOST_CHECK( kw.type == out::EclType::INTE );
+    BOOST_CHECK( kw.ints == ints );
+
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK_EQUAL( kw.name, "FLOATS" );
+    BOOST_CHECK( kw.floats == floats );
+
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK_EQUAL( kw.name, "DOUBLES" );
+    BOOST_CHECK( kw.doubles == doubles );
+
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK_EQUAL( kw.name, "NAMES" );
+    BOOST_REQUIRE_EQUAL( kw.size(), strings.size() );
+    BOOST_CHECK_EQUAL( kw.strings[0], "A       " );
+    BOOST_CHECK_EQUAL( kw.strings[3], "TOOLONGN" );
+
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK_EQUAL( kw.name, "EMPTY" );
+    BOOST_CHECK_EQUAL( kw.size(), 0U );
+
+    BOOST_CHECK( !reader.next( kw ) );
+}
+
+
+BOOST_AUTO_TEST_CASE(read_ranges) {
+    ERT::TestArea ta( "test_FortranIO" );
+
+    std::vector< double > field( 4321 );
+    for (size_t i = 0; i < field.size(); i++)
+        field[i] = 0.25 * double( i );
+
+    {
+        out::FortranWriter writer( "RANGES", false );
+        writer.write( "INTS", ints );
+        writer.write( "FIELD", field );
+        writer.writeAsFloat( "FFIELD", field.data(), field.size() );
+        writer.write( "NAMES", strings );
+    }
+
+    /* Ranges across block boundaries, empty and out of order. */
+    const std::vector< std::pair< std::size_t, std::size_t > > ranges = { { 995, 2010 }, { 7, 9 }, { 30, 30 }, { 4320, 4321 } };
+    std::vector< double > expected;
+    for (const auto& range : ranges)
+        expected.insert( expected.end(), field.begin() + range.first, field.begin() + range.second );
+
+    out::FortranReader reader( "RANGES" );
+    out::EclHeader header;
+
+    BOOST_REQUIRE( reader.nextHeader( header ) );
+    BOOST_CHECK_EQUAL( header.name, "INTS" );
+    BOOST_CHECK_EQUAL( header.size, ints.size() );
+    BOOST_CHECK( reader.readRanges( { { 1000, 1002 }, { 0, 1 } } ) == std::vector< double >( { double( ints[1000] ), double( ints[1001] ), double( ints[0] ) } ) );
+
+    for (const char* name : { "FIELD", "FFIELD" }) {
+        BOOST_REQUIRE( reader.nextHeader( header ) );
+        BOOST_CHECK_EQUAL( header.name, name );
+        BOOST_CHECK( reader.readRanges( ranges ) == expected );
+        BOOST_CHECK_THROW( reader.readRanges( { { 4000, 4322 } } ), std::out_of_range );
+    }
+
+    out::EclKeyword kw;
+    BOOST_REQUIRE( reader.next( kw ) );
+    BOOST_CHECK_EQUAL( kw.name, "NAMES" );
+    BOOST_CHECK_EQUAL( kw.size(), strings.size() );
+    BOOST_CHECK_THROW( reader.readRanges( { { 0, 1 } } ), std::logic_error );
+    BOOST_CHECK( !reader.nextHeader( header ) );
+}
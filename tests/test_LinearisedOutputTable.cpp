@@ -26,6 +26,8 @@
 
 #include <opm/output/eclipse/LinearisedOutputTable.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <initializer_list>
 #include <vector>
@@ -602,3 +604,100 @@ BOOST_AUTO_TEST_CASE (Nonlinear_Functions)
 }
 
 BOOST_AUTO_TEST_SUITE_END ()
+
+// ---------------------------------------------------------------------
+// Slope computation on tables of production size.  The timing of this
+// case is in examples/benchmark_calcSlopes.cpp.
+
+BOOST_AUTO_TEST_SUITE (Production_Size_Slopes)
+
+namespace {
+    // Largest saturation function dimensions we see in practice:
+    // NTSFUN = 100 regions with NSSFUN = 1000 nodes of SWOF-like tables
+    // (three dependent columns).
+    const std::size_t benchTables = 100;
+    const std::size_t benchRows   = 1000;
+    const std::size_t benchDep    = 3;
+
+    ::Opm::LinearisedOutputTable makeBenchTable()
+    {
+        auto linTable = ::Opm::LinearisedOutputTable {
+            benchTables, 1, benchRows, 1 + 2*benchDep
+        };
+
+        for (auto t = 0*benchTables; t < benchTables; ++t) {
+            auto x = linTable.column(t, 0, 0);
+            for (auto i = 0*benchRows; i < benchRows; ++i) {
+                // Every tenth interval is degenerate (dx == 0).
+                x[i] = static_cast<double>(i - i/10) / benchRows;
+            }
+
+            for (auto j = 0*benchDep; j < benchDep; ++j) {
+                auto y = linTable.column(t, 0, j + 1);
+                for (auto i = 0*benchRows; i < benchRows; ++i) {
+                    y[i] = std::sin((j + 1) * x[i] + t);
+                }
+            }
+        }
+
+        return linTable;
+    }
+
+    // Straightforward scalar definition of the slopes.
+    std::vector<double>
+    referenceSlopes(::Opm::LinearisedOutputTable& linTable,
+                    const std::size_t             tableID,
+                    const std::size_t             numActRows)
+    {
+        auto dy = std::vector<double>(benchDep * benchRows, 1.0e20);
+
+        auto x = linTable.column(tableID, 0, 0);
+        for (auto j = 0*benchDep; j < benchDep; ++j) {
+            auto y = linTable.column(tableID, 0, j + 1);
+
+            for (auto i = 0*numActRows + 1; i < numActRows; ++i) {
+                const auto dx = x[i] - x[i - 1];
+
+                dy[j*benchRows + i] = (std::abs(dx) > 0.0)
+                    ? (y[i] - y[i - 1]) / dx : 0.0;
+            }
+        }
+
+        return dy;
+    }
+}
+
+BOOST_AUTO_TEST_CASE (Matches_Scalar_Definition)
+{
+    auto linTable = makeBenchTable();
+
+    // Exercise both full vector blocks and the scalar tail.
+    for (const std::size_t numActRows : { benchRows, benchRows - 1, std::size_t{2}, std::size_t{3} }) {
+        auto descr = ::Opm::DifferentiateOutputTable::Descriptor{};
+        descr.primID     = 0;
+        descr.numActRows = numActRows;
+
+        auto mismatch = std::size_t{0};
+        for (descr.tableID = 0; descr.tableID < benchTables; ++descr.tableID) {
+            // Reset derivative columns to padding.
+            for (auto j = 0*benchDep; j < benchDep; ++j) {
+                auto dy = linTable.column(descr.tableID, 0, benchDep + 1 + j);
+                std::fill(dy, dy + benchRows, 1.0e20);
+            }
+
+            calcSlopes(benchDep, descr, linTable);
+
+            const auto expect = referenceSlopes(linTable, descr.tableID, numActRows);
+            for (auto j = 0*benchDep; j < benchDep; ++j) {
+                auto dy = linTable.column(descr.tableID, 0, benchDep + 1 + j);
+                for (auto i = 0*benchRows; i < benchRows; ++i) {
+                    mismatch += dy[i] != expect[j*benchRows + i];
+                }
+            }
+        }
+
+        BOOST_CHECK_EQUAL(mismatch, std::size_t{0});
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
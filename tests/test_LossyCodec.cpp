@@ -0,0 +1,114 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE LossyCodec
+#include <boost/test/unit_test.hpp>
+
+#include <opm/output/util/LossyCodec.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace Opm::out;
+
+namespace {
+
+std::vector<double> smoothField(std::size_t size)
+{
+    std::vector<double> data(size);
+    for (std::size_t i = 0; i < size; ++i)
+        data[i] = 0.5 + 0.4 * std::sin(0.001 * double(i)) + 1.0e-4 * std::cos(double(i));
+    return data;
+}
+
+void checkBound(const std::vector<double>& data, double bound)
+{
+    QuantisedField field;
+    BOOST_REQUIRE(quantise(data.data(), data.size(), bound, field));
+
+    const auto decoded = dequantise(field);
+    BOOST_REQUIRE_EQUAL(decoded.size(), data.size());
+    for (std::size_t i = 0; i < data.size(); ++i)
+        BOOST_CHECK_LE(std::fabs(decoded[i] - data[i]), bound);
+}
+
+} // Anonymous
+
+BOOST_AUTO_TEST_CASE(WithinBound) {
+    const auto data = smoothField(100001);
+
+    for (double bound : { 1.0e-2, 1.0e-5, 1.0e-9 })
+        checkBound(data, bound);
+
+    // Outliers which need escaped codes, and sizes around the block size.
+    auto spiky = smoothField(600);
+    spiky[17] = 1.0e6;
+    spiky[255] = -3.0e5;
+    checkBound(spiky, 1.0e-3);
+
+    for (std::size_t size : { 0, 1, 255, 256, 257 })
+        checkBound(smoothField(size), 1.0e-3);
+
+    checkBound(std::vector<double>(1000, 42.0), 1.0e-6);
+}
+
+BOOST_AUTO_TEST_CASE(Compresses) {
+    const auto data = smoothField(100000);
+
+    QuantisedField field;
+    BOOST_REQUIRE(quantise(data.data(), data.size(), 1.0e-4, field));
+
+    const auto bytes = field.words.size() * sizeof(std::int32_t);
+    BOOST_TEST_MESSAGE("100000 doubles coded in " << bytes << " bytes");
+    BOOST_CHECK_LT(bytes, data.size() * sizeof(float) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(Rejected) {
+    QuantisedField field;
+    const std::vector<double> data = { 0.0, 1.0 };
+    BOOST_CHECK(!quantise(data.data(), data.size(), 0.0, field));
+
+    const std::vector<double> nan = { 0.0, std::numeric_limits<double>::quiet_NaN() };
+    BOOST_CHECK(!quantise(nan.data(), nan.size(), 1.0, field));
+
+    const std::vector<double> wide = { 0.0, 1.0e20 };
+    BOOST_CHECK(!quantise(wide.data(), wide.size(), 1.0e-3, field));
+
+    BOOST_REQUIRE(quantise(data.data(), data.size(), 1.0e-3, field));
+    field.words.clear();
+    BOOST_CHECK_THROW(dequantise(field), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(RelativeBound) {
+    const std::vector<double> data = { 2.0, 4.0, 12.0 };
+
+    ErrorBound bound;
+    BOOST_CHECK_EQUAL(bound.absolute(data.data(), data.size()), 0.0);
+
+    bound.value = 1.0e-3;
+    BOOST_CHECK_EQUAL(bound.absolute(data.data(), data.size()), 1.0e-3);
+
+    bound.type = ErrorBound::Type::Relative;
+    BOOST_CHECK_CLOSE(bound.absolute(data.data(), data.size()), 1.0e-2, 1.0e-10);
+}
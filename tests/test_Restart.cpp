@@ -17,6 +17,9 @@
 */
 #include "config.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
 
 #define BOOST_TEST_MODULE EclipseIO
@@ -41,6 +44,7 @@
 // ERT stuff
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_kw_magic.h>
 #include <ert/ecl_well/well_info.h>
@@ -468,6 +472,35 @@ BOOST_AUTO_TEST_CASE(EclipseReadWriteWellStateData_double) {
     compare_equal( state1 , state2 , keys);
 }
 
+BOOST_AUTO_TEST_CASE(EclipseReadWriteWellStateData_completion_order) {
+    /*
+      The simulator may pass the completions of a well in any order;
+      they are matched to the schedule completions by active index.
+    */
+    std::map<std::string, RestartKey> keys {{"SWAT" , RestartKey(UnitSystem::measure::identity)}};
+
+    ERT::TestArea testArea("test_Restart");
+    testArea.copyFile( "FIRST_SIM.DATA" );
+
+    Setup setup("FIRST_SIM.DATA");
+    EclipseIO eclWriter( setup.es, setup.grid, setup.schedule, setup.summary_config);
+
+    const auto num_cells = setup.grid.getNumActive( );
+    const auto start_time = ecl_util_make_date( 1, 11, 1979 );
+    const auto first_step = ecl_util_make_date( 10, 10, 2008 );
+
+    const auto wells = mkWells();
+    auto shuffled = wells;
+    auto& completions = shuffled.at( "OP_1" ).completions;
+    std::reverse( completions.begin(), completions.end() );
+
+    eclWriter.writeTimeStep( 1, false, first_step - start_time,
+                             mkSolution( num_cells ), shuffled, {}, {}, {}, {}, false );
+
+    const auto state = second_sim( eclWriter , keys );
+    BOOST_CHECK_EQUAL( state.wells, wells );
+}
+
 BOOST_AUTO_TEST_CASE(WriteWrongSOlutionSize) {
     // This test leads to a segmentation violation on travis, disable until
     // the cause has been found and fixed.
@@ -548,6 +581,39 @@ BOOST_AUTO_TEST_CASE(ExtraData_KEYS) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(WellBuffers_reused) {
+    Setup setup("FIRST_SIM.DATA");
+    ERT::TestArea testArea("test_Restart");
+
+    const auto num_cells = setup.grid.getNumActive( );
+    const auto cells = mkSolution( num_cells );
+    const auto wells = mkWells();
+
+    RestartIO::WellBuffers buffers;
+    RestartIO::SaveOptions options;
+    options.buffers = &buffers;
+    for (int step = 1; step <= 2; step++)
+        RestartIO::save( "FILE.UNRST", step, 100 * step, cells, wells,
+                         setup.es, setup.grid, setup.schedule, {}, false, options );
+
+    /* Both report steps are complete, and equal to a save without buffers. */
+    RestartIO::save( "FILE2.UNRST", 2, 200, cells, wells, setup.es, setup.grid, setup.schedule );
+
+    ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > f1( ecl_file_open( "FILE.UNRST", 0 ) );
+    ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > f2( ecl_file_open( "FILE2.UNRST", 0 ) );
+
+    BOOST_CHECK_EQUAL( ecl_file_get_num_named_kw( f1.get(), "ZWEL" ), 2 );
+    for (const auto* kw : { "IWEL", "ICON", "ZWEL", "OPM_IWEL", "OPM_XWEL" }) {
+        const auto* kw1 = ecl_file_iget_named_kw( f1.get(), kw, 1 );
+        const auto* kw2 = ecl_file_iget_named_kw( f2.get(), kw, 0 );
+        BOOST_CHECK_MESSAGE( ecl_kw_equal( kw1, kw2 ), "Keyword " << kw << " differs" );
+    }
+
+    const auto* zwel = ecl_file_iget_named_kw( f1.get(), "ZWEL", 0 );
+    BOOST_CHECK_EQUAL( std::string( ecl_kw_iget_char_ptr( zwel, 0 ) ).substr( 0, 4 ), "OP_1" );
+    BOOST_CHECK_EQUAL( std::string( ecl_kw_iget_char_ptr( zwel, 3 ) ).substr( 0, 4 ), "OP_2" );
+}
+
 BOOST_AUTO_TEST_CASE(ExtraData_content) {
     Setup setup("FIRST_SIM.DATA");
     {
@@ -603,3 +669,180 @@ BOOST_AUTO_TEST_CASE(ExtraData_content) {
 }
 
 }
+
+BOOST_AUTO_TEST_CASE(DeltaEncoded_solution) {
+    Setup setup("FIRST_SIM.DATA");
+    ERT::TestArea testArea("test_Restart");
+
+    const auto num_cells = setup.grid.getNumActive( );
+    const auto wells = mkWells();
+    const std::map<std::string, RestartKey> keys {{"PRESSURE" , RestartKey(UnitSystem::measure::pressure)},
+                                                  {"SWAT" , RestartKey(UnitSystem::measure::identity)},
+                                                  {"RS" , RestartKey(UnitSystem::measure::identity)}};
+
+    for (bool unified : { true, false }) {
+        RestartIO::DeltaEncoder encoder;
+        encoder.keyframe_interval = 3;
+        RestartIO::SaveOptions options;
+        options.delta = &encoder;
+
+        std::vector< data::Solution > saved;
+        for (int step = 1; step <= 4; step++) {
+            auto cells = mkSolution( num_cells );
+            cells.data("SWAT")[ step ] = 0.5 + step;
+            for (auto& rs : cells.data("RS"))
+                rs += step;
+
+            const auto filename = unified ? std::string( "FILE.UNRST" ) : "FILE.X000" + std::to_string( step );
+            RestartIO::save( filename, step, 100 * step, cells, wells,
+                             setup.es, setup.grid, setup.schedule, {}, true, options );
+            saved.push_back( cells );
+
+            /* Steps 2 and 3 store SWAT and PRESSURE as deltas against step 1; RS changes everywhere. */
+            ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > f( ecl_file_open( filename.c_str(), 0 ) );
+            ecl_file_view_type * view = unified ? ecl_file_get_restart_view( f.get(), -1, step, -1, -1 )
+                                                : ecl_file_get_global_view( f.get() );
+            const bool delta = step == 2 || step == 3;
+            BOOST_CHECK_EQUAL( ecl_file_view_has_kw( view, "OPM_DLTA" ), delta );
+            BOOST_CHECK_EQUAL( ecl_file_view_has_kw( view, "SWAT" ), !delta );
+            BOOST_CHECK( ecl_file_view_has_kw( view, "RS" ) );
+            if (delta) {
+                const auto* ref = ecl_file_view_iget_named_kw( view, "OPM_DREF", 0 );
+                BOOST_CHECK_EQUAL( ecl_kw_iget_int( ref, 0 ), 1 );
+            }
+        }
+
+        for (int step = 1; step <= 4; step++) {
+            const auto filename = unified ? std::string( "FILE.UNRST" ) : "FILE.X000" + std::to_string( step );
+            const auto rst_value = RestartIO::load( filename, step, keys, setup.es, setup.grid, setup.schedule );
+            const auto& cells = saved[ step - 1 ];
+            for (const auto& pair : keys) {
+                const auto& expected = cells.data( pair.first );
+                const auto& actual = rst_value.solution.data( pair.first );
+                BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+                for (size_t i = 0; i < expected.size(); i++)
+                    BOOST_CHECK_CLOSE( actual[i], expected[i], 1.0e-8 );
+            }
+        }
+    }
+
+    /* A delta encoded step cannot be loaded without its keyframe. */
+    std::remove( "FILE.X0001" );
+    BOOST_CHECK_THROW( RestartIO::load( "FILE.X0002", 2, keys, setup.es, setup.grid, setup.schedule ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE(LoadCellRanges) {
+    Setup setup("FIRST_SIM.DATA");
+    ERT::TestArea testArea("test_Restart");
+
+    const int num_cells = setup.grid.getNumActive( );
+    const auto wells = mkWells();
+    const std::map<std::string, RestartKey> keys {{"PRESSURE" , RestartKey(UnitSystem::measure::pressure)},
+                                                  {"SWAT" , RestartKey(UnitSystem::measure::identity)},
+                                                  {"RS" , RestartKey(UnitSystem::measure::identity)}};
+
+    const std::vector< int > gather = { num_cells - 1, 3, 4, 5, 0, 10, 11 };
+    const auto ranges = RestartIO::cellRanges( gather );
+    BOOST_REQUIRE_EQUAL( ranges.size(), 4U );
+    BOOST_CHECK( ranges[1] == std::make_pair( 3, 6 ) );
+    BOOST_CHECK( ranges[3] == std::make_pair( 10, 12 ) );
+
+    /*
+      The files are written by RestartIO::save(), so the reader has to
+      skip its LOGIHEAD (LOGI) and STARTSOL/ENDSOL (MESS) keywords.
+    */
+    for (const std::string filename : { "FILE.UNRST", "FILE.FUNRST", "FILE.X0002" }) {
+        /* Step 2 stores SWAT as a delta against step 1. */
+        RestartIO::DeltaEncoder encoder;
+        RestartIO::SaveOptions options;
+        options.delta = &encoder;
+        for (int step = 1; step <= 2; step++) {
+            auto cells = mkSolution( num_cells );
+            for (int i = 0; i < num_cells; i++)
+                cells.data("SWAT")[i] = 0.01 * i;
+            cells.data("SWAT")[ 4 ] = step;
+            cells.data("PRESSURE")[ num_cells - 1 ] = step;
+
+            const auto name = filename == "FILE.X0002" ? "FILE.X000" + std::to_string( step ) : filename;
+            RestartIO::save( name, step, 100 * step, cells, wells,
+                             setup.es, setup.grid, setup.schedule, {{"EXTRA", {1, 2}}}, false, options );
+        }
+
+        const auto full = RestartIO::load( filename, 2, keys, setup.es, setup.grid, setup.schedule );
+        const auto part = RestartIO::loadCells( filename, 2, keys, ranges, setup.es, setup.grid, setup.schedule, {{"EXTRA", true}} );
+
+        for (const auto& pair : keys) {
+            const auto& all = full.solution.data( pair.first );
+            const auto& selected = part.solution.data( pair.first );
+            BOOST_REQUIRE_EQUAL( selected.size(), gather.size() );
+            for (size_t i = 0; i < gather.size(); i++)
+                BOOST_CHECK_EQUAL( selected[i], all[ gather[i] ] );
+        }
+
+        BOOST_CHECK_EQUAL( part.solution.data( "SWAT" )[2], 2.0 );
+        BOOST_CHECK_EQUAL( part.wells.size(), full.wells.size() );
+        BOOST_CHECK_EQUAL( part.extra.at( "EXTRA" ).size(), 2U );
+    }
+
+    BOOST_CHECK_THROW( RestartIO::loadCells( "FILE.UNRST", 2, keys, {{0, num_cells + 1}}, setup.es, setup.grid, setup.schedule ), std::invalid_argument );
+    BOOST_CHECK_THROW( RestartIO::loadCells( "FILE.UNRST", 2, keys, {{0, 5}, {4, 6}}, setup.es, setup.grid, setup.schedule ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(LossyAuxiliary) {
+    Setup setup("FIRST_SIM.DATA");
+    ERT::TestArea testArea("test_Restart");
+
+    const int num_cells = setup.grid.getNumActive( );
+    auto cells = mkSolution( num_cells );
+    std::vector< double > kro( num_cells ), krw( num_cells );
+    for (int i = 0; i < num_cells; i++) {
+        kro[i] = 0.5 + 0.4 * std::sin( 0.01 * i );
+        krw[i] = 1.0 - kro[i];
+    }
+    cells.insert( "KRO", UnitSystem::measure::identity, kro, data::TargetType::RESTART_AUXILIARY );
+    cells.insert( "KRW", UnitSystem::measure::identity, krw, data::TargetType::RESTART_AUXILIARY );
+
+    RestartIO::AuxiliaryCompression compression;
+    compression.default_bound.value = 1.0e-3;
+    compression.fields["KRW"].type = out::ErrorBound::Type::Relative;
+    compression.fields["KRW"].value = 1.0e-2;
+
+    RestartIO::SaveOptions options;
+    options.compression = &compression;
+    RestartIO::save( "FILE.UNRST", 1, 100, cells, mkWells(), setup.es, setup.grid, setup.schedule,
+                     {}, false, options );
+
+    {
+        ERT::ert_unique_ptr< ecl_file_type, ecl_file_close > f( ecl_file_open( "FILE.UNRST", 0 ) );
+        BOOST_CHECK( ecl_file_has_kw( f.get(), "OPM_LOSY" ) );
+        BOOST_CHECK( !ecl_file_has_kw( f.get(), "KRO" ) );
+        BOOST_CHECK( ecl_file_has_kw( f.get(), "SWAT" ) );
+    }
+
+    const auto rst_value = RestartIO::load( "FILE.UNRST", 1, {{"SWAT" , RestartKey(UnitSystem::measure::identity)},
+                                                              {"KRO" , RestartKey(UnitSystem::measure::identity)},
+                                                              {"KRW" , RestartKey(UnitSystem::measure::identity)}},
+                                            setup.es, setup.grid, setup.schedule );
+
+    const auto& swat = rst_value.solution.data( "SWAT" );
+    const auto& kro_read = rst_value.solution.data( "KRO" );
+    const auto& krw_read = rst_value.solution.data( "KRW" );
+    BOOST_REQUIRE_EQUAL( kro_read.size(), kro.size() );
+    BOOST_REQUIRE_EQUAL( krw_read.size(), krw.size() );
+
+    const double krw_bound = 1.0e-2 * (*std::max_element( krw.begin(), krw.end() ) - *std::min_element( krw.begin(), krw.end() ));
+    for (int i = 0; i < num_cells; i++) {
+        BOOST_CHECK_EQUAL( swat[i], cells.data( "SWAT" )[i] );
+        BOOST_CHECK_LE( std::fabs( kro_read[i] - kro[i] ), 1.0e-3 );
+        BOOST_CHECK_LE( std::fabs( krw_read[i] - krw[i] ), krw_bound );
+    }
+
+    /* Only the numbered keywords of the encodings are reserved. */
+    for (const char* key : { "OPMQH000", "OPMQD012", "OPMDI999", "OPMDV001", "OPM_LOSY", "OPM_DREF" })
+        BOOST_CHECK_THROW( RestartIO::save( "FILE.UNRST", 1, 100, cells, mkWells(), setup.es, setup.grid, setup.schedule,
+                                            {{key, {1.0}}} ), std::runtime_error );
+
+    for (const char* key : { "OPMDATA", "OPMQUAL", "OPMDI01X" })
+        BOOST_CHECK_NO_THROW( RestartIO::save( "FILE.UNRST", 1, 100, cells, mkWells(), setup.es, setup.grid, setup.schedule,
+                                               {{key, {1.0}}} ) );
+}
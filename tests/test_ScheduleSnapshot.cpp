@@ -0,0 +1,97 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE ScheduleSnapshot
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Completion.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/CompletionSet.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Well.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+#include <opm/output/eclipse/ScheduleSnapshot.hpp>
+
+using namespace Opm;
+
+const char* path = "summary_deck.DATA";
+
+
+BOOST_AUTO_TEST_CASE(matches_schedule) {
+    ParseContext parseContext;
+    Parser parser;
+    Deck deck( parser.parseFile( path, parseContext ));
+    EclipseState es(deck , parseContext );
+    const EclipseGrid& grid = es.getInputGrid();
+    Schedule schedule( deck, grid, es.get3DProperties(), es.runspec().phases(), ParseContext() );
+
+    for (size_t step = 0; step < schedule.getTimeMap().size(); step++) {
+        out::ScheduleSnapshot snapshot( schedule, grid, step );
+        const auto sched_wells = schedule.getWells( step );
+
+        BOOST_CHECK_EQUAL( snapshot.reportStep(), step );
+        BOOST_CHECK_EQUAL( snapshot.numWells(), schedule.numWells( step ) );
+        BOOST_CHECK_EQUAL( snapshot.maxCompletions(), schedule.getMaxNumCompletionsForWells( step ) );
+        BOOST_CHECK( snapshot.wells() == sched_wells );
+        BOOST_CHECK_EQUAL( snapshot.wellInfo().size(), sched_wells.size() );
+
+        for (size_t w = 0; w < sched_wells.size(); w++) {
+            const auto* well = sched_wells[w];
+            const auto& info = snapshot.wellInfo()[w];
+            const auto& completions = well->getCompletions( step );
+
+            BOOST_CHECK( snapshot.well( well->name() ) == &info );
+            BOOST_CHECK_EQUAL( info.open, well->getStatus( step ) == WellCommon::OPEN );
+            BOOST_CHECK_EQUAL( info.rft_active, well->getRFTActive( step ) );
+            BOOST_CHECK_EQUAL( info.numCompletions(), completions.size() );
+
+            size_t c = info.completion_begin;
+            for (const auto& completion : completions) {
+                const auto& ci = snapshot.completions()[c++];
+                const auto i = completion.getI(), j = completion.getJ(), k = completion.getK();
+
+                BOOST_CHECK( ci.completion == &completion );
+                if (grid.cellActive( i, j, k ))
+                    BOOST_CHECK_EQUAL( ci.active_index, int( grid.activeIndex( i, j, k ) ) );
+                else
+                    BOOST_CHECK_EQUAL( ci.active_index, -1 );
+            }
+
+            const auto group = well->getGroupName( step );
+            const auto* group_wells = snapshot.groupWells( group );
+            BOOST_REQUIRE( group_wells != nullptr );
+            BOOST_CHECK( *group_wells == schedule.getWells( group, step ) );
+        }
+
+        if (!sched_wells.empty()) {
+            const auto* field = snapshot.groupWells( "FIELD" );
+            BOOST_REQUIRE( field != nullptr );
+            BOOST_CHECK( *field == schedule.getWells( "FIELD", step ) );
+        }
+    }
+
+    out::ScheduleSnapshot snapshot( schedule, grid, 1 );
+    BOOST_CHECK( snapshot.well( "NO_SUCH_WELL" ) == nullptr );
+    BOOST_CHECK( snapshot.groupWells( "NO_SUCH_GROUP" ) == nullptr );
+}
@@ -23,14 +23,17 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <cmath>
 #include <stdexcept>
 
+#include <ert/ecl/ecl_smspec.h>
 #include <ert/ecl/ecl_sum.h>
 #include <ert/util/util.h>
 #include <ert/util/TestArea.hpp>
 
 #include <opm/output/data/Wells.hpp>
 #include <opm/output/eclipse/Summary.hpp>
+#include <opm/output/util/ThreadPool.hpp>
 
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
@@ -769,6 +772,198 @@ BOOST_AUTO_TEST_CASE(report_steps_time) {
     BOOST_CHECK_EQUAL( ecl_sum_get_sim_length( resp ), 10 );
 }
 
+BOOST_AUTO_TEST_CASE(substep_cadence) {
+    setup cfg( "test_summary_substep_cadence" );
+
+    out::SummaryCadence cadence;
+    cadence.every = 3;
+    cadence.keywords = { "WOPR" };
+
+    {
+        out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+        writer.set_substep_cadence( cadence );
+
+        BOOST_CHECK( writer.add_timestep( 0, 0 * day, cfg.es, cfg.schedule, cfg.wells, {} ) );
+        for (int substep = 1; substep <= 6; substep++) {
+            const bool recorded = writer.add_timestep( 1, substep * day, cfg.es, cfg.schedule, cfg.wells,
+                                                       {}, {}, {}, {}, true );
+            BOOST_CHECK_EQUAL( recorded, substep % 3 == 0 );
+        }
+        BOOST_CHECK( writer.add_timestep( 1, 7 * day, cfg.es, cfg.schedule, cfg.wells, {} ) );
+        writer.write();
+    }
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+
+    BOOST_CHECK_EQUAL( ecl_sum_get_data_length( resp ), 4 );
+    BOOST_CHECK_EQUAL( ecl_sum_iget_sim_days( resp, 1 ), 3 );
+    BOOST_CHECK_EQUAL( ecl_sum_iget_sim_days( resp, 2 ), 6 );
+
+    /* Totals include the substeps which were not written. */
+    BOOST_CHECK_CLOSE( 3 * 10.1, ecl_sum_get_well_var( resp, 1, "W_1", "WOPT" ), 1e-5 );
+    BOOST_CHECK_CLOSE( 7 * 10.1, ecl_sum_get_well_var( resp, 3, "W_1", "WOPT" ), 1e-5 );
+
+    /* Vectors outside the substep subset repeat the previous record. */
+    BOOST_CHECK_CLOSE( ecl_sum_get_well_var( resp, 0, "W_1", "WWPR" ),
+                       ecl_sum_get_well_var( resp, 2, "W_1", "WWPR" ), 1e-5 );
+}
+
+BOOST_AUTO_TEST_CASE(substep_min_interval) {
+    setup cfg( "test_summary_substep_min_interval" );
+
+    out::SummaryCadence cadence;
+    cadence.min_interval = 2.5 * day;
+
+    {
+        out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+        writer.set_substep_cadence( cadence );
+
+        writer.add_timestep( 0, 0 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        for (int substep = 1; substep <= 6; substep++)
+            writer.add_timestep( 1, substep * day, cfg.es, cfg.schedule, cfg.wells, {}, {}, {}, {}, true );
+        writer.write();
+    }
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+
+    /* Records at 0, 3 and 6 days. */
+    BOOST_CHECK_EQUAL( ecl_sum_get_data_length( resp ), 3 );
+    BOOST_CHECK_CLOSE( 6 * 10.1, ecl_sum_get_well_var( resp, 2, "W_1", "WOPT" ), 1e-5 );
+}
+
+BOOST_AUTO_TEST_CASE(totals_checkpoint) {
+    setup cfg( "test_summary_totals_checkpoint" );
+
+    std::map< std::string, std::vector< double > > checkpoint;
+    {
+        out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+        writer.add_timestep( 0, 0 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        writer.add_timestep( 1, 1 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        writer.add_timestep( 2, 2 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        checkpoint = writer.totals_checkpoint();
+    }
+
+    const auto& totals = checkpoint.at( out::Summary::totals_key );
+    const auto& keys = checkpoint.at( out::Summary::totals_names_key );
+    BOOST_CHECK( !totals.empty() );
+    BOOST_CHECK_EQUAL( totals.size(), keys.size() + 1 );
+    BOOST_CHECK_EQUAL( totals.back(), 2 * day );
+
+    {
+        out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+
+        /* Maps without the checkpoint are ignored. */
+        writer.restore_totals( {} );
+        writer.restore_totals( checkpoint );
+
+        writer.add_timestep( 3, 3 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        writer.write();
+    }
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+
+    BOOST_CHECK_CLOSE( 3 * 10.1, ecl_sum_get_well_var( resp, 0, "W_1", "WOPT" ), 1e-5 );
+    BOOST_CHECK_CLOSE( 3 * 20.1, ecl_sum_get_well_var( resp, 0, "W_2", "WOPT" ), 1e-5 );
+
+    {
+        out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+        auto broken = checkpoint;
+        broken[ out::Summary::totals_key ].pop_back();
+        BOOST_CHECK_THROW( writer.restore_totals( broken ), std::invalid_argument );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(streaming_writer) {
+    setup cfg( "test_summary_streaming" );
+
+    out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+    writer.add_timestep( 0, 0 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+    writer.add_timestep( 1, 1 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+    writer.write();
+
+    {
+        auto res = readsum( cfg.name );
+        BOOST_CHECK_EQUAL( ecl_sum_get_data_length( res.get() ), 2 );
+    }
+
+    /* Records are appended; the earlier records are not rewritten. */
+    writer.add_timestep( 1, 1.5 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+    writer.add_timestep( 2, 2 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+    writer.write();
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+
+    BOOST_CHECK_EQUAL( ecl_sum_get_data_length( resp ), 4 );
+    BOOST_CHECK_CLOSE( 1.5, ecl_sum_iget_sim_days( resp, 2 ), 1e-5 );
+    BOOST_CHECK_CLOSE( 10.1, ecl_sum_get_well_var( resp, 3, "W_1", "WOPR" ), 1e-5 );
+    BOOST_CHECK_CLOSE( 2 * 10.1, ecl_sum_get_well_var( resp, 3, "W_1", "WOPT" ), 1e-5 );
+}
+
+BOOST_AUTO_TEST_CASE(parallel_evaluation) {
+    setup cfg( "test_summary_parallel" );
+
+    const auto run = [&cfg]( out::ThreadPool& pool, const std::string& name ) {
+        out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, name );
+        writer.set_thread_pool( pool );
+        writer.add_timestep( 0, 0 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        writer.add_timestep( 1, 1 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        writer.add_timestep( 2, 2 * day, cfg.es, cfg.schedule, cfg.wells, {} );
+        writer.write();
+    };
+
+    out::ThreadPool serial( 0 );
+    out::ThreadPool parallel( 4 );
+    run( serial, cfg.name + "_SERIAL" );
+    run( parallel, cfg.name + "_PARALLEL" );
+
+    auto res1 = readsum( cfg.name + "_SERIAL" );
+    auto res2 = readsum( cfg.name + "_PARALLEL" );
+
+    const auto length = ecl_sum_get_data_length( res1.get() );
+    const auto params_size = ecl_smspec_get_params_size( ecl_sum_get_smspec( res1.get() ) );
+
+    BOOST_CHECK_EQUAL( length, ecl_sum_get_data_length( res2.get() ) );
+    BOOST_CHECK_EQUAL( params_size, ecl_smspec_get_params_size( ecl_sum_get_smspec( res2.get() ) ) );
+
+    for (int step = 0; step < length; ++step) {
+        for (int param = 0; param < params_size; ++param)
+            BOOST_CHECK_EQUAL( ecl_sum_iget( res1.get(), step, param ),
+                               ecl_sum_iget( res2.get(), step, param ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(history) {
+    setup cfg( "test_summary_history" );
+
+    out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+    BOOST_CHECK( !writer.history() );
+
+    const auto& history = writer.enable_history( 2 );
+    BOOST_CHECK_THROW( writer.enable_history( 4 ), std::logic_error );
+    for (int step = 0; step < 3; ++step)
+        writer.add_timestep( step, step * day, cfg.es, cfg.schedule, cfg.wells, {} );
+    writer.write();
+
+    const auto wopr = history.index( "WOPR:W_1" );
+    BOOST_REQUIRE( wopr < history.numVectors() );
+    BOOST_CHECK_EQUAL( history.records(), 3U );
+
+    std::vector< double > times;
+    std::vector< float > values;
+    BOOST_CHECK_EQUAL( history.series( wopr, 10, times, values ), 2U );
+    BOOST_CHECK_EQUAL( times[0], 1.0 * day );
+    BOOST_CHECK_EQUAL( times[1], 2.0 * day );
+    BOOST_CHECK_CLOSE( values[1], 10.1, 1e-5 );
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+    BOOST_CHECK_EQUAL( values[1], ecl_sum_get_well_var( resp, 2, "W_1", "WOPR" ) );
+}
+
 BOOST_AUTO_TEST_CASE(skip_unknown_var) {
     setup cfg( "test_summary_skip_unknown_var" );
 
@@ -922,6 +1117,48 @@ BOOST_AUTO_TEST_CASE(region_vars) {
 }
 
 
+BOOST_AUTO_TEST_CASE(region_vars_from_solution) {
+    setup cfg( "region_vars_from_solution" );
+
+    const auto num_active = cfg.grid.getNumActive();
+    std::vector< double > pressure( num_active ), oip( num_active, 2.0 ), swat( num_active, 0.3 );
+    for (size_t active_index = 0; active_index < num_active; active_index++)
+        pressure[ active_index ] = (cfg.grid.getGlobalIndex( active_index ) / 100 + 1) * 1.0e5;
+
+    data::Solution cells;
+    cells.insert( "PRESSURE", UnitSystem::measure::pressure, pressure, data::TargetType::RESTART_SOLUTION );
+    cells.insert( "OIP", UnitSystem::measure::volume, oip, data::TargetType::RESTART_SOLUTION );
+    cells.insert( "SWAT", UnitSystem::measure::identity, swat, data::TargetType::RESTART_SOLUTION );
+
+    // Explicit region values take precedence over the solution.
+    std::map<std::string, std::vector<double>> region_values;
+    region_values["ROIP"] = std::vector<double>( 10, 7.0 );
+
+    out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+    writer.add_timestep( 0, 0 * day, cfg.es, cfg.schedule, cfg.wells, {}, {}, {}, cells );
+    writer.add_timestep( 1, 1 * day, cfg.es, cfg.schedule, cfg.wells, {}, region_values, {}, cells );
+    writer.write();
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+
+    UnitSystem units( UnitSystem::UnitType::UNIT_TYPE_METRIC );
+    for (size_t r=1; r <= 10; r++) {
+        std::string rpr_key   = "RPR:"   + std::to_string( r );
+        std::string roip_key  = "ROIP:"  + std::to_string( r );
+        double area = cfg.grid.getNX() * cfg.grid.getNY();
+
+        // There is one inactive cell in the bottom layer.
+        if (r == 10)
+            area -= 1;
+
+        BOOST_CHECK_CLOSE( r * 1.0e5 , units.to_si( UnitSystem::measure::pressure , ecl_sum_get_general_var( resp, 0, rpr_key.c_str())) , 1e-5);
+        BOOST_CHECK_CLOSE( area * 2.0 , units.to_si( UnitSystem::measure::volume , ecl_sum_get_general_var( resp, 0, roip_key.c_str())) , 1e-5);
+        BOOST_CHECK_CLOSE( 7.0 , units.to_si( UnitSystem::measure::volume , ecl_sum_get_general_var( resp, 1, roip_key.c_str())) , 1e-5);
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE(region_production) {
     setup cfg( "region_production" );
 
@@ -1017,6 +1254,95 @@ BOOST_AUTO_TEST_CASE(BLOCK_VARIABLES) {
 }
 
 
+BOOST_AUTO_TEST_CASE(block_vars_from_solution) {
+    setup cfg( "block_vars_from_solution" );
+
+    const auto num_active = cfg.grid.getNumActive();
+    std::vector< double > pressure( num_active ), swat( num_active, 0.3 ), sgas( num_active, 0.2 );
+    for (size_t r = 1; r <= 10; r++)
+        pressure[ cfg.grid.activeIndex( (r-1)*100 ) ] = r * 1.0e5;
+
+    data::Solution cells;
+    cells.insert( "PRESSURE", UnitSystem::measure::pressure, pressure, data::TargetType::RESTART_SOLUTION );
+    cells.insert( "SWAT", UnitSystem::measure::identity, swat, data::TargetType::RESTART_SOLUTION );
+    cells.insert( "SGAS", UnitSystem::measure::identity, sgas, data::TargetType::RESTART_SOLUTION );
+
+    // Explicit block values take precedence over the solution.
+    std::map<std::pair<std::string, int>, double> block_values;
+    block_values[std::make_pair("BSGAS", 1)] = 0.9;
+
+    out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+    writer.add_timestep( 0, 0 * day, cfg.es, cfg.schedule, cfg.wells, {}, {}, block_values, cells );
+    writer.add_timestep( 1, 1 * day, cfg.es, cfg.schedule, cfg.wells, {}, {}, block_values, cells );
+    writer.write();
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+
+    UnitSystem units( UnitSystem::UnitType::UNIT_TYPE_METRIC );
+    for (size_t r=1; r <= 10; r++) {
+        std::string bpr_key   = "BPR:1,1,"   + std::to_string( r );
+        BOOST_CHECK_CLOSE( r * 1.0e5 , units.to_si( UnitSystem::measure::pressure , ecl_sum_get_general_var( resp, 1, bpr_key.c_str())) , 1e-5);
+    }
+
+    BOOST_CHECK_CLOSE( 0.3 , ecl_sum_get_general_var( resp, 1, "BSWAT:1,1,1") , 1e-5);
+    BOOST_CHECK_CLOSE( 0.9 , ecl_sum_get_general_var( resp, 1, "BSGAS:1,1,1") , 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(value_handles) {
+    setup cfg( "value_handles" );
+
+    out::Summary writer( cfg.es, cfg.config, cfg.grid, cfg.schedule, cfg.name );
+
+    // Inactive cell and unknown vectors have no handle.
+    BOOST_CHECK_EQUAL( writer.block_value_handle( "BPR", 901 + 1 ), out::Summary::no_handle );
+    BOOST_CHECK_EQUAL( writer.region_value_handle( "RPR", 11 ), out::Summary::no_handle );
+    BOOST_CHECK_EQUAL( writer.single_value_handle( "NO_SUCH" ), out::Summary::no_handle );
+
+    std::vector< size_t > bpr, roip;
+    for (int r = 1; r <= 10; r++) {
+        bpr.push_back( writer.block_value_handle( "BPR", (r-1)*100 + 1 ) );
+        roip.push_back( writer.region_value_handle( "ROIP", r ) );
+        BOOST_CHECK( bpr.back() < writer.num_value_handles() );
+        BOOST_CHECK( roip.back() < writer.num_value_handles() );
+    }
+    const auto bswat = writer.block_value_handle( "BSWAT", 1 );
+    BOOST_CHECK( bswat < writer.num_value_handles() );
+
+    BOOST_CHECK_THROW( writer.stage_values( std::vector< double >( writer.num_value_handles() + 1 ) ), std::invalid_argument );
+
+    for (int step = 0; step < 3; step++) {
+        std::vector< double > values( writer.num_value_handles(), std::nan("") );
+        for (int r = 1; r <= 10; r++) {
+            values[ bpr[r - 1] ] = r * 1.0 + step;
+            values[ roip[r - 1] ] = 2.0 * r;
+        }
+        values[ bswat ] = 0.25;
+
+        // Staged values override those given by name.
+        std::map<std::pair<std::string, int>, double> block_values;
+        block_values[std::make_pair("BPR", 1)] = -1.0;
+
+        writer.stage_values( values );
+        writer.add_timestep( step, step * day, cfg.es, cfg.schedule, cfg.wells, {}, {}, block_values );
+    }
+    writer.write();
+
+    auto res = readsum( cfg.name );
+    const auto* resp = res.get();
+
+    UnitSystem units( UnitSystem::UnitType::UNIT_TYPE_METRIC );
+    for (size_t r=1; r <= 10; r++) {
+        std::string bpr_key   = "BPR:1,1,"   + std::to_string( r );
+        std::string roip_key  = "ROIP:"  + std::to_string( r );
+
+        BOOST_CHECK_CLOSE( r * 1.0 + 2 , units.to_si( UnitSystem::measure::pressure , ecl_sum_get_general_var( resp, 2, bpr_key.c_str())) , 1e-5);
+        BOOST_CHECK_CLOSE( 2.0 * r , units.to_si( UnitSystem::measure::volume , ecl_sum_get_general_var( resp, 2, roip_key.c_str())) , 1e-5);
+    }
+    BOOST_CHECK_CLOSE( 0.25 , ecl_sum_get_general_var( resp, 2, "BSWAT:1,1,1") , 1e-5);
+}
+
+
 
 /*
   The SummaryConfig.require3DField( ) implementation is slightly ugly:
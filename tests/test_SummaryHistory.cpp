@@ -0,0 +1,163 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE SummaryHistory
+#include <boost/test/unit_test.hpp>
+
+#include <opm/output/eclipse/SummaryHistory.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace Opm::out;
+
+namespace {
+
+const std::vector< std::string > keys = { "TIME", "FOPR", "WOPR:OP_1", "" };
+
+/* Record n holds n + i in vector i, so a reader can recognise torn records. */
+void append( SummaryHistory& history, int n ) {
+    std::vector< float > values;
+    for (std::size_t i = 0; i < history.numVectors(); ++i)
+        values.push_back( float( n + i ) );
+
+    history.append( 10.0 * n, n / 2, values.data() );
+}
+
+} // Anonymous
+
+BOOST_AUTO_TEST_CASE(Wraparound) {
+    SummaryHistory history( keys, 3 );
+    BOOST_CHECK( history.keys() == keys );
+    BOOST_CHECK_EQUAL( history.index( "WOPR:OP_1" ), 2U );
+    BOOST_CHECK_EQUAL( history.index( "WOPR:OP_2" ), history.numVectors() );
+
+    double secs;
+    int step;
+    std::vector< float > values;
+    BOOST_CHECK( !history.read( 0, secs, step, values ) );
+
+    for (int n = 0; n < 5; ++n)
+        append( history, n );
+
+    BOOST_CHECK_EQUAL( history.records(), 5U );
+    BOOST_CHECK( !history.read( 1, secs, step, values ) );
+    BOOST_CHECK( !history.read( 5, secs, step, values ) );
+
+    BOOST_REQUIRE( history.read( 3, secs, step, values ) );
+    BOOST_CHECK_EQUAL( secs, 30.0 );
+    BOOST_CHECK_EQUAL( step, 1 );
+    BOOST_CHECK( values == std::vector< float >( { 3, 4, 5, 6 } ) );
+
+    std::vector< double > times;
+    BOOST_CHECK_EQUAL( history.series( 1, 10, times, values ), 3U );
+    BOOST_CHECK( times == std::vector< double >( { 20, 30, 40 } ) );
+    BOOST_CHECK( values == std::vector< float >( { 3, 4, 5 } ) );
+
+    BOOST_CHECK_EQUAL( history.series( 1, 2, times, values ), 2U );
+    BOOST_CHECK( times == std::vector< double >( { 30, 40 } ) );
+
+    BOOST_CHECK_THROW( history.series( 4, 2, times, values ), std::out_of_range );
+    BOOST_CHECK_THROW( SummaryHistory( keys, 0 ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentReader) {
+    SummaryHistory history( keys, 4 );
+    const int records = 200000;
+
+    std::atomic< bool > torn( false );
+    std::atomic< int > copied( 0 );
+    std::thread reader( [&] {
+        double secs;
+        int step;
+        std::vector< float > values;
+        std::uint64_t n = 0;
+
+        while (n < std::uint64_t( records )) {
+            const auto count = history.records();
+            if (count == 0)
+                continue;
+
+            n = std::max( n, count - 1 );
+            if (n >= count)
+                continue;
+
+            if (history.read( n, secs, step, values )) {
+                for (std::size_t i = 0; i < values.size(); ++i)
+                    torn = torn || values[i] != float( n + i );
+                torn = torn || secs != 10.0 * n || step != int( n / 2 );
+                ++copied;
+            }
+
+            ++n;
+        }
+    } );
+
+    for (int n = 0; n < records; ++n)
+        append( history, n );
+
+    /* The reader stops after the last record. */
+    append( history, records );
+    reader.join();
+
+    BOOST_CHECK( !torn );
+    BOOST_CHECK_GT( copied, 0 );
+}
+
+BOOST_AUTO_TEST_CASE(SharedMemory) {
+    const std::string name = "/opm-test-summary-history-" + std::to_string( ::getpid() );
+
+    {
+        SummaryHistory history( keys, 8, name );
+        for (int n = 0; n < 10; ++n)
+            append( history, n );
+
+        /* A second history can not take over the name while the first one runs. */
+        BOOST_CHECK_THROW( SummaryHistory( keys, 8, name ), std::runtime_error );
+
+        auto view = SummaryHistory::attach( name );
+        BOOST_CHECK( view->keys() == keys );
+        BOOST_CHECK_EQUAL( view->capacity(), 8U );
+        BOOST_CHECK_EQUAL( view->records(), 10U );
+
+        append( history, 10 );
+
+        double secs;
+        int step;
+        std::vector< float > values;
+        BOOST_REQUIRE( view->read( 10, secs, step, values ) );
+        BOOST_CHECK_EQUAL( secs, 100.0 );
+        BOOST_CHECK( values == std::vector< float >( { 10, 11, 12, 13 } ) );
+        BOOST_CHECK( !view->read( 2, secs, step, values ) );
+
+        BOOST_CHECK_THROW( view->append( 0.0, 0, values.data() ), std::logic_error );
+    }
+
+    /* The writer removes the shared memory object. */
+    BOOST_CHECK_THROW( SummaryHistory::attach( name ), std::runtime_error );
+}
@@ -23,14 +23,20 @@
 #include <boost/test/unit_test.hpp>
 
 #include <opm/output/eclipse/Tables.hpp>
+#include <opm/output/eclipse/TablesCache.hpp>
+#include <opm/output/util/ThreadPool.hpp>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <atomic>
 #include <cstddef>
 #include <exception>
 #include <fstream>
 #include <initializer_list>
+#include <iterator>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include <ert/ecl/ecl_kw_magic.h>
@@ -1327,6 +1333,22 @@ BOOST_AUTO_TEST_CASE (Oil_Water_Family_One)
     }
 }
 
+BOOST_AUTO_TEST_CASE (Oil_Water_Family_One_Pool)
+{
+    const auto es = SPE9::TwoPhase::OilWater::satfuncTables();
+
+    auto serial = Opm::Tables{ es.getUnits() };
+    serial.addSatFunc(es);
+
+    Opm::out::ThreadPool pool( 4 );
+    auto parallel = Opm::Tables{ es.getUnits() };
+    parallel.setThreadPool( pool );
+    parallel.addSatFunc(es);
+
+    BOOST_CHECK( parallel.tabdims() == serial.tabdims() );
+    BOOST_CHECK( parallel.tab() == serial.tab() );
+}
+
 BOOST_AUTO_TEST_CASE (Oil_Water_Family_Two)
 {
     const auto es = SPE1::TwoPhase::OilWater::satfuncTables();
@@ -1605,3 +1627,122 @@ BOOST_AUTO_TEST_CASE (Serialize_Family_Two)
 }
 
 BOOST_AUTO_TEST_SUITE_END ()
+
+// #####################################################################
+
+BOOST_AUTO_TEST_SUITE (Tables_Cache)
+
+BOOST_AUTO_TEST_CASE (Key_Depends_On_Content)
+{
+    const auto deck1 = Parser().parseFile( "table_deck.DATA", ParseContext() );
+    const auto deck2 = Parser().parseFile( "summary_deck.DATA", ParseContext() );
+
+    const auto key = TablesCache::key( EclipseState( deck1, ParseContext() ) );
+
+    BOOST_CHECK_EQUAL( key.size(), 16U );
+    BOOST_CHECK_EQUAL( key, TablesCache::key( EclipseState( deck1, ParseContext() ) ) );
+    BOOST_CHECK( key != TablesCache::key( EclipseState( deck2, ParseContext() ) ) );
+}
+
+BOOST_AUTO_TEST_CASE (Store_And_Load)
+{
+    setup cfg( "table_deck.DATA" );
+    const TablesCache cache( "." );
+
+    Tables tables( cfg.es.getUnits() );
+    tables.addPVTO( cfg.es.getTableManager().getPvtoTables() );
+    tables.addPVTG( cfg.es.getTableManager().getPvtgTables() );
+    tables.addPVTW( cfg.es.getTableManager().getPvtwTable() );
+    tables.addDensity( cfg.es.getTableManager().getDensityTable( ) );
+
+    const auto key = TablesCache::key( cfg.es );
+
+    std::vector<int> tabdims;
+    std::vector<double> tab;
+    BOOST_CHECK( !cache.load( key, tabdims, tab ) );
+
+    BOOST_CHECK( cache.store( key, tables.tabdims(), tables.tab() ) );
+    BOOST_CHECK( cache.load( key, tabdims, tab ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( tabdims.begin(), tabdims.end(),
+                                   tables.tabdims().begin(), tables.tabdims().end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( tab.begin(), tab.end(),
+                                   tables.tab().begin(), tables.tab().end() );
+
+    // Cached vectors are written verbatim.
+    {
+        ERT::FortIO f( "CACHED.INIT", std::fstream::out );
+        fwrite( Tables( cfg.es.getUnits(), tabdims, tab ), f );
+    }
+    {
+        ecl_file_type * f = ecl_file_open( "CACHED.INIT", 0 );
+        const ecl_kw_type * tab_kw = ecl_file_iget_named_kw( f, "TAB", 0 );
+        BOOST_CHECK_EQUAL( ecl_kw_get_size( tab_kw ), static_cast<int>( tab.size() ) );
+        ecl_file_close( f );
+    }
+}
+
+BOOST_AUTO_TEST_CASE (Damaged_Entry_Is_Miss)
+{
+    ERT::TestArea ta( "test_tables_cache" );
+    const TablesCache cache( "." );
+
+    const std::vector<int> tabdims( 100, 1 );
+    const std::vector<double> tab( 1000, 2.5 );
+    BOOST_CHECK( cache.store( "abc", tabdims, tab ) );
+
+    // Truncate entry.
+    {
+        std::ifstream in( cache.filename( "abc" ), std::ios::binary );
+        std::string contents( (std::istreambuf_iterator<char>( in )), std::istreambuf_iterator<char>() );
+        std::ofstream out( cache.filename( "abc" ), std::ios::binary | std::ios::trunc );
+        out.write( contents.data(), contents.size() / 2 );
+    }
+
+    std::vector<int> loaded_tabdims{ 7 };
+    std::vector<double> loaded_tab{ 7.0 };
+    BOOST_CHECK( !cache.load( "abc", loaded_tabdims, loaded_tab ) );
+
+    // Outputs untouched on miss.
+    BOOST_CHECK_EQUAL( loaded_tabdims.size(), 1U );
+    BOOST_CHECK_EQUAL( loaded_tab.size(), 1U );
+}
+
+BOOST_AUTO_TEST_CASE (Concurrent_Writers)
+{
+    ERT::TestArea ta( "test_tables_cache" );
+    const TablesCache cache( "." );
+
+    std::vector<int> tabdims( 100 );
+    std::vector<double> tab( 100000 );
+    for (std::size_t i = 0; i < tab.size(); ++i)
+        tab[i] = 0.5 * i;
+    for (std::size_t i = 0; i < tabdims.size(); ++i)
+        tabdims[i] = i;
+
+    // Boost.Test assertions are not thread safe, so only count failures
+    // on the writer threads.
+    std::atomic<int> failed{ 0 };
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 8; ++w) {
+        writers.emplace_back( [&]() {
+            for (int rep = 0; rep < 10; ++rep) {
+                std::vector<int> t1;
+                std::vector<double> t2;
+
+                if (!cache.store( "shared", tabdims, tab ))
+                    ++failed;
+
+                // Readers only ever see complete entries.
+                if (!cache.load( "shared", t1, t2 ) || (t1 != tabdims) || (t2 != tab))
+                    ++failed;
+            }
+        });
+    }
+    for (auto& writer : writers)
+        writer.join();
+
+    BOOST_CHECK_EQUAL( failed.load(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,130 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#define BOOST_TEST_MODULE ThreadPool
+#include <boost/test/unit_test.hpp>
+
+#include <opm/output/util/ThreadPool.hpp>
+
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using Opm::out::ThreadPool;
+
+BOOST_AUTO_TEST_CASE(SubmitReturnsResults) {
+    for (std::size_t numThreads : { 0, 1, 4 }) {
+        ThreadPool pool(numThreads);
+        BOOST_CHECK_EQUAL(pool.size(), numThreads);
+
+        std::vector<std::future<int>> results;
+        for (int i = 0; i < 100; ++i)
+            results.push_back(pool.submit([i]() { return i * i; }));
+
+        for (int i = 0; i < 100; ++i)
+            BOOST_CHECK_EQUAL(results[i].get(), i * i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SerialPoolRunsOnCaller) {
+    ThreadPool& pool = ThreadPool::serial();
+    BOOST_CHECK_EQUAL(pool.size(), 0U);
+
+    const auto caller = std::this_thread::get_id();
+    BOOST_CHECK(pool.submit([]() { return std::this_thread::get_id(); }).get() == caller);
+}
+
+BOOST_AUTO_TEST_CASE(SubmitPropagatesException) {
+    ThreadPool pool(2);
+    auto result = pool.submit([]() -> int { throw std::logic_error("failed"); });
+    BOOST_CHECK_THROW(result.get(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(DestructorRunsPendingTasks) {
+    std::atomic<int> count{ 0 };
+    {
+        ThreadPool pool(3);
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&count]() { ++count; });
+    }
+    BOOST_CHECK_EQUAL(count.load(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForCoversRange) {
+    for (std::size_t numThreads : { 0, 1, 4 }) {
+        ThreadPool pool(numThreads);
+        std::vector<int> hits(10007, 0);
+        std::atomic<bool> oversized{ false };
+
+        pool.parallelFor(3, hits.size(), 64, [&hits, &oversized](std::size_t first, std::size_t last) {
+            if (last - first > 64)
+                oversized = true;
+            for (auto i = first; i < last; ++i)
+                hits[i] += 1;
+        });
+
+        BOOST_CHECK(!oversized);
+
+        BOOST_CHECK_EQUAL(std::accumulate(hits.begin(), hits.begin() + 3, 0), 0);
+        BOOST_CHECK_EQUAL(std::accumulate(hits.begin() + 3, hits.end(), 0), 10004);
+
+        // Empty range is a no-op
+        bool called = false;
+        pool.parallelFor(5, 5, 1, [&called](std::size_t, std::size_t) { called = true; });
+        BOOST_CHECK(!called);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForNested) {
+    ThreadPool pool(2);
+    std::vector<std::future<long>> results;
+
+    for (int task = 0; task < 8; ++task) {
+        results.push_back(pool.submit([&pool]() {
+            std::vector<long> values(1000);
+            pool.parallelFor(0, values.size(), 10, [&values](std::size_t first, std::size_t last) {
+                for (auto i = first; i < last; ++i)
+                    values[i] = i;
+            });
+            return std::accumulate(values.begin(), values.end(), 0L);
+        }));
+    }
+
+    for (auto& result : results)
+        BOOST_CHECK_EQUAL(result.get(), 999L * 1000 / 2);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForPropagatesException) {
+    ThreadPool pool(3);
+    std::atomic<int> calls{ 0 };
+
+    BOOST_CHECK_THROW(pool.parallelFor(0, 100, 1, [&calls](std::size_t first, std::size_t) {
+        ++calls;
+        if (first == 17)
+            throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+
+    // The remaining chunks are still processed.
+    BOOST_CHECK_EQUAL(calls.load(), 100);
+}
@@ -22,7 +22,9 @@
 #define BOOST_TEST_MODULE RegionCache
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -32,6 +34,7 @@
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 
 #include <opm/output/eclipse/RegionCache.hpp>
+#include <opm/output/eclipse/RegionReduction.hpp>
 
 using namespace Opm;
 
@@ -62,3 +65,94 @@ BOOST_AUTO_TEST_CASE(create) {
         }
     }
 }
+
+
+BOOST_AUTO_TEST_CASE(region_cells) {
+    ParseContext parseContext;
+    Parser parser;
+    Deck deck( parser.parseFile( path, parseContext ));
+    EclipseState es(deck , parseContext );
+    const EclipseGrid& grid = es.getInputGrid();
+    Schedule schedule( deck, grid, es.get3DProperties(), es.runspec().phases(), ParseContext() );
+    out::RegionCache rc(es.get3DProperties() , grid, schedule);
+
+    BOOST_CHECK( rc.hasRegionSet( "FIPNUM" ));
+    BOOST_CHECK( !rc.hasRegionSet( "FIPXXX" ));
+    BOOST_CHECK_THROW( rc.regionCells( "FIPXXX" ), std::invalid_argument );
+
+    // One region per layer; one inactive cell in the bottom layer.
+    const auto& regions = rc.regionCells( );
+    BOOST_CHECK_EQUAL( regions.numRegions() , 10 );
+    BOOST_CHECK_EQUAL( regions.num_active , grid.getNumActive() );
+    BOOST_CHECK_EQUAL( regions.cells.size() , grid.getNumActive() );
+
+    const size_t layer = grid.getNX() * grid.getNY();
+    for (size_t r = 1; r < 10; r++)
+        BOOST_CHECK_EQUAL( regions.start[r] - regions.start[r - 1] , layer );
+    BOOST_CHECK_EQUAL( regions.start[10] - regions.start[9] , layer - 1 );
+
+    BOOST_CHECK_EQUAL( regions.cells[ regions.start[1] ] , grid.activeIndex( 0,0,1 ));
+    BOOST_CHECK( std::is_sorted( regions.cells.begin() , regions.cells.end() ));
+}
+
+
+BOOST_AUTO_TEST_CASE(region_reduction) {
+    ParseContext parseContext;
+    Parser parser;
+    Deck deck( parser.parseFile( path, parseContext ));
+    EclipseState es(deck , parseContext );
+    const EclipseGrid& grid = es.getInputGrid();
+    Schedule schedule( deck, grid, es.get3DProperties(), es.runspec().phases(), ParseContext() );
+    out::RegionCache rc(es.get3DProperties() , grid, schedule);
+
+    const size_t num_active = grid.getNumActive();
+    std::vector<double> pressure( num_active ), porv( num_active ), oip( num_active , 2.0 );
+    for (size_t i = 0; i < num_active; i++) {
+        pressure[i] = 100.0 + i % 7;
+        porv[i] = 1.0 + i % 3;
+    }
+
+    data::Solution cells;
+    cells.insert( "PRESSURE" , UnitSystem::measure::pressure , pressure , data::TargetType::RESTART_SOLUTION );
+    cells.insert( "OIP" , UnitSystem::measure::volume , oip , data::TargetType::RESTART_SOLUTION );
+    cells.insert( "SWAT" , UnitSystem::measure::identity , std::vector<double>( num_active , 0.25 ) , data::TargetType::RESTART_SOLUTION );
+
+    out::ThreadPool serial( 0 );
+    out::ThreadPool parallel( 4 );
+    const out::RegionReduction serial_reduction( rc , "FIPNUM" , serial );
+    const out::RegionReduction parallel_reduction( rc , "FIPNUM" , parallel );
+
+    const auto& regions = rc.regionCells( );
+    const auto sum = serial_reduction.sum( oip );
+    const auto avg = serial_reduction.average( pressure , porv );
+    BOOST_CHECK_EQUAL( sum.size() , 10 );
+    for (size_t r = 0; r < 10; r++) {
+        double s = 0, w = 0;
+        for (size_t i = regions.start[r]; i < regions.start[r + 1]; i++) {
+            s += pressure[ regions.cells[i] ] * porv[ regions.cells[i] ];
+            w += porv[ regions.cells[i] ];
+        }
+        BOOST_CHECK_CLOSE( sum[r] , 2.0 * (regions.start[r + 1] - regions.start[r]) , 1e-12 );
+        BOOST_CHECK_CLOSE( avg[r] , s / w , 1e-12 );
+    }
+
+    // Deterministic: identical results regardless of the number of threads.
+    const auto parallel_avg = parallel_reduction.average( pressure , porv );
+    BOOST_CHECK( avg == parallel_avg );
+
+    // Uniform water saturation: hydrocarbon and pore volume averages agree.
+    const auto values = parallel_reduction.regionValues( cells , porv );
+    BOOST_CHECK_EQUAL( values.size() , 2 );
+    BOOST_CHECK( values.at( "ROIP" ) == sum );
+    for (size_t r = 0; r < 10; r++)
+        BOOST_CHECK_CLOSE( values.at( "RPR" )[r] , avg[r] , 1e-12 );
+
+    BOOST_CHECK_THROW( serial_reduction.sum( std::vector<double>( 3 ) ) , std::invalid_argument );
+    BOOST_CHECK_THROW( serial_reduction.reduce( cells , "NO_SUCH" , out::RegionReduction::Kind::Sum ) , std::out_of_range );
+
+    // Without SWAT the hydrocarbon volume average is refused, and RPR left out.
+    data::Solution dry;
+    dry.insert( "PRESSURE" , UnitSystem::measure::pressure , pressure , data::TargetType::RESTART_SOLUTION );
+    BOOST_CHECK_THROW( serial_reduction.reduce( dry , "PRESSURE" , out::RegionReduction::Kind::HydrocarbonVolumeAverage , porv ) , std::invalid_argument );
+    BOOST_CHECK_EQUAL( serial_reduction.regionValues( dry , porv ).count( "RPR" ) , 0U );
+}